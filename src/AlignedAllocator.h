@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace visionary {
+
+/// Allocator returning memory aligned to \a Alignment bytes (default: cache line size)
+///
+/// C++11 has no aligned operator new, so the allocation is padded and the
+/// original pointer is stored directly in front of the aligned block.
+///
+/// \tparam T value type
+/// \tparam Alignment alignment in bytes, must be a power of two
+template <typename T, std::size_t Alignment = 64u>
+class AlignedAllocator
+{
+  static_assert((Alignment & (Alignment - 1u)) == 0u, "Alignment must be a power of two");
+  static_assert(Alignment >= sizeof(void*), "Alignment must be at least the size of a pointer");
+
+public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind
+  {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    if (n > (std::numeric_limits<std::size_t>::max() - Alignment - sizeof(void*)) / sizeof(T))
+    {
+      throw std::bad_alloc();
+    }
+    void* const          pRaw     = ::operator new(n * sizeof(T) + Alignment - 1u + sizeof(void*));
+    const std::uintptr_t aligned  = (reinterpret_cast<std::uintptr_t>(pRaw) + sizeof(void*) + Alignment - 1u)
+                                   & ~static_cast<std::uintptr_t>(Alignment - 1u);
+    reinterpret_cast<void**>(aligned)[-1] = pRaw;
+    return reinterpret_cast<T*>(aligned);
+  }
+
+  void deallocate(T* p, std::size_t) noexcept
+  {
+    ::operator delete(reinterpret_cast<void**>(p)[-1]);
+  }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept
+{
+  return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept
+{
+  return false;
+}
+
+/// std::vector with data aligned to the cache line size
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+} // namespace visionary
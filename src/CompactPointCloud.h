@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PointXYZ.h"
+
+namespace visionary {
+
+/// Point cloud containing valid points only
+///
+/// Invalid pixels are removed, so the points contain no NaN values and need no further checks.
+/// The image position of each point is kept in \a pixelIndices, and \a validMask tells for each pixel of the
+/// image whether it produced a point.
+struct CompactPointCloud
+{
+  /// The valid points in image order
+  std::vector<PointXYZ> points;
+  /// Image index (row * width + column) of each point
+  std::vector<std::uint32_t> pixelIndices;
+  /// Validity of the pixels: bit (i % 64) of word (i / 64) is set if pixel i is valid
+  std::vector<std::uint64_t> validMask;
+  /// Number of valid points in front of each word of \a validMask
+  std::vector<std::uint32_t> maskOffsets;
+
+  /// Returns the number of valid points
+  std::size_t size() const
+  {
+    return points.size();
+  }
+
+  /// Returns true if the pixel with the image index \a pixelIndex is valid
+  bool isValid(std::size_t pixelIndex) const
+  {
+    return ((validMask[pixelIndex / 64u] >> (pixelIndex % 64u)) & 1u) != 0u;
+  }
+
+  /// Returns the index into \a points of the valid pixel with the image index \a pixelIndex
+  std::size_t getPointIndex(std::size_t pixelIndex) const
+  {
+    const std::uint64_t lowerBits = validMask[pixelIndex / 64u] & ((std::uint64_t(1u) << (pixelIndex % 64u)) - 1u);
+    return maskOffsets[pixelIndex / 64u] + countBits(lowerBits);
+  }
+
+  /// Returns the number of set bits
+  static std::size_t countBits(std::uint64_t bits)
+  {
+    bits = bits - ((bits >> 1u) & 0x5555555555555555ull);
+    bits = (bits & 0x3333333333333333ull) + ((bits >> 2u) & 0x3333333333333333ull);
+    bits = (bits + (bits >> 4u)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<std::size_t>((bits * 0x0101010101010101ull) >> 56u);
+  }
+};
+
+} // namespace visionary
@@ -0,0 +1,404 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "DepthMapCodec.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+#include "VisionaryEndian.h"
+
+namespace visionary {
+
+namespace {
+
+const std::uint32_t kMagic       = 0x31434456u; // "VDC1"
+const std::size_t   kRowsPerBand = 16u;
+const std::size_t   kGroupSize   = 32u;
+const std::size_t   kHeaderSize  = 4u * sizeof(std::uint32_t);
+// zigzag encoded differences of two 16 bit values have at most 17 bits
+const std::uint32_t kMaxBitWidth = 17u;
+// Largest map accepted by decode. A long run of invalid pixels takes only a few bytes, so the size of the encoded
+// data does not limit the size of the map.
+const std::uint64_t kMaxDecodedPixels = std::uint64_t(1u) << 26u;
+
+// Process the bands sequentially or in parallel if an executor is given
+template <class TFunction>
+void forEachBand(IExecutor* pExecutor, std::size_t numBands, const TFunction& function)
+{
+  if (pExecutor == nullptr)
+  {
+    function(0u, numBands);
+  }
+  else
+  {
+    pExecutor->parallelFor(numBands, function);
+  }
+}
+
+std::uint32_t zigzagEncode(std::int32_t value)
+{
+  return (static_cast<std::uint32_t>(value) << 1u) ^ static_cast<std::uint32_t>(value >> 31);
+}
+
+std::int32_t zigzagDecode(std::uint32_t value)
+{
+  return static_cast<std::int32_t>(value >> 1u) ^ -static_cast<std::int32_t>(value & 1u);
+}
+
+void writeVarint(std::vector<std::uint8_t>& out, std::size_t value)
+{
+  while (value >= 0x80u)
+  {
+    out.push_back(static_cast<std::uint8_t>(value | 0x80u));
+    value >>= 7u;
+  }
+  out.push_back(static_cast<std::uint8_t>(value));
+}
+
+bool readVarint(const std::uint8_t*& pIn, const std::uint8_t* pEnd, std::size_t& value)
+{
+  value = 0u;
+  for (std::uint32_t shift = 0u; shift < 32u; shift += 7u)
+  {
+    if (pIn == pEnd)
+    {
+      return false;
+    }
+    const std::uint8_t byte = *pIn++;
+    value |= static_cast<std::size_t>(byte & 0x7Fu) << shift;
+    if ((byte & 0x80u) == 0u)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Append the bit packed group of zigzag encoded differences
+void writeGroup(std::vector<std::uint8_t>& out, const std::uint32_t* pValues, std::size_t numValues)
+{
+  std::uint32_t bits = 0u;
+  for (std::size_t i = 0u; i < numValues; ++i)
+  {
+    bits |= pValues[i];
+  }
+  std::uint32_t bitWidth = 0u;
+  while (bits != 0u)
+  {
+    ++bitWidth;
+    bits >>= 1u;
+  }
+  out.push_back(static_cast<std::uint8_t>(bitWidth));
+
+  const std::size_t numBytes = (numValues * bitWidth + 7u) / 8u;
+  const std::size_t offset   = out.size();
+  out.resize(offset + numBytes);
+  std::uint8_t* pOut = out.data() + offset;
+
+  std::uint64_t accumulator = 0u;
+  std::uint32_t numBits     = 0u;
+  for (std::size_t i = 0u; i < numValues; ++i)
+  {
+    accumulator |= static_cast<std::uint64_t>(pValues[i]) << numBits;
+    numBits += bitWidth;
+    while (numBits >= 8u)
+    {
+      *pOut++ = static_cast<std::uint8_t>(accumulator);
+      accumulator >>= 8u;
+      numBits -= 8u;
+    }
+  }
+  if (numBits > 0u)
+  {
+    *pOut = static_cast<std::uint8_t>(accumulator);
+  }
+}
+
+// Read a bit packed group of zigzag encoded differences
+bool readGroup(const std::uint8_t*& pIn, const std::uint8_t* pEnd, std::uint32_t* pValues, std::size_t numValues)
+{
+  if (pIn == pEnd)
+  {
+    return false;
+  }
+  const std::uint32_t bitWidth = *pIn++;
+  const std::size_t   numBytes = (numValues * bitWidth + 7u) / 8u;
+  if (bitWidth > kMaxBitWidth || static_cast<std::size_t>(pEnd - pIn) < numBytes)
+  {
+    return false;
+  }
+
+  const std::uint32_t mask        = (1u << bitWidth) - 1u;
+  std::uint64_t       accumulator = 0u;
+  std::uint32_t       numBits     = 0u;
+  for (std::size_t i = 0u; i < numValues; ++i)
+  {
+    while (numBits < bitWidth)
+    {
+      accumulator |= static_cast<std::uint64_t>(*pIn++) << numBits;
+      numBits += 8u;
+    }
+    pValues[i] = static_cast<std::uint32_t>(accumulator) & mask;
+    accumulator >>= bitWidth;
+    numBits -= bitWidth;
+  }
+  return true;
+}
+
+// Encode the rows of a band
+void encodeRows(const std::uint16_t* pMap, std::size_t width, std::size_t numRows, std::vector<std::uint8_t>& out)
+{
+  std::uint32_t differences[kGroupSize];
+  for (std::size_t row = 0u; row < numRows; ++row)
+  {
+    const std::uint16_t* pRow     = pMap + row * width;
+    std::int32_t         previous = 0;
+    std::size_t          x        = 0u;
+    while (x < width)
+    {
+      // a run of invalid pixels followed by a run of valid pixels
+      const std::size_t zeroBegin = x;
+      while (x < width && pRow[x] == 0u)
+      {
+        ++x;
+      }
+      const std::size_t valueBegin = x;
+      while (x < width && pRow[x] != 0u)
+      {
+        ++x;
+      }
+      writeVarint(out, valueBegin - zeroBegin);
+      writeVarint(out, x - valueBegin);
+
+      for (std::size_t groupBegin = valueBegin; groupBegin < x; groupBegin += kGroupSize)
+      {
+        const std::size_t numValues = std::min(kGroupSize, x - groupBegin);
+        for (std::size_t i = 0u; i < numValues; ++i)
+        {
+          const std::int32_t value = pRow[groupBegin + i];
+          differences[i]           = zigzagEncode(value - previous);
+          previous                 = value;
+        }
+        writeGroup(out, differences, numValues);
+      }
+    }
+  }
+}
+
+// Decode the rows of a band, returns false if the data is malformed or not used completely
+bool decodeRows(const std::uint8_t* pIn,
+                const std::uint8_t* pEnd,
+                std::size_t         width,
+                std::size_t         numRows,
+                std::uint16_t*      pMap)
+{
+  std::uint32_t differences[kGroupSize];
+  for (std::size_t row = 0u; row < numRows; ++row)
+  {
+    std::uint16_t* pRow     = pMap + row * width;
+    std::int32_t   previous = 0;
+    std::size_t    x        = 0u;
+    while (x < width)
+    {
+      std::size_t numZeros  = 0u;
+      std::size_t numValues = 0u;
+      if (!readVarint(pIn, pEnd, numZeros) || !readVarint(pIn, pEnd, numValues) || numZeros + numValues == 0u
+          || numZeros > width - x || numValues > width - x - numZeros)
+      {
+        return false;
+      }
+      std::fill_n(pRow + x, numZeros, std::uint16_t(0u));
+      x += numZeros;
+
+      const std::size_t valueEnd = x + numValues;
+      for (; x < valueEnd; x += kGroupSize)
+      {
+        const std::size_t groupSize = std::min(kGroupSize, valueEnd - x);
+        if (!readGroup(pIn, pEnd, differences, groupSize))
+        {
+          return false;
+        }
+        for (std::size_t i = 0u; i < groupSize; ++i)
+        {
+          previous += zigzagDecode(differences[i]);
+          pRow[x + i] = static_cast<std::uint16_t>(previous);
+        }
+      }
+      x = valueEnd;
+    }
+  }
+  return pIn == pEnd;
+}
+
+} // namespace
+
+DepthMapCodec::DepthMapCodec() = default;
+
+void DepthMapCodec::encode(const std::vector<std::uint16_t>& map,
+                           int                               width,
+                           int                               height,
+                           std::vector<std::uint8_t>&        encoded)
+{
+  encodeImpl(map, width, height, encoded, nullptr);
+}
+
+void DepthMapCodec::encode(const std::vector<std::uint16_t>& map,
+                           int                               width,
+                           int                               height,
+                           std::vector<std::uint8_t>&        encoded,
+                           IExecutor&                        executor)
+{
+  encodeImpl(map, width, height, encoded, &executor);
+}
+
+bool DepthMapCodec::decode(const std::vector<std::uint8_t>& encoded,
+                           std::vector<std::uint16_t>&      map,
+                           int&                             width,
+                           int&                             height)
+{
+  return decodeImpl(encoded, map, width, height, nullptr);
+}
+
+bool DepthMapCodec::decode(const std::vector<std::uint8_t>& encoded,
+                           std::vector<std::uint16_t>&      map,
+                           int&                             width,
+                           int&                             height,
+                           IExecutor&                       executor)
+{
+  return decodeImpl(encoded, map, width, height, &executor);
+}
+
+void DepthMapCodec::encodeImpl(const std::vector<std::uint16_t>& map,
+                               int                               width,
+                               int                               height,
+                               std::vector<std::uint8_t>&        encoded,
+                               IExecutor*                        pExecutor)
+{
+  assert(width >= 0 && height >= 0 && map.size() == static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+
+  const auto        numColumns = static_cast<std::size_t>(width);
+  const auto        numRows    = static_cast<std::size_t>(height);
+  const std::size_t numBands   = (numRows + kRowsPerBand - 1u) / kRowsPerBand;
+  m_bands.resize(numBands);
+
+  const std::uint16_t* pMap = map.data();
+  forEachBand(pExecutor, numBands, [this, pMap, numColumns, numRows](std::size_t begin, std::size_t end) {
+    for (std::size_t band = begin; band < end; ++band)
+    {
+      const std::size_t rowBegin = band * kRowsPerBand;
+      m_bands[band].clear();
+      encodeRows(pMap + rowBegin * numColumns, numColumns, std::min(kRowsPerBand, numRows - rowBegin), m_bands[band]);
+    }
+  });
+
+  // header, table of the band sizes and the bands
+  std::size_t totalSize = kHeaderSize + numBands * sizeof(std::uint32_t);
+  for (const std::vector<std::uint8_t>& band : m_bands)
+  {
+    totalSize += band.size();
+  }
+  encoded.resize(totalSize);
+  std::uint8_t* pOut = encoded.data();
+  writeUnalignLittleEndian<std::uint32_t>(pOut, 4u, kMagic);
+  writeUnalignLittleEndian<std::uint32_t>(pOut + 4u, 4u, static_cast<std::uint32_t>(width));
+  writeUnalignLittleEndian<std::uint32_t>(pOut + 8u, 4u, static_cast<std::uint32_t>(height));
+  writeUnalignLittleEndian<std::uint32_t>(pOut + 12u, 4u, static_cast<std::uint32_t>(kRowsPerBand));
+  pOut += kHeaderSize;
+  for (const std::vector<std::uint8_t>& band : m_bands)
+  {
+    writeUnalignLittleEndian<std::uint32_t>(pOut, 4u, static_cast<std::uint32_t>(band.size()));
+    pOut += sizeof(std::uint32_t);
+  }
+  for (const std::vector<std::uint8_t>& band : m_bands)
+  {
+    if (!band.empty())
+    {
+      std::copy(band.begin(), band.end(), pOut);
+      pOut += band.size();
+    }
+  }
+}
+
+bool DepthMapCodec::decodeImpl(const std::vector<std::uint8_t>& encoded,
+                               std::vector<std::uint16_t>&      map,
+                               int&                             width,
+                               int&                             height,
+                               IExecutor*                       pExecutor)
+{
+  const std::uint8_t* pIn = encoded.data();
+  if (encoded.size() < kHeaderSize || readUnalignLittleEndian<std::uint32_t>(pIn) != kMagic)
+  {
+    std::cout << "Malformed data, the encoded map has no valid header." << std::endl;
+    return false;
+  }
+  const std::uint32_t numColumns   = readUnalignLittleEndian<std::uint32_t>(pIn + 4u);
+  const std::uint32_t numRows      = readUnalignLittleEndian<std::uint32_t>(pIn + 8u);
+  const std::uint32_t rowsPerBand  = readUnalignLittleEndian<std::uint32_t>(pIn + 12u);
+  // the dimensions are checked in 64 bit before anything is computed in size_t, which may have 32 bits
+  const std::uint64_t numPixels    = std::uint64_t(numColumns) * numRows;
+  const std::uint64_t numBands =
+    (rowsPerBand == 0u) ? 0u : (std::uint64_t(numRows) + rowsPerBand - 1u) / rowsPerBand;
+  const std::uint32_t maxDimension = 0x7FFFFFFFu;
+  if (rowsPerBand == 0u || numColumns > maxDimension || numRows > maxDimension || numPixels > kMaxDecodedPixels
+      || numBands > (encoded.size() - kHeaderSize) / sizeof(std::uint32_t))
+  {
+    std::cout << "Malformed data, the encoded map has no valid header." << std::endl;
+    return false;
+  }
+
+  // every row of a band has at least one pair of run lengths of at least one byte each
+  const std::size_t minRowSize = (numColumns == 0u) ? 0u : 2u;
+  m_bandOffsets.resize(static_cast<std::size_t>(numBands) + 1u);
+  m_bandOffsets[0] = kHeaderSize + static_cast<std::size_t>(numBands) * sizeof(std::uint32_t);
+  for (std::size_t band = 0u; band < m_bandOffsets.size() - 1u; ++band)
+  {
+    const std::uint8_t* pBandSize = pIn + kHeaderSize + band * sizeof(std::uint32_t);
+    const std::size_t   bandSize  = readUnalignLittleEndian<std::uint32_t>(pBandSize);
+    const std::size_t   bandRows  = std::min(std::size_t(rowsPerBand), numRows - band * rowsPerBand);
+    if (bandSize < minRowSize * bandRows || bandSize > encoded.size() - m_bandOffsets[band])
+    {
+      std::cout << "Malformed data, the band sizes of the encoded map don't match its size." << std::endl;
+      return false;
+    }
+    m_bandOffsets[band + 1u] = m_bandOffsets[band] + bandSize;
+  }
+  if (m_bandOffsets.back() != encoded.size())
+  {
+    std::cout << "Malformed data, the band sizes of the encoded map don't match its size." << std::endl;
+    return false;
+  }
+
+  map.resize(static_cast<std::size_t>(numPixels));
+  m_bandDecoded.assign(static_cast<std::size_t>(numBands), 0u);
+
+  std::uint16_t* pMap        = map.data();
+  auto           decodeBands = [this, pIn, pMap, numColumns, numRows, rowsPerBand](std::size_t begin, std::size_t end) {
+    for (std::size_t band = begin; band < end; ++band)
+    {
+      const std::size_t rowBegin = band * rowsPerBand;
+      const std::size_t bandRows = std::min(std::size_t(rowsPerBand), numRows - rowBegin);
+      const bool        decoded  = decodeRows(pIn + m_bandOffsets[band],
+                                      pIn + m_bandOffsets[band + 1u],
+                                      numColumns,
+                                      bandRows,
+                                      pMap + rowBegin * numColumns);
+      m_bandDecoded[band] = decoded ? 1u : 0u;
+    }
+  };
+  forEachBand(pExecutor, m_bandDecoded.size(), decodeBands);
+
+  if (std::find(m_bandDecoded.begin(), m_bandDecoded.end(), 0u) != m_bandDecoded.end())
+  {
+    std::cout << "Malformed data, a band of the encoded map could not be decoded." << std::endl;
+    return false;
+  }
+  width  = static_cast<int>(numColumns);
+  height = static_cast<int>(numRows);
+  return true;
+}
+
+} // namespace visionary
@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "IExecutor.h"
+
+namespace visionary {
+
+/// \brief Lossless compression of 16 bit maps like the distance, z, intensity or confidence maps
+///
+/// Each value is predicted by the previous non zero value of its row and only the difference is stored.
+/// Runs of 0 values (invalid pixels) are run length encoded. The differences are zigzag encoded and bit packed in
+/// groups of 32 values with the bit width of the largest value of the group.
+///
+/// The map is split into bands of rows which are encoded independently, so bands can be encoded and decoded in
+/// parallel. Layout of the encoded data (all numbers little endian):
+///   - magic "VDC1", width, height, number of rows per band (uint32 each)
+///   - size of each encoded band in bytes (uint32 each)
+///   - the encoded bands
+///
+/// The buffers of the bands are kept between the calls. An instance must not be used by several threads at the same
+/// time.
+class DepthMapCodec
+{
+public:
+  DepthMapCodec();
+
+  /// Encode a map
+  ///
+  /// \param[in]  map     the map with width * height values
+  /// \param[in]  width   width of the map in pixels
+  /// \param[in]  height  height of the map in pixels
+  /// \param[out] encoded the encoded map, replaces the content
+  void encode(const std::vector<std::uint16_t>& map, int width, int height, std::vector<std::uint8_t>& encoded);
+  /// \copydoc encode
+  /// \param[in] executor executor encoding bands of rows in parallel
+  void encode(const std::vector<std::uint16_t>& map,
+              int                               width,
+              int                               height,
+              std::vector<std::uint8_t>&        encoded,
+              IExecutor&                        executor);
+
+  /// Decode a map encoded by encode
+  ///
+  /// Maps of more than 2^26 pixels are rejected. On failure width and height are not changed, the map is only
+  /// changed (resized and partly overwritten) if the header and the band table are valid but a band is not.
+  ///
+  /// \param[in]  encoded the encoded map
+  /// \param[out] map     the decoded map, resized to width * height
+  /// \param[out] width   width of the map in pixels
+  /// \param[out] height  height of the map in pixels
+  /// \returns false if the encoded data is malformed
+  bool decode(const std::vector<std::uint8_t>& encoded, std::vector<std::uint16_t>& map, int& width, int& height);
+  /// \copydoc decode
+  /// \param[in] executor executor decoding bands of rows in parallel
+  bool decode(const std::vector<std::uint8_t>& encoded,
+              std::vector<std::uint16_t>&      map,
+              int&                             width,
+              int&                             height,
+              IExecutor&                       executor);
+
+private:
+  void encodeImpl(const std::vector<std::uint16_t>& map,
+                  int                               width,
+                  int                               height,
+                  std::vector<std::uint8_t>&        encoded,
+                  IExecutor*                        pExecutor);
+
+  bool decodeImpl(const std::vector<std::uint8_t>& encoded,
+                  std::vector<std::uint16_t>&      map,
+                  int&                             width,
+                  int&                             height,
+                  IExecutor*                       pExecutor);
+
+  // encoded bands of the last call of encode
+  std::vector<std::vector<std::uint8_t>> m_bands;
+  // offsets of the bands in the encoded data for decode
+  std::vector<std::size_t> m_bandOffsets;
+  // 1 for each band which was decoded successfully
+  std::vector<std::uint8_t> m_bandDecoded;
+};
+
+} // namespace visionary
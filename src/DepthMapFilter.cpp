@@ -0,0 +1,383 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "DepthMapFilter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+
+namespace visionary {
+
+namespace {
+
+// Number of pixels of a row which are processed together by the inner loops
+const std::size_t kChunkSize = 64u;
+
+bool isInvalidValue(std::uint16_t value)
+{
+  return (value == 0u) || (value == 0xFFFFu);
+}
+
+// Process all rows sequentially or the bands of rows in parallel if an executor is given
+template <class TFunction>
+void forEachRowBand(IExecutor* pExecutor, std::size_t height, const TFunction& function)
+{
+  if (pExecutor == nullptr)
+  {
+    function(0u, height);
+  }
+  else
+  {
+    pExecutor->parallelFor(height, function);
+  }
+}
+
+// Store the element wise minimum in a and the maximum in b
+void sortPair(std::uint16_t* a, std::uint16_t* b, std::size_t numPixels)
+{
+  for (std::size_t c = 0u; c < numPixels; ++c)
+  {
+    const std::uint16_t minValue = std::min(a[c], b[c]);
+    const std::uint16_t maxValue = std::max(a[c], b[c]);
+    a[c]                         = minValue;
+    b[c]                         = maxValue;
+  }
+}
+
+template <std::size_t Radius>
+void medianRows(const std::uint16_t* pPadded,
+                std::size_t          paddedWidth,
+                std::uint16_t*       pMap,
+                std::size_t          width,
+                std::size_t          rowBegin,
+                std::size_t          rowEnd)
+{
+  const std::size_t kSize    = 2u * Radius + 1u;
+  const std::size_t kCount   = kSize * kSize;
+  const std::size_t kSetSize = kCount / 2u + 2u;
+
+  std::uint16_t window[kCount][kChunkSize];
+  for (std::size_t row = rowBegin; row < rowEnd; ++row)
+  {
+    for (std::size_t x0 = 0u; x0 < width; x0 += kChunkSize)
+    {
+      const std::size_t numPixels = std::min(kChunkSize, width - x0);
+      for (std::size_t k = 0u; k < kCount; ++k)
+      {
+        const std::uint16_t* pSrc = pPadded + (row + k / kSize) * paddedWidth + x0 + k % kSize;
+        std::copy(pSrc, pSrc + numPixels, window[k]);
+      }
+
+      // Forgetful selection: the minimum and the maximum of more than half of the values plus one can't be the
+      // median, so they are dropped and the next value is added until one value is left.
+      std::size_t lo   = 0u;
+      std::size_t hi   = kSetSize;
+      std::size_t next = kSetSize;
+      for (;;)
+      {
+        for (std::size_t j = lo + 1u; j < hi; ++j)
+        {
+          sortPair(window[lo], window[j], numPixels);
+        }
+        for (std::size_t j = lo + 1u; j + 1u < hi; ++j)
+        {
+          sortPair(window[j], window[hi - 1u], numPixels);
+        }
+        ++lo;
+        --hi;
+        if (next == kCount)
+        {
+          break;
+        }
+        std::copy(window[next], window[next] + numPixels, window[hi]);
+        ++hi;
+        ++next;
+      }
+
+      const std::uint16_t* pCenter = pPadded + (row + Radius) * paddedWidth + x0 + Radius;
+      std::uint16_t*       pDst    = pMap + row * width + x0;
+      for (std::size_t c = 0u; c < numPixels; ++c)
+      {
+        pDst[c] = isInvalidValue(pCenter[c]) ? pCenter[c] : window[lo][c];
+      }
+    }
+  }
+}
+
+void flyingPixelRows(const std::uint16_t* pPadded,
+                     std::size_t          paddedWidth,
+                     std::uint16_t*       pMap,
+                     std::size_t          width,
+                     std::int32_t         absoluteThreshold,
+                     std::uint32_t        relativeThreshold,
+                     std::size_t          rowBegin,
+                     std::size_t          rowEnd)
+{
+  // neighbor offsets of the four directions: horizontal, vertical and both diagonals
+  const auto           stride     = static_cast<std::ptrdiff_t>(paddedWidth);
+  const std::ptrdiff_t offsets[4] = {1, stride, stride + 1, stride - 1};
+
+  for (std::size_t row = rowBegin; row < rowEnd; ++row)
+  {
+    const std::uint16_t* pCenter = pPadded + (row + 1u) * paddedWidth + 1u;
+    std::uint16_t*       pDst    = pMap + row * width;
+    for (std::size_t x = 0u; x < width; ++x)
+    {
+      const std::uint16_t* p      = pCenter + x;
+      const std::int32_t   center = *p;
+      // relativeThreshold is a 16.16 fixed point number
+      const std::int32_t threshold =
+        absoluteThreshold + static_cast<std::int32_t>((static_cast<std::uint32_t>(center) * relativeThreshold) >> 16u);
+
+      bool isFlying = false;
+      for (std::ptrdiff_t offset : offsets)
+      {
+        const std::int32_t before    = p[-offset];
+        const std::int32_t after     = p[offset];
+        const bool         bothValid = !isInvalidValue(p[-offset]) && !isInvalidValue(p[offset]);
+        const bool         rising    = (before + threshold < center) && (center + threshold < after);
+        const bool         falling   = (before > center + threshold) && (center > after + threshold);
+        isFlying                     = isFlying || (bothValid && (rising || falling));
+      }
+      pDst[x] = (isFlying && !isInvalidValue(*p)) ? std::uint16_t(0u) : *p;
+    }
+  }
+}
+
+template <std::size_t Radius>
+void bilateralRows(const std::uint16_t* pPadded,
+                   std::size_t          paddedWidth,
+                   std::uint16_t*       pMap,
+                   std::size_t          width,
+                   const float*         pSpatialWeights,
+                   const float*         pRangeWeights,
+                   std::size_t          rangeGate,
+                   std::size_t          rowBegin,
+                   std::size_t          rowEnd)
+{
+  const std::size_t kSize  = 2u * Radius + 1u;
+  const std::size_t kCount = kSize * kSize;
+
+  float weightSum[kChunkSize];
+  float valueSum[kChunkSize];
+  for (std::size_t row = rowBegin; row < rowEnd; ++row)
+  {
+    for (std::size_t x0 = 0u; x0 < width; x0 += kChunkSize)
+    {
+      const std::size_t    numPixels = std::min(kChunkSize, width - x0);
+      const std::uint16_t* pCenter   = pPadded + (row + Radius) * paddedWidth + x0 + Radius;
+      std::fill(weightSum, weightSum + numPixels, 0.0f);
+      std::fill(valueSum, valueSum + numPixels, 0.0f);
+
+      for (std::size_t k = 0u; k < kCount; ++k)
+      {
+        const std::uint16_t* pSrc          = pPadded + (row + k / kSize) * paddedWidth + x0 + k % kSize;
+        const float          spatialWeight = pSpatialWeights[k];
+        for (std::size_t c = 0u; c < numPixels; ++c)
+        {
+          const auto difference = static_cast<std::size_t>(std::abs(int(pSrc[c]) - int(pCenter[c])));
+          // the range weight behind the gate is 0
+          const float weight = isInvalidValue(pSrc[c])
+                                 ? 0.0f
+                                 : spatialWeight * pRangeWeights[std::min(difference, rangeGate + 1u)];
+          weightSum[c] += weight;
+          valueSum[c] += weight * static_cast<float>(pSrc[c]);
+        }
+      }
+
+      std::uint16_t* pDst = pMap + row * width + x0;
+      for (std::size_t c = 0u; c < numPixels; ++c)
+      {
+        // the center itself has a weight > 0
+        pDst[c] = isInvalidValue(pCenter[c]) ? pCenter[c]
+                                             : static_cast<std::uint16_t>(valueSum[c] / weightSum[c] + 0.5f);
+      }
+    }
+  }
+}
+
+} // namespace
+
+DepthMapFilter::DepthMapFilter() : m_paddedWidth(0u)
+{
+}
+
+void DepthMapFilter::median(std::vector<std::uint16_t>& map, int width, int height, int kernelSize)
+{
+  medianImpl(map, width, height, kernelSize, nullptr);
+}
+
+void DepthMapFilter::median(
+  std::vector<std::uint16_t>& map, int width, int height, int kernelSize, IExecutor& executor)
+{
+  medianImpl(map, width, height, kernelSize, &executor);
+}
+
+void DepthMapFilter::removeFlyingPixels(std::vector<std::uint16_t>&        map,
+                                        int                                width,
+                                        int                                height,
+                                        const FlyingPixelFilterParameters& parameters)
+{
+  removeFlyingPixelsImpl(map, width, height, parameters, nullptr);
+}
+
+void DepthMapFilter::removeFlyingPixels(std::vector<std::uint16_t>&        map,
+                                        int                                width,
+                                        int                                height,
+                                        const FlyingPixelFilterParameters& parameters,
+                                        IExecutor&                         executor)
+{
+  removeFlyingPixelsImpl(map, width, height, parameters, &executor);
+}
+
+void DepthMapFilter::bilateral(std::vector<std::uint16_t>&      map,
+                               int                              width,
+                               int                              height,
+                               const BilateralFilterParameters& parameters)
+{
+  bilateralImpl(map, width, height, parameters, nullptr);
+}
+
+void DepthMapFilter::bilateral(std::vector<std::uint16_t>&      map,
+                               int                              width,
+                               int                              height,
+                               const BilateralFilterParameters& parameters,
+                               IExecutor&                       executor)
+{
+  bilateralImpl(map, width, height, parameters, &executor);
+}
+
+void DepthMapFilter::medianImpl(
+  std::vector<std::uint16_t>& map, int width, int height, int kernelSize, IExecutor* pExecutor)
+{
+  assert(kernelSize == 3 || kernelSize == 5);
+  assert(width >= 0 && height >= 0 && map.size() == static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+
+  const auto numColumns = static_cast<std::size_t>(width);
+  const auto numRows    = static_cast<std::size_t>(height);
+  const auto radius     = static_cast<std::size_t>(kernelSize / 2);
+  copyPadded(map, numColumns, numRows, radius);
+
+  const std::uint16_t* pPadded     = m_padded.data();
+  const std::size_t    paddedWidth = m_paddedWidth;
+  std::uint16_t*       pMap        = map.data();
+  forEachRowBand(pExecutor, numRows, [=](std::size_t begin, std::size_t end) {
+    if (radius == 1u)
+    {
+      medianRows<1u>(pPadded, paddedWidth, pMap, numColumns, begin, end);
+    }
+    else
+    {
+      medianRows<2u>(pPadded, paddedWidth, pMap, numColumns, begin, end);
+    }
+  });
+}
+
+void DepthMapFilter::removeFlyingPixelsImpl(std::vector<std::uint16_t>&        map,
+                                            int                                width,
+                                            int                                height,
+                                            const FlyingPixelFilterParameters& parameters,
+                                            IExecutor*                         pExecutor)
+{
+  assert(width >= 0 && height >= 0 && map.size() == static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+
+  const auto numColumns = static_cast<std::size_t>(width);
+  const auto numRows    = static_cast<std::size_t>(height);
+  copyPadded(map, numColumns, numRows, 1u);
+
+  const auto absoluteThreshold = static_cast<std::int32_t>(parameters.absoluteThreshold);
+  const auto relativeThreshold =
+    static_cast<std::uint32_t>(std::min(std::max(parameters.relativeThreshold, 0.0f), 1.0f) * 65536.0f + 0.5f);
+
+  const std::uint16_t* pPadded     = m_padded.data();
+  const std::size_t    paddedWidth = m_paddedWidth;
+  std::uint16_t*       pMap        = map.data();
+  forEachRowBand(pExecutor, numRows, [=](std::size_t begin, std::size_t end) {
+    flyingPixelRows(pPadded, paddedWidth, pMap, numColumns, absoluteThreshold, relativeThreshold, begin, end);
+  });
+}
+
+void DepthMapFilter::bilateralImpl(std::vector<std::uint16_t>&      map,
+                                   int                              width,
+                                   int                              height,
+                                   const BilateralFilterParameters& parameters,
+                                   IExecutor*                       pExecutor)
+{
+  assert(parameters.kernelSize == 3 || parameters.kernelSize == 5);
+  assert(parameters.sigmaSpatial > 0.0f && parameters.sigmaRange > 0.0f);
+  assert(width >= 0 && height >= 0 && map.size() == static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+
+  const auto numColumns = static_cast<std::size_t>(width);
+  const auto numRows    = static_cast<std::size_t>(height);
+  const auto radius     = static_cast<std::size_t>(parameters.kernelSize / 2);
+  const auto kernelSize = static_cast<std::size_t>(parameters.kernelSize);
+  copyPadded(map, numColumns, numRows, radius);
+
+  // gaussian weights of the kernel positions in row order
+  m_spatialWeights.resize(kernelSize * kernelSize);
+  for (std::size_t k = 0u; k < m_spatialWeights.size(); ++k)
+  {
+    const float dx      = static_cast<float>(k % kernelSize) - static_cast<float>(radius);
+    const float dy      = static_cast<float>(k / kernelSize) - static_cast<float>(radius);
+    m_spatialWeights[k] = std::exp(-(dx * dx + dy * dy) / (2.0f * parameters.sigmaSpatial * parameters.sigmaSpatial));
+  }
+
+  // gaussian weights of the differences up to the gate and 0 for all differences behind the gate
+  const std::size_t rangeGate = parameters.rangeGate;
+  m_rangeWeights.resize(rangeGate + 2u);
+  for (std::size_t difference = 0u; difference <= rangeGate; ++difference)
+  {
+    const auto d               = static_cast<float>(difference);
+    m_rangeWeights[difference] = std::exp(-(d * d) / (2.0f * parameters.sigmaRange * parameters.sigmaRange));
+  }
+  m_rangeWeights[rangeGate + 1u] = 0.0f;
+
+  const std::uint16_t* pPadded         = m_padded.data();
+  const std::size_t    paddedWidth     = m_paddedWidth;
+  std::uint16_t*       pMap            = map.data();
+  const float*         pSpatialWeights = m_spatialWeights.data();
+  const float*         pRangeWeights   = m_rangeWeights.data();
+  forEachRowBand(pExecutor, numRows, [=](std::size_t begin, std::size_t end) {
+    if (radius == 1u)
+    {
+      bilateralRows<1u>(
+        pPadded, paddedWidth, pMap, numColumns, pSpatialWeights, pRangeWeights, rangeGate, begin, end);
+    }
+    else
+    {
+      bilateralRows<2u>(
+        pPadded, paddedWidth, pMap, numColumns, pSpatialWeights, pRangeWeights, rangeGate, begin, end);
+    }
+  });
+}
+
+void DepthMapFilter::copyPadded(const std::vector<std::uint16_t>& map,
+                                std::size_t                       width,
+                                std::size_t                       height,
+                                std::size_t                       radius)
+{
+  m_paddedWidth = width + 2u * radius;
+  m_padded.resize(m_paddedWidth * (height + 2u * radius));
+  if (width == 0u || height == 0u)
+  {
+    return;
+  }
+
+  for (std::size_t paddedRow = 0u; paddedRow < height + 2u * radius; ++paddedRow)
+  {
+    // replicate the first and the last row
+    const std::size_t    row  = std::min(std::max(paddedRow, radius) - radius, height - 1u);
+    const std::uint16_t* pSrc = map.data() + row * width;
+    std::uint16_t*       pDst = m_padded.data() + paddedRow * m_paddedWidth;
+
+    std::fill(pDst, pDst + radius, pSrc[0]);
+    std::copy(pSrc, pSrc + width, pDst + radius);
+    std::fill(pDst + radius + width, pDst + m_paddedWidth, pSrc[width - 1u]);
+  }
+}
+
+} // namespace visionary
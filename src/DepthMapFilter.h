@@ -0,0 +1,138 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "IExecutor.h"
+
+namespace visionary {
+
+/// Parameters of DepthMapFilter::removeFlyingPixels
+struct FlyingPixelFilterParameters
+{
+  /// Depth jump in map values which is always a discontinuity
+  std::uint16_t absoluteThreshold;
+  /// Additional depth jump relative to the pixel value, in [0, 1]
+  float relativeThreshold;
+};
+
+/// Parameters of DepthMapFilter::bilateral
+struct BilateralFilterParameters
+{
+  /// Size of the quadratic filter kernel, 3 or 5
+  int kernelSize;
+  /// Standard deviation of the spatial weights in pixels
+  float sigmaSpatial;
+  /// Standard deviation of the range weights in map values
+  float sigmaRange;
+  /// Neighbors which differ from the center by more than this number of map values are ignored
+  std::uint16_t rangeGate;
+};
+
+/// \brief Edge preserving filters for uint16 depth maps
+///
+/// The filters work in place on maps as returned by the data handlers, e.g. on the map returned by
+/// VisionaryData::getPointCloudSourceMap() before the point cloud is generated. Map values 0 and 0xFFFF are invalid
+/// pixels: they are never changed by a filter and do not contribute to the filtered values of their neighbors
+/// (except for the median, see there).
+///
+/// The map is copied once into a border replicated scratch image, which is kept between the calls, so
+/// filtering maps of the same size does not allocate memory. The inner loops work on chunks of a row without
+/// branches, which allows the compiler to vectorize them. The variants with an executor process bands of rows in
+/// parallel. An instance must not be used by several threads at the same time.
+class DepthMapFilter
+{
+public:
+  DepthMapFilter();
+
+  /// Replace each valid pixel by the median of its neighborhood
+  ///
+  /// Invalid neighbors are part of the neighborhood, so a pixel surrounded mostly by invalid pixels becomes invalid.
+  /// This removes isolated measurements as well.
+  ///
+  /// \param[in,out] map        the depth map, row by row
+  /// \param[in]     width      width of the map in pixels
+  /// \param[in]     height     height of the map in pixels
+  /// \param[in]     kernelSize size of the quadratic neighborhood, 3 or 5
+  void median(std::vector<std::uint16_t>& map, int width, int height, int kernelSize);
+  /// \copydoc median
+  /// \param[in] executor executor processing the bands of rows
+  void median(std::vector<std::uint16_t>& map, int width, int height, int kernelSize, IExecutor& executor);
+
+  /// Invalidate pixels measured across a depth discontinuity (flying pixels)
+  ///
+  /// A pixel is a flying pixel if, along one of the four directions through its 3x3 neighborhood, the neighbor on
+  /// one side is closer and the neighbor on the other side is farther by more than
+  /// absoluteThreshold + relativeThreshold * value. Pixels on a real edge only jump to one side and are kept.
+  /// Flying pixels are set to 0.
+  ///
+  /// \param[in,out] map        the depth map, row by row
+  /// \param[in]     width      width of the map in pixels
+  /// \param[in]     height     height of the map in pixels
+  /// \param[in]     parameters thresholds of the discontinuity
+  void removeFlyingPixels(std::vector<std::uint16_t>&        map,
+                          int                                width,
+                          int                                height,
+                          const FlyingPixelFilterParameters& parameters);
+  /// \copydoc removeFlyingPixels
+  /// \param[in] executor executor processing the bands of rows
+  void removeFlyingPixels(std::vector<std::uint16_t>&        map,
+                          int                                width,
+                          int                                height,
+                          const FlyingPixelFilterParameters& parameters,
+                          IExecutor&                         executor);
+
+  /// Smooth the valid pixels with a range gated bilateral filter
+  ///
+  /// Each valid pixel becomes the average of its valid neighbors weighted with a gaussian of the distance in the
+  /// image and a gaussian of the difference of the values. Neighbors beyond the range gate are ignored, so
+  /// foreground and background are not mixed at edges.
+  ///
+  /// \param[in,out] map        the depth map, row by row
+  /// \param[in]     width      width of the map in pixels
+  /// \param[in]     height     height of the map in pixels
+  /// \param[in]     parameters kernel size, standard deviations and range gate
+  void bilateral(std::vector<std::uint16_t>&      map,
+                 int                              width,
+                 int                              height,
+                 const BilateralFilterParameters& parameters);
+  /// \copydoc bilateral
+  /// \param[in] executor executor processing the bands of rows
+  void bilateral(std::vector<std::uint16_t>&      map,
+                 int                              width,
+                 int                              height,
+                 const BilateralFilterParameters& parameters,
+                 IExecutor&                       executor);
+
+private:
+  void medianImpl(std::vector<std::uint16_t>& map, int width, int height, int kernelSize, IExecutor* pExecutor);
+  void removeFlyingPixelsImpl(std::vector<std::uint16_t>&        map,
+                              int                                width,
+                              int                                height,
+                              const FlyingPixelFilterParameters& parameters,
+                              IExecutor*                         pExecutor);
+  void bilateralImpl(std::vector<std::uint16_t>&      map,
+                     int                              width,
+                     int                              height,
+                     const BilateralFilterParameters& parameters,
+                     IExecutor*                       pExecutor);
+
+  // Copy the map into m_padded with a replicated border of radius pixels
+  void copyPadded(const std::vector<std::uint16_t>& map, std::size_t width, std::size_t height, std::size_t radius);
+
+  // border replicated copy of the map being filtered
+  std::vector<std::uint16_t> m_padded;
+  std::size_t                m_paddedWidth;
+
+  // weights of the bilateral filter
+  std::vector<float> m_spatialWeights;
+  std::vector<float> m_rangeWeights;
+};
+
+} // namespace visionary
@@ -0,0 +1,32 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "FileStream.h"
+
+#include <locale>
+
+namespace visionary {
+
+bool openFileStream(std::ofstream& stream, std::vector<char>& streamBuffer, const char* filename, bool useBinary)
+{
+  streamBuffer.resize(kFileStreamBufferSize);
+  const auto bufferSize = static_cast<std::streamsize>(streamBuffer.size());
+
+  // libstdc++ only takes the buffer before the file is opened, the Microsoft library only after it has been opened
+  const bool isBufferSet = stream.rdbuf()->pubsetbuf(streamBuffer.data(), bufferSize) != nullptr;
+  stream.open(filename, useBinary ? (std::ios_base::out | std::ios_base::binary) : std::ios_base::out);
+  if (!stream.is_open())
+  {
+    return false;
+  }
+  if (!isBufferSet)
+  {
+    stream.rdbuf()->pubsetbuf(streamBuffer.data(), bufferSize);
+  }
+  stream.imbue(std::locale::classic());
+  return true;
+}
+
+} // namespace visionary
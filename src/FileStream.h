@@ -0,0 +1,29 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <vector>
+
+namespace visionary {
+
+/// Size of the buffer of the file streams of the point cloud writers, the points are written through it without
+/// staging the whole file
+const std::size_t kFileStreamBufferSize = 1u << 20u;
+
+/// Open a file for writing with a large stream buffer and the classic locale
+///
+/// The numbers of the file headers must not depend on the global locale, e.g. on digit grouping.
+///
+/// \param[out] stream       the stream to open
+/// \param[out] streamBuffer buffer of the stream, must live as long as the stream
+/// \param[in]  filename     the file to write
+/// \param[in]  useBinary    open the file in binary instead of text mode
+/// \returns false if the file can't be opened for writing
+bool openFileStream(std::ofstream& stream, std::vector<char>& streamBuffer, const char* filename, bool useBinary);
+
+} // namespace visionary
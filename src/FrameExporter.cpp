@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "FrameExporter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+namespace visionary {
+
+FrameExporter::FrameExporter(std::size_t          queueCapacity,
+                             std::size_t          numThreads,
+                             ExportOverflowPolicy policy,
+                             CompletionCallback   callback)
+  : m_capacity(std::max<std::size_t>(1u, queueCapacity))
+  , m_policy(policy)
+  , m_callback(std::move(callback))
+  , m_isRunning(true)
+  , m_numBusy(0u)
+{
+  const std::size_t numWorkers = std::max<std::size_t>(1u, numThreads);
+  m_workers.reserve(numWorkers);
+  for (std::size_t i = 0u; i < numWorkers; ++i)
+  {
+    m_workers.emplace_back(&FrameExporter::run, this);
+  }
+}
+
+FrameExporter::~FrameExporter()
+{
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_isRunning = false;
+  }
+  m_notEmptyCv.notify_all();
+  for (auto& worker : m_workers)
+  {
+    worker.join();
+  }
+}
+
+void FrameExporter::acquireFrame(ExportFrame& frame)
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+  if (m_freeFrames.empty())
+  {
+    frame = ExportFrame();
+    return;
+  }
+  frame = std::move(m_freeFrames.back());
+  m_freeFrames.pop_back();
+}
+
+bool FrameExporter::push(ExportFrame&& frame)
+{
+  {
+    std::unique_lock<std::mutex> guard(m_mutex);
+    if (m_queue.size() >= m_capacity)
+    {
+      if (m_policy == EXPORT_DROP_NEWEST)
+      {
+        ++m_statistics.numDropped;
+        return false;
+      }
+      if (m_policy == EXPORT_DROP_OLDEST)
+      {
+        ++m_statistics.numDropped;
+        recycleFrame(m_queue.front());
+        m_queue.pop_front();
+      }
+      else
+      {
+        m_notFullCv.wait(guard, [this] { return m_queue.size() < m_capacity; });
+      }
+    }
+    m_queue.push_back(std::move(frame));
+    ++m_statistics.numQueued;
+    m_statistics.maxQueueSize = std::max(m_statistics.maxQueueSize, m_queue.size());
+  }
+  m_notEmptyCv.notify_one();
+  return true;
+}
+
+void FrameExporter::waitUntilIdle()
+{
+  std::unique_lock<std::mutex> guard(m_mutex);
+  m_idleCv.wait(guard, [this] { return m_queue.empty() && m_numBusy == 0u; });
+}
+
+ExportStatistics FrameExporter::getStatistics() const
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_statistics;
+}
+
+bool FrameExporter::writeFrame(const ExportFrame& frame)
+{
+  switch (frame.format)
+  {
+    case EXPORT_PLY_ASCII:
+    case EXPORT_PLY_BINARY:
+      return PointCloudPlyWriter::WriteFormatPLY(frame.filename.c_str(),
+                                                 frame.points,
+                                                 frame.rgbaMap,
+                                                 frame.intensityMap,
+                                                 frame.format == EXPORT_PLY_BINARY,
+                                                 frame.presentation);
+    case EXPORT_PCD_BINARY:
+    case EXPORT_PCD_COMPRESSED:
+    {
+      const PcdEncoding encoding = (frame.format == EXPORT_PCD_COMPRESSED) ? PCD_BINARY_COMPRESSED : PCD_BINARY;
+      if (!frame.rgbaMap.empty())
+      {
+        return PointCloudPcdWriter::WriteFormatPCD(
+          frame.filename.c_str(), frame.points, frame.rgbaMap, encoding, frame.organizedWidth);
+      }
+      if (!frame.intensityMap.empty())
+      {
+        return PointCloudPcdWriter::WriteFormatPCD(
+          frame.filename.c_str(), frame.points, frame.intensityMap, encoding, frame.organizedWidth);
+      }
+      return PointCloudPcdWriter::WriteFormatPCD(frame.filename.c_str(), frame.points, encoding, frame.organizedWidth);
+    }
+    case EXPORT_RAW:
+    {
+      std::ofstream stream(frame.filename.c_str(), std::ios_base::out | std::ios_base::binary);
+      if (!stream.is_open())
+      {
+        return false;
+      }
+      stream.write(reinterpret_cast<const char*>(frame.rawData.data()),
+                   static_cast<std::streamsize>(frame.rawData.size()));
+      stream.close();
+      return !stream.fail();
+    }
+  }
+  return false;
+}
+
+void FrameExporter::recycleFrame(ExportFrame& frame)
+{
+  // keep as many frames as can be in flight at the same time
+  if (m_freeFrames.size() >= m_capacity + m_workers.size())
+  {
+    return;
+  }
+  frame.filename.clear();
+  frame.format = EXPORT_PLY_BINARY;
+  frame.points.clear();
+  frame.rgbaMap.clear();
+  frame.intensityMap.clear();
+  frame.presentation   = INVALID_AS_NAN;
+  frame.organizedWidth = 0;
+  frame.rawData.clear();
+  m_freeFrames.push_back(std::move(frame));
+}
+
+void FrameExporter::run()
+{
+  ExportFrame frame;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> guard(m_mutex);
+      m_notEmptyCv.wait(guard, [this] { return !m_isRunning || !m_queue.empty(); });
+      if (m_queue.empty())
+      {
+        // stopped and all frames are written
+        return;
+      }
+      frame = std::move(m_queue.front());
+      m_queue.pop_front();
+      ++m_numBusy;
+    }
+    m_notFullCv.notify_one();
+
+    // an exception must not end the worker thread, the frame counts as failed then
+    bool success = false;
+    try
+    {
+      success = writeFrame(frame);
+    }
+    catch (...)
+    {
+      success = false;
+    }
+    if (m_callback)
+    {
+      try
+      {
+        m_callback(frame, success);
+      }
+      catch (...)
+      {
+        success = false;
+      }
+    }
+
+    bool isIdle = false;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      ++(success ? m_statistics.numWritten : m_statistics.numFailed);
+      recycleFrame(frame);
+      --m_numBusy;
+      isIdle = m_queue.empty() && m_numBusy == 0u;
+    }
+    if (isIdle)
+    {
+      m_idleCv.notify_all();
+    }
+  }
+}
+
+} // namespace visionary
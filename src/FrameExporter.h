@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PointCloudPcdWriter.h"
+#include "PointCloudPlyWriter.h"
+#include "PointXYZ.h"
+
+namespace visionary {
+
+enum ExportFormat
+{
+  /// PLY file with ASCII data
+  EXPORT_PLY_ASCII = 0,
+
+  /// PLY file with binary little endian data
+  EXPORT_PLY_BINARY = 1,
+
+  /// The raw data bytes of the frame as they are, e.g. a map or an encoded map
+  EXPORT_RAW = 2,
+
+  /// PCD file with binary data
+  EXPORT_PCD_BINARY = 3,
+
+  /// PCD file with LZF compressed binary data
+  EXPORT_PCD_COMPRESSED = 4
+};
+
+enum ExportOverflowPolicy
+{
+  /// push blocks until there is space in the queue (back-pressure)
+  EXPORT_BLOCK = 0,
+
+  /// push drops the new frame if the queue is full
+  EXPORT_DROP_NEWEST = 1,
+
+  /// push drops the oldest queued frame if the queue is full
+  EXPORT_DROP_OLDEST = 2
+};
+
+/// Snapshot of a frame owned by the export queue
+struct ExportFrame
+{
+  /// File the frame is written to
+  std::string  filename;
+  ExportFormat format = EXPORT_PLY_BINARY;
+
+  /// Point cloud of the PLY and PCD formats with optional colors and intensities of the same length as the points.
+  /// PCD files have either colors or intensities, colors are preferred.
+  std::vector<PointXYZ>    points;
+  std::vector<uint32_t>    rgbaMap;
+  std::vector<uint16_t>    intensityMap;
+  InvalidPointPresentation presentation = INVALID_AS_NAN;
+
+  /// Width of organized PCD clouds, 0 for unorganized clouds without invalid points
+  int organizedWidth = 0;
+
+  /// Data of EXPORT_RAW
+  std::vector<uint8_t> rawData;
+};
+
+/// Counters of the export queue since its creation
+struct ExportStatistics
+{
+  /// Frames accepted by push
+  std::uint64_t numQueued = 0u;
+  /// Frames written successfully
+  std::uint64_t numWritten = 0u;
+  /// Frames which could not be written
+  std::uint64_t numFailed = 0u;
+  /// Frames dropped because the queue was full
+  std::uint64_t numDropped = 0u;
+  /// Largest number of frames waiting in the queue
+  std::size_t maxQueueSize = 0u;
+};
+
+/// \brief Bounded queue of frames which are written to files by background threads
+///
+/// Saving frames from the acquisition loop blocks the loop for the time of the encoding and the file access. Frames
+/// pushed to the exporter are written by its worker threads instead, so the acquisition loop only pays for filling
+/// the frame. The buffers of written frames are recycled by acquireFrame, so a steady stream of frames of the same
+/// size does not allocate memory.
+///
+/// If the queue is full, push blocks or drops a frame depending on the overflow policy.
+/// The destructor writes all frames which are still queued.
+class FrameExporter
+{
+public:
+  /// Called by a worker thread after a frame was written, must be thread safe if there are several workers.
+  /// An exception thrown by the callback is caught and the frame counts as failed.
+  using CompletionCallback = std::function<void(const ExportFrame& frame, bool success)>;
+
+  /// Create the exporter and start the worker threads
+  ///
+  /// \param[in] queueCapacity maximum number of frames waiting to be written, at least 1
+  /// \param[in] numThreads    number of worker threads, at least 1
+  /// \param[in] policy        behavior of push if the queue is full
+  /// \param[in] callback      called for each written or failed frame, not for dropped frames [optional]
+  FrameExporter(std::size_t          queueCapacity,
+                std::size_t          numThreads,
+                ExportOverflowPolicy policy,
+                CompletionCallback   callback = CompletionCallback());
+  ~FrameExporter();
+
+  FrameExporter(const FrameExporter&)            = delete;
+  FrameExporter& operator=(const FrameExporter&) = delete;
+
+  /// Provide a frame to be filled, reusing the buffers of an already written frame if available.
+  /// The vectors of the frame are empty but keep their capacity.
+  ///
+  /// \param[out] frame the frame to be filled
+  void acquireFrame(ExportFrame& frame);
+
+  /// Queue a frame for writing
+  ///
+  /// \param[in] frame the frame, moved into the queue unless it is dropped
+  /// \returns false if the frame was dropped because the queue was full (EXPORT_DROP_NEWEST)
+  bool push(ExportFrame&& frame);
+
+  /// Block until all queued frames are written
+  void waitUntilIdle();
+
+  ExportStatistics getStatistics() const;
+
+  /// Write a frame synchronously in the calling thread
+  ///
+  /// \param[in] frame the frame to be written
+  /// \returns true if the file was written successfully
+  static bool writeFrame(const ExportFrame& frame);
+
+private:
+  void run();
+  // keep the buffers of a frame which is not needed anymore for acquireFrame, the mutex must be locked
+  void recycleFrame(ExportFrame& frame);
+
+  const std::size_t          m_capacity;
+  const ExportOverflowPolicy m_policy;
+  const CompletionCallback   m_callback;
+
+  mutable std::mutex       m_mutex;
+  std::condition_variable  m_notEmptyCv;
+  std::condition_variable  m_notFullCv;
+  std::condition_variable  m_idleCv;
+  std::deque<ExportFrame>  m_queue;
+  std::vector<ExportFrame> m_freeFrames;
+  bool                     m_isRunning;
+  std::size_t              m_numBusy;
+  ExportStatistics         m_statistics;
+
+  std::vector<std::thread> m_workers;
+};
+
+} // namespace visionary
@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "HeightMapProjection.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace visionary {
+
+namespace {
+
+// Number of world points calculated at once, small enough to stay in the L1 cache
+const std::size_t kChunkSize = 256u;
+
+const float empty_cell = std::numeric_limits<float>::quiet_NaN();
+
+} // namespace
+
+HeightMapProjection::HeightMapProjection(const HeightMapParameters& parameters) : m_parameters(parameters)
+{
+  assert(m_parameters.cellSize > 0.0f);
+  assert(m_parameters.numCellsX > 0 && m_parameters.numCellsY > 0);
+}
+
+void HeightMapProjection::project(VisionaryData& data, HeightMap& heightMap)
+{
+  // a frame without usable points gives an empty height map
+  VisionaryData::PixelValidator validator{};
+  const std::size_t             numPoints = data.prepareWorldPoints(validator) ? data.getPointCloudSize() : 0u;
+
+  resetGrid(heightMap);
+  projectRange(data, validator, 0u, numPoints, heightMap);
+  mergeRange(heightMap, 0u, 0u, heightMap.count.size());
+}
+
+void HeightMapProjection::project(VisionaryData& data, HeightMap& heightMap, IExecutor& executor)
+{
+  VisionaryData::PixelValidator validator{};
+  const std::size_t             numPoints = data.prepareWorldPoints(validator) ? data.getPointCloudSize() : 0u;
+
+  // one band of rows per concurrent range, each with its own grid
+  const auto        width     = std::max(static_cast<std::size_t>(data.getWidth()), std::size_t(1u));
+  const std::size_t numRows   = (numPoints + width - 1u) / width;
+  const std::size_t numBands  = std::max(std::min(executor.getConcurrency(), numRows), std::size_t(1u));
+  const std::size_t bandRows  = (numRows + numBands - 1u) / numBands;
+  m_grids.resize(numBands);
+
+  const VisionaryData& constData = data;
+  executor.parallelFor(
+    numBands, [this, &constData, &validator, numPoints, width, bandRows](std::size_t begin, std::size_t end) {
+      for (std::size_t band = begin; band < end; ++band)
+      {
+        HeightMap& grid = m_grids[band];
+        resetGrid(grid);
+        const std::size_t pointBegin = std::min(band * bandRows * width, numPoints);
+        const std::size_t pointEnd   = std::min((band + 1u) * bandRows * width, numPoints);
+        projectRange(constData, validator, pointBegin, pointEnd, grid);
+      }
+    });
+
+  heightMap.numCellsX = m_parameters.numCellsX;
+  heightMap.numCellsY = m_parameters.numCellsY;
+  const std::size_t numCells =
+    static_cast<std::size_t>(m_parameters.numCellsX) * static_cast<std::size_t>(m_parameters.numCellsY);
+  heightMap.minHeight.resize(numCells);
+  heightMap.maxHeight.resize(numCells);
+  heightMap.count.resize(numCells);
+  executor.parallelFor(numCells, [this, &heightMap, numBands](std::size_t begin, std::size_t end) {
+    mergeRange(heightMap, numBands, begin, end);
+  });
+}
+
+void HeightMapProjection::getOccupancyGrid(const HeightMap&           heightMap,
+                                           std::uint32_t              minPoints,
+                                           std::vector<std::uint8_t>& occupancy)
+{
+  assert(minPoints >= 1u);
+
+  occupancy.resize(heightMap.count.size());
+  for (std::size_t i = 0u; i < heightMap.count.size(); ++i)
+  {
+    occupancy[i] = (heightMap.count[i] >= minPoints) ? std::uint8_t(1u) : std::uint8_t(0u);
+  }
+}
+
+void HeightMapProjection::resetGrid(HeightMap& grid) const
+{
+  const std::size_t numCells =
+    static_cast<std::size_t>(m_parameters.numCellsX) * static_cast<std::size_t>(m_parameters.numCellsY);
+  grid.numCellsX = m_parameters.numCellsX;
+  grid.numCellsY = m_parameters.numCellsY;
+  grid.minHeight.assign(numCells, std::numeric_limits<float>::infinity());
+  grid.maxHeight.assign(numCells, -std::numeric_limits<float>::infinity());
+  grid.count.assign(numCells, 0u);
+}
+
+void HeightMapProjection::projectRange(const VisionaryData&                 data,
+                                       const VisionaryData::PixelValidator& validator,
+                                       std::size_t                          begin,
+                                       std::size_t                          end,
+                                       HeightMap&                           grid) const
+{
+  const float invCellSize = 1.0f / m_parameters.cellSize;
+  const auto  numCellsX   = static_cast<float>(m_parameters.numCellsX);
+  const auto  numCellsY   = static_cast<float>(m_parameters.numCellsY);
+  const auto  stride      = static_cast<std::size_t>(m_parameters.numCellsX);
+
+  PointXYZ chunk[kChunkSize];
+  for (std::size_t chunkBegin = begin; chunkBegin < end; chunkBegin += kChunkSize)
+  {
+    const std::size_t chunkEnd = std::min(chunkBegin + kChunkSize, end);
+    data.generateWorldPoints(validator, chunkBegin, chunkEnd, chunk);
+
+    for (std::size_t i = 0u; i < chunkEnd - chunkBegin; ++i)
+    {
+      const PointXYZ& point = chunk[i];
+      const float     cellX = (point.x - m_parameters.originX) * invCellSize;
+      const float     cellY = (point.y - m_parameters.originY) * invCellSize;
+      // the comparisons are false for invalid (NaN) points
+      if (!(cellX >= 0.0f && cellX < numCellsX && cellY >= 0.0f && cellY < numCellsY
+            && point.z >= m_parameters.minHeight && point.z <= m_parameters.maxHeight))
+      {
+        continue;
+      }
+      const std::size_t cell = static_cast<std::size_t>(cellY) * stride + static_cast<std::size_t>(cellX);
+      grid.minHeight[cell]   = std::min(grid.minHeight[cell], point.z);
+      grid.maxHeight[cell]   = std::max(grid.maxHeight[cell], point.z);
+      ++grid.count[cell];
+    }
+  }
+}
+
+void HeightMapProjection::mergeRange(HeightMap&  heightMap,
+                                     std::size_t numGrids,
+                                     std::size_t begin,
+                                     std::size_t end) const
+{
+  for (std::size_t cell = begin; cell < end; ++cell)
+  {
+    // without grids of bands the height map has been projected directly
+    float         minHeight = heightMap.minHeight[cell];
+    float         maxHeight = heightMap.maxHeight[cell];
+    std::uint32_t count     = heightMap.count[cell];
+    if (numGrids > 0u)
+    {
+      minHeight = std::numeric_limits<float>::infinity();
+      maxHeight = -std::numeric_limits<float>::infinity();
+      count     = 0u;
+      for (std::size_t grid = 0u; grid < numGrids; ++grid)
+      {
+        minHeight = std::min(minHeight, m_grids[grid].minHeight[cell]);
+        maxHeight = std::max(maxHeight, m_grids[grid].maxHeight[cell]);
+        count += m_grids[grid].count[cell];
+      }
+    }
+    heightMap.minHeight[cell] = (count > 0u) ? minHeight : empty_cell;
+    heightMap.maxHeight[cell] = (count > 0u) ? maxHeight : empty_cell;
+    heightMap.count[cell]     = count;
+  }
+}
+
+} // namespace visionary
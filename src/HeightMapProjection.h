@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "IExecutor.h"
+#include "VisionaryData.h"
+
+namespace visionary {
+
+/// Parameters of the HeightMapProjection
+struct HeightMapParameters
+{
+  /// World x coordinate of the border of the first column of cells in meters
+  float originX;
+  /// World y coordinate of the border of the first row of cells in meters
+  float originY;
+  /// Edge length of the square cells in meters
+  float cellSize;
+  /// Number of cells along the world x axis
+  int numCellsX;
+  /// Number of cells along the world y axis
+  int numCellsY;
+  /// Points with a world z coordinate below this height in meters are ignored, e.g. the floor
+  float minHeight;
+  /// Points with a world z coordinate above this height in meters are ignored, e.g. the ceiling
+  float maxHeight;
+};
+
+/// 2D grid in the world x-y plane. Cell (x, y) has the index y * numCellsX + x.
+struct HeightMap
+{
+  int numCellsX;
+  int numCellsY;
+  /// Lowest world z coordinate of the points in each cell, NaN for empty cells
+  std::vector<float> minHeight;
+  /// Highest world z coordinate of the points in each cell, NaN for empty cells
+  std::vector<float> maxHeight;
+  /// Number of points in each cell
+  std::vector<std::uint32_t> count;
+};
+
+/// \brief Projection of the world point cloud of a sensor onto a height map
+///
+/// The world points are calculated from the distance map, the look-up-table and the Cam2World matrix in small chunks
+/// which are binned into the cells right away, so the point cloud is never stored.
+/// With an executor the image is split into one band of rows per concurrent range. Each band is projected onto its
+/// own grid, and the grids are merged afterwards, so no atomic operations are needed.
+/// The grids are kept between the calls. An instance must not be used by several threads at the same time.
+class HeightMapProjection
+{
+public:
+  explicit HeightMapProjection(const HeightMapParameters& parameters);
+
+  /// Project the world point cloud of the current frame onto the height map
+  ///
+  /// \param[in]  data      data handler holding the frame, its world look-up-table is updated if needed
+  /// \param[out] heightMap the height map, resized to the number of cells
+  void project(VisionaryData& data, HeightMap& heightMap);
+  /// \copydoc project
+  /// \param[in] executor executor projecting bands of rows in parallel
+  void project(VisionaryData& data, HeightMap& heightMap, IExecutor& executor);
+
+  /// Calculate an occupancy grid from a height map
+  ///
+  /// \param[in]  heightMap height map calculated by project
+  /// \param[in]  minPoints number of points a cell needs to be occupied, at least 1
+  /// \param[out] occupancy 1 for occupied cells and 0 for free cells, resized to the number of cells
+  static void getOccupancyGrid(const HeightMap&           heightMap,
+                               std::uint32_t              minPoints,
+                               std::vector<std::uint8_t>& occupancy);
+
+private:
+  // Resize the grid to the number of cells and make all cells empty
+  void resetGrid(HeightMap& grid) const;
+
+  // Bin the world points [begin, end) of the point cloud into the grid
+  void projectRange(const VisionaryData&                 data,
+                    const VisionaryData::PixelValidator& validator,
+                    std::size_t                          begin,
+                    std::size_t                          end,
+                    HeightMap&                           grid) const;
+
+  // Merge the grids of the bands into the cells [begin, end) of the height map and mark empty cells
+  void mergeRange(HeightMap& heightMap, std::size_t numGrids, std::size_t begin, std::size_t end) const;
+
+  HeightMapParameters m_parameters;
+
+  // grids of the bands of rows
+  std::vector<HeightMap> m_grids;
+};
+
+} // namespace visionary
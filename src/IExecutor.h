@@ -0,0 +1,59 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+
+namespace visionary {
+
+/// Interface for executing index ranges in parallel
+///
+/// Implement this to run the parallel algorithms of this library on an own thread pool or task scheduler.
+/// The library provides ThreadPool as default implementation.
+class IExecutor
+{
+public:
+  /// Function processing the index range [begin, end) with a user context
+  using RangeFunction = void (*)(void* pContext, std::size_t begin, std::size_t end);
+
+  virtual ~IExecutor() = default;
+
+  /// Returns the number of ranges which are processed concurrently
+  virtual std::size_t getConcurrency() const = 0;
+
+  /// Split the index range [0, count) into disjoint ranges and process them in parallel
+  ///
+  /// The call blocks until all ranges have been processed. If \a function throws, the remaining ranges are still
+  /// processed and one of the exceptions is rethrown to the caller afterwards.
+  /// \a function may call execute() on the same executor again, implementations must handle this without a deadlock,
+  /// e.g. by processing the nested range inline. Implementations must not allocate memory per call.
+  ///
+  /// \param[in] count number of indices to be processed
+  /// \param[in] function function which is called for each range
+  /// \param[in] pContext user context which is passed to \a function
+  virtual void execute(std::size_t count, RangeFunction function, void* pContext) = 0;
+
+  /// Split the index range [0, count) into disjoint ranges and call \a function(begin, end) for each of them
+  ///
+  /// The callable is passed by reference to the executor, so no copy or allocation takes place.
+  ///
+  /// \param[in] count number of indices to be processed
+  /// \param[in] function callable with signature void(std::size_t begin, std::size_t end)
+  template <class TFunction>
+  void parallelFor(std::size_t count, const TFunction& function)
+  {
+    execute(count, &invokeRange<TFunction>, const_cast<void*>(static_cast<const void*>(&function)));
+  }
+
+private:
+  template <class TFunction>
+  static void invokeRange(void* pContext, std::size_t begin, std::size_t end)
+  {
+    (*static_cast<const TFunction*>(pContext))(begin, end);
+  }
+};
+
+} // namespace visionary
@@ -0,0 +1,243 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "ImageUndistortion.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace visionary {
+
+namespace {
+
+// Marks undistorted pixels whose source lies outside of the image
+const std::uint32_t kNoSource = 0xFFFFFFFFu;
+
+// Number of iterations to invert the distortion model
+const int kNumIterations = 20;
+
+// Apply the distortion correction of the point cloud calculation to the normalized image coordinates (x, y).
+// Like VisionaryData::preCalcCamInfo only the radial parameters k1 and k2 are used, so the undistorted image matches
+// the directions of the points.
+void correctDistortion(const CameraParameters& camera, double x, double y, double& xCorrected, double& yCorrected)
+{
+  const double r2     = x * x + y * y;
+  const double radial = 1. + camera.k1 * r2 + camera.k2 * r2 * r2;
+  xCorrected          = x * radial;
+  yCorrected          = y * radial;
+}
+
+std::uint16_t interpolate(const std::uint16_t* pImage,
+                          std::size_t          source,
+                          std::size_t          stepX,
+                          std::size_t          stepY,
+                          std::uint32_t        weight00,
+                          std::uint32_t        weight01,
+                          std::uint32_t        weight10,
+                          std::uint32_t        weight11)
+{
+  // the weights sum up to 1 << 16, so the sum fits into 32 bit
+  const std::uint32_t sum = pImage[source] * weight00 + pImage[source + stepX] * weight01
+                            + pImage[source + stepY] * weight10 + pImage[source + stepY + stepX] * weight11;
+  return static_cast<std::uint16_t>((sum + 0x8000u) >> 16u);
+}
+
+std::uint32_t interpolate(const std::uint32_t* pImage,
+                          std::size_t          source,
+                          std::size_t          stepX,
+                          std::size_t          stepY,
+                          std::uint32_t        weight00,
+                          std::uint32_t        weight01,
+                          std::uint32_t        weight10,
+                          std::uint32_t        weight11)
+{
+  const std::uint32_t p00 = pImage[source];
+  const std::uint32_t p01 = pImage[source + stepX];
+  const std::uint32_t p10 = pImage[source + stepY];
+  const std::uint32_t p11 = pImage[source + stepY + stepX];
+
+  std::uint32_t result = 0u;
+  for (std::uint32_t shift = 0u; shift < 32u; shift += 8u)
+  {
+    const std::uint32_t sum = ((p00 >> shift) & 0xFFu) * weight00 + ((p01 >> shift) & 0xFFu) * weight01
+                              + ((p10 >> shift) & 0xFFu) * weight10 + ((p11 >> shift) & 0xFFu) * weight11;
+    result |= ((sum + 0x8000u) >> 16u) << shift;
+  }
+  return result;
+}
+
+} // namespace
+
+ImageUndistortion::ImageUndistortion(UndistortionInterpolation interpolation)
+  : m_interpolation(interpolation), m_isTableValid(false), m_changeCounter(0u), m_roi(), m_stepX(0u), m_stepY(0u)
+{
+}
+
+void ImageUndistortion::undistort(const VisionaryData&              data,
+                                  const std::vector<std::uint16_t>& image,
+                                  std::vector<std::uint16_t>&       undistorted)
+{
+  undistortImpl(data, image, undistorted, nullptr);
+}
+
+void ImageUndistortion::undistort(const VisionaryData&              data,
+                                  const std::vector<std::uint16_t>& image,
+                                  std::vector<std::uint16_t>&       undistorted,
+                                  IExecutor&                        executor)
+{
+  undistortImpl(data, image, undistorted, &executor);
+}
+
+void ImageUndistortion::undistort(const VisionaryData&              data,
+                                  const std::vector<std::uint32_t>& image,
+                                  std::vector<std::uint32_t>&       undistorted)
+{
+  undistortImpl(data, image, undistorted, nullptr);
+}
+
+void ImageUndistortion::undistort(const VisionaryData&              data,
+                                  const std::vector<std::uint32_t>& image,
+                                  std::vector<std::uint32_t>&       undistorted,
+                                  IExecutor&                        executor)
+{
+  undistortImpl(data, image, undistorted, &executor);
+}
+
+void ImageUndistortion::updateRemapTable(const VisionaryData& data)
+{
+  const RegionOfInterest& roi = data.getRegionOfInterest();
+  if (m_isTableValid && m_changeCounter == data.getChangeCounter() && m_roi.left == roi.left && m_roi.top == roi.top
+      && m_roi.width == roi.width && m_roi.height == roi.height)
+  {
+    return;
+  }
+
+  const CameraParameters& camera   = data.getCameraParameters();
+  const auto              width    = static_cast<std::size_t>(roi.width);
+  const auto              height   = static_cast<std::size_t>(roi.height);
+  const std::size_t       stepRows = (height > 1u) ? 1u : 0u;
+  m_stepX                          = (width > 1u) ? 1u : 0u;
+  m_stepY                          = stepRows * width;
+  m_table.resize(width * height);
+
+  for (std::size_t row = 0u; row < height; ++row)
+  {
+    for (std::size_t col = 0u; col < width; ++col)
+    {
+      // normalized coordinates of the undistorted pixel, in the image coordinates of the point cloud calculation
+      const double xCorrected = (camera.cx - static_cast<double>(static_cast<std::size_t>(roi.left) + col)) / camera.fx;
+      const double yCorrected = (camera.cy - static_cast<double>(static_cast<std::size_t>(roi.top) + row)) / camera.fy;
+
+      // find the distorted position whose correction gives the pixel by fixed point iteration
+      double x = xCorrected;
+      double y = yCorrected;
+      for (int iteration = 0; iteration < kNumIterations; ++iteration)
+      {
+        double xEstimate = 0.;
+        double yEstimate = 0.;
+        correctDistortion(camera, x, y, xEstimate, yEstimate);
+        x += xCorrected - xEstimate;
+        y += yCorrected - yEstimate;
+      }
+
+      // position in the image data of the region of interest
+      const double sourceX = camera.cx - x * camera.fx - roi.left;
+      const double sourceY = camera.cy - y * camera.fy - roi.top;
+
+      RemapEntry& entry = m_table[row * width + col];
+      entry             = RemapEntry{kNoSource, 0u, 0u};
+      if (!(sourceX > -0.5 && sourceX < static_cast<double>(width) - 0.5 && sourceY > -0.5
+            && sourceY < static_cast<double>(height) - 0.5))
+      {
+        continue;
+      }
+      if (m_interpolation == UNDISTORT_NEAREST)
+      {
+        entry.source = static_cast<std::uint32_t>(static_cast<std::size_t>(sourceY + 0.5) * width
+                                                  + static_cast<std::size_t>(sourceX + 0.5));
+      }
+      else
+      {
+        // the top left pixel is chosen so the neighbors are inside of the image
+        const double clampedX = std::min(std::max(sourceX, 0.), static_cast<double>(width - 1u));
+        const double clampedY = std::min(std::max(sourceY, 0.), static_cast<double>(height - 1u));
+        const auto   left     = std::min(static_cast<std::size_t>(clampedX), width - 1u - m_stepX);
+        const auto   top      = std::min(static_cast<std::size_t>(clampedY), height - 1u - stepRows);
+        entry.source          = static_cast<std::uint32_t>(top * width + left);
+        entry.fractionX       = static_cast<std::uint16_t>((clampedX - static_cast<double>(left)) * 256. + 0.5);
+        entry.fractionY       = static_cast<std::uint16_t>((clampedY - static_cast<double>(top)) * 256. + 0.5);
+      }
+    }
+  }
+
+  m_changeCounter = data.getChangeCounter();
+  m_roi           = roi;
+  m_isTableValid  = true;
+}
+
+template <typename TPixel>
+void ImageUndistortion::undistortImpl(const VisionaryData&       data,
+                                      const std::vector<TPixel>& image,
+                                      std::vector<TPixel>&       undistorted,
+                                      IExecutor*                 pExecutor)
+{
+  updateRemapTable(data);
+  assert(image.size() == m_table.size()); // the image must have the size of the region of interest
+
+  undistorted.resize(image.size());
+  const TPixel* pImage       = image.data();
+  TPixel*       pUndistorted = undistorted.data();
+  if (pExecutor == nullptr)
+  {
+    undistortRange(pImage, pUndistorted, 0u, image.size());
+  }
+  else
+  {
+    pExecutor->parallelFor(image.size(), [this, pImage, pUndistorted](std::size_t begin, std::size_t end) {
+      undistortRange(pImage, pUndistorted, begin, end);
+    });
+  }
+}
+
+template <typename TPixel>
+void ImageUndistortion::undistortRange(const TPixel* pImage,
+                                       TPixel*       pUndistorted,
+                                       std::size_t   begin,
+                                       std::size_t   end) const
+{
+  const RemapEntry* pTable = m_table.data();
+  if (m_interpolation == UNDISTORT_NEAREST)
+  {
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      const std::uint32_t source = pTable[i].source;
+      pUndistorted[i]            = (source == kNoSource) ? TPixel(0u) : pImage[source];
+    }
+    return;
+  }
+
+  for (std::size_t i = begin; i < end; ++i)
+  {
+    const RemapEntry& entry = pTable[i];
+    if (entry.source == kNoSource)
+    {
+      pUndistorted[i] = TPixel(0u);
+      continue;
+    }
+    const std::uint32_t fractionX = entry.fractionX;
+    const std::uint32_t fractionY = entry.fractionY;
+    pUndistorted[i]               = interpolate(pImage,
+                                  entry.source,
+                                  m_stepX,
+                                  m_stepY,
+                                  (256u - fractionX) * (256u - fractionY),
+                                  fractionX * (256u - fractionY),
+                                  (256u - fractionX) * fractionY,
+                                  fractionX * fractionY);
+  }
+}
+
+} // namespace visionary
@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "IExecutor.h"
+#include "VisionaryData.h"
+
+namespace visionary {
+
+enum UndistortionInterpolation
+{
+  /// Value of the nearest source pixel
+  UNDISTORT_NEAREST = 0,
+
+  /// Bilinear interpolation of the 4 neighboring source pixels
+  UNDISTORT_BILINEAR = 1
+};
+
+/// \brief Removal of the lens distortion from 2D images like the intensity map or the Visionary-S RGBA map
+///
+/// The undistorted image has the camera matrix of the data handler without distortion. Each of its pixels is looked
+/// up in a remap table, which holds the position of the pixel in the distorted image. The distortion model is the one
+/// of the point cloud calculation, i.e. only the radial parameters k1 and k2 are used, so each undistorted pixel
+/// belongs to the point of the same index.
+/// The table is built once and rebuilt only if the change counter or the region of interest of the data handler
+/// change. Pixels whose source lies outside of the image are 0.
+/// An instance must not be used by several threads at the same time.
+class ImageUndistortion
+{
+public:
+  explicit ImageUndistortion(UndistortionInterpolation interpolation);
+
+  /// Undistort an image with 16 bit pixels, e.g. the intensity map
+  ///
+  /// \param[in]  data        data handler the image belongs to
+  /// \param[in]  image       the image of the size of the region of interest of the data handler
+  /// \param[out] undistorted the undistorted image, resized to the size of image
+  void undistort(const VisionaryData&              data,
+                 const std::vector<std::uint16_t>& image,
+                 std::vector<std::uint16_t>&       undistorted);
+  /// \copydoc undistort(const VisionaryData&, const std::vector<std::uint16_t>&, std::vector<std::uint16_t>&)
+  /// \param[in] executor executor processing ranges of pixels in parallel
+  void undistort(const VisionaryData&              data,
+                 const std::vector<std::uint16_t>& image,
+                 std::vector<std::uint16_t>&       undistorted,
+                 IExecutor&                        executor);
+
+  /// Undistort an RGBA image, e.g. the RGBA map of Visionary-S. Each of the 4 byte channels is interpolated.
+  ///
+  /// \param[in]  data        data handler the image belongs to
+  /// \param[in]  image       the image of the size of the region of interest of the data handler
+  /// \param[out] undistorted the undistorted image, resized to the size of image
+  void undistort(const VisionaryData&              data,
+                 const std::vector<std::uint32_t>& image,
+                 std::vector<std::uint32_t>&       undistorted);
+  /// \copydoc undistort(const VisionaryData&, const std::vector<std::uint32_t>&, std::vector<std::uint32_t>&)
+  /// \param[in] executor executor processing ranges of pixels in parallel
+  void undistort(const VisionaryData&              data,
+                 const std::vector<std::uint32_t>& image,
+                 std::vector<std::uint32_t>&       undistorted,
+                 IExecutor&                        executor);
+
+private:
+  // Source of an undistorted pixel: index of the (top left) source pixel and the fractions of the position between it
+  // and its right and lower neighbors in 1/256 pixels
+  struct RemapEntry
+  {
+    std::uint32_t source;
+    std::uint16_t fractionX;
+    std::uint16_t fractionY;
+  };
+
+  // Rebuild the remap table if the change counter or the region of interest of the data handler changed
+  void updateRemapTable(const VisionaryData& data);
+
+  template <typename TPixel>
+  void undistortImpl(const VisionaryData&       data,
+                     const std::vector<TPixel>& image,
+                     std::vector<TPixel>&       undistorted,
+                     IExecutor*                 pExecutor);
+
+  // Undistort the pixels [begin, end)
+  template <typename TPixel>
+  void undistortRange(const TPixel* pImage, TPixel* pUndistorted, std::size_t begin, std::size_t end) const;
+
+  UndistortionInterpolation m_interpolation;
+
+  bool             m_isTableValid;
+  std::uint32_t    m_changeCounter;
+  RegionOfInterest m_roi;
+  // offsets of the right and the lower neighbor of a source pixel, 0 at the image borders
+  std::size_t             m_stepX;
+  std::size_t             m_stepY;
+  std::vector<RemapEntry> m_table;
+};
+
+} // namespace visionary
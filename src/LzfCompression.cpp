@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "LzfCompression.h"
+
+#include <algorithm>
+
+namespace visionary {
+
+namespace {
+const std::size_t   kHashBits      = 14u;
+const std::size_t   kMaxLiterals   = 32u;
+const std::size_t   kMaxOffset     = 1u << 13u;
+const std::size_t   kMinMatch      = 3u;
+const std::size_t   kMaxMatch      = 264u;
+const std::size_t   kNoReference   = 0u;
+const std::uint8_t  kLongMatchCode = 7u;
+
+std::uint32_t hashBytes(const std::uint8_t* p)
+{
+  const std::uint32_t value = (static_cast<std::uint32_t>(p[0]) << 16u) | (static_cast<std::uint32_t>(p[1]) << 8u)
+                              | static_cast<std::uint32_t>(p[2]);
+  return (value * 2654435761u) >> (32u - kHashBits);
+}
+
+void writeLiterals(const std::uint8_t* pIn, std::size_t begin, std::size_t end, std::vector<std::uint8_t>& out)
+{
+  while (begin < end)
+  {
+    const std::size_t count = std::min(kMaxLiterals, end - begin);
+    out.push_back(static_cast<std::uint8_t>(count - 1u));
+    out.insert(out.end(), pIn + begin, pIn + begin + count);
+    begin += count;
+  }
+}
+} // namespace
+
+void lzfCompress(const std::uint8_t* pIn, std::size_t inSize, std::vector<std::uint8_t>& out)
+{
+  out.clear();
+  out.reserve(inSize + inSize / kMaxLiterals + 1u);
+
+  // position + 1 of the last occurrence of each hash of 3 bytes
+  std::vector<std::size_t> hashTable(std::size_t(1u) << kHashBits, kNoReference);
+
+  std::size_t literalBegin = 0u;
+  std::size_t pos          = 0u;
+  while (pos + kMinMatch <= inSize)
+  {
+    const std::uint32_t hash      = hashBytes(pIn + pos);
+    const std::size_t   reference = hashTable[hash];
+    hashTable[hash]               = pos + 1u;
+    if (reference == kNoReference || pos - reference >= kMaxOffset || pIn[reference - 1u] != pIn[pos]
+        || pIn[reference] != pIn[pos + 1u] || pIn[reference + 1u] != pIn[pos + 2u])
+    {
+      ++pos;
+      continue;
+    }
+
+    const std::size_t matchBegin = reference - 1u;
+    const std::size_t maxLength  = std::min(kMaxMatch, inSize - pos);
+    std::size_t       length     = kMinMatch;
+    while (length < maxLength && pIn[matchBegin + length] == pIn[pos + length])
+    {
+      ++length;
+    }
+
+    writeLiterals(pIn, literalBegin, pos, out);
+    const std::size_t offset     = pos - matchBegin - 1u;
+    const std::size_t lengthCode = length - 2u;
+    const auto        offsetHigh = static_cast<std::uint8_t>(offset >> 8u);
+    if (lengthCode < kLongMatchCode)
+    {
+      out.push_back(static_cast<std::uint8_t>((lengthCode << 5u) | offsetHigh));
+    }
+    else
+    {
+      out.push_back(static_cast<std::uint8_t>((kLongMatchCode << 5u) | offsetHigh));
+      out.push_back(static_cast<std::uint8_t>(lengthCode - kLongMatchCode));
+    }
+    out.push_back(static_cast<std::uint8_t>(offset));
+
+    pos += length;
+    literalBegin = pos;
+  }
+  writeLiterals(pIn, literalBegin, inSize, out);
+}
+
+bool lzfDecompress(const std::uint8_t* pIn, std::size_t inSize, std::uint8_t* pOut, std::size_t outSize)
+{
+  std::size_t inPos  = 0u;
+  std::size_t outPos = 0u;
+  while (inPos < inSize)
+  {
+    const std::size_t control = pIn[inPos++];
+    if (control < kMaxLiterals)
+    {
+      const std::size_t count = control + 1u;
+      if (count > inSize - inPos || count > outSize - outPos)
+      {
+        return false;
+      }
+      std::copy(pIn + inPos, pIn + inPos + count, pOut + outPos);
+      inPos += count;
+      outPos += count;
+      continue;
+    }
+
+    std::size_t length = control >> 5u;
+    if (length == kLongMatchCode)
+    {
+      if (inPos == inSize)
+      {
+        return false;
+      }
+      length += pIn[inPos++];
+    }
+    length += 2u;
+    if (inPos == inSize)
+    {
+      return false;
+    }
+    const std::size_t distance = (((control & 0x1Fu) << 8u) | pIn[inPos++]) + 1u;
+    if (distance > outPos || length > outSize - outPos)
+    {
+      return false;
+    }
+    // the source may overlap the destination, so copy byte by byte
+    for (std::size_t i = 0u; i < length; ++i, ++outPos)
+    {
+      pOut[outPos] = pOut[outPos - distance];
+    }
+  }
+  return outPos == outSize;
+}
+
+} // namespace visionary
@@ -0,0 +1,23 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace visionary {
+
+// LZF compression as used by the binary_compressed data of PCD files. The compressed data is compatible with liblzf.
+
+// Compress inSize bytes from pIn, replaces the content of out
+void lzfCompress(const std::uint8_t* pIn, std::size_t inSize, std::vector<std::uint8_t>& out);
+
+// Decompress inSize bytes from pIn into exactly outSize bytes at pOut.
+// Returns false if the compressed data is malformed or does not decompress to outSize bytes.
+bool lzfDecompress(const std::uint8_t* pIn, std::size_t inSize, std::uint8_t* pOut, std::size_t outSize);
+
+} // namespace visionary
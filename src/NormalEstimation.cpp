@@ -0,0 +1,314 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "NormalEstimation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace visionary {
+
+namespace {
+
+const float bad_normal = std::numeric_limits<float>::quiet_NaN();
+
+bool isValidPoint(const PointXYZ& point)
+{
+  return !std::isnan(point.z);
+}
+
+// Returns a - b
+PointXYZ subtract(const PointXYZ& a, const PointXYZ& b)
+{
+  return PointXYZ{a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+// Returns true if b is at most maxDistance away from a, or if maxDistance is 0
+bool isNear(const PointXYZ& a, const PointXYZ& b, float maxDistance)
+{
+  const PointXYZ d = subtract(a, b);
+  return (maxDistance <= 0.0f) || (d.x * d.x + d.y * d.y + d.z * d.z <= maxDistance * maxDistance);
+}
+
+// Tangent through center from the neighbor before to the neighbor after. If one of the neighbors is missing the one
+// sided difference is used. Returns false if both are missing.
+bool getTangent(const PointXYZ& before,
+                bool            hasBefore,
+                const PointXYZ& center,
+                const PointXYZ& after,
+                bool            hasAfter,
+                PointXYZ&       tangent)
+{
+  if (hasBefore && hasAfter)
+  {
+    tangent = subtract(after, before);
+  }
+  else if (hasAfter)
+  {
+    tangent = subtract(after, center);
+  }
+  else if (hasBefore)
+  {
+    tangent = subtract(center, before);
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+// Process all rows sequentially or the ranges in parallel if an executor is given
+template <class TFunction>
+void forEachRange(IExecutor* pExecutor, std::size_t count, const TFunction& function)
+{
+  if (pExecutor == nullptr)
+  {
+    function(0u, count);
+  }
+  else
+  {
+    pExecutor->parallelFor(count, function);
+  }
+}
+
+} // namespace
+
+NormalEstimation::NormalEstimation(const NormalEstimationParameters& parameters)
+  : m_parameters(parameters), m_integralWidth(0u)
+{
+  assert(m_parameters.neighborDistance >= 1);
+  assert(m_parameters.smoothingSize >= 0);
+}
+
+void NormalEstimation::compute(const std::vector<PointXYZ>& pointCloud,
+                               int                          width,
+                               int                          height,
+                               std::vector<PointNormal>&    normals)
+{
+  computeImpl(pointCloud, width, height, normals, nullptr);
+}
+
+void NormalEstimation::compute(const std::vector<PointXYZ>& pointCloud,
+                               int                          width,
+                               int                          height,
+                               std::vector<PointNormal>&    normals,
+                               IExecutor&                   executor)
+{
+  computeImpl(pointCloud, width, height, normals, &executor);
+}
+
+void NormalEstimation::computeImpl(const std::vector<PointXYZ>& pointCloud,
+                                   int                          width,
+                                   int                          height,
+                                   std::vector<PointNormal>&    normals,
+                                   IExecutor*                   pExecutor)
+{
+  assert(width >= 0 && height >= 0
+         && pointCloud.size() == static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+
+  const auto      numColumns = static_cast<std::size_t>(width);
+  const auto      numRows    = static_cast<std::size_t>(height);
+  const PointXYZ* pPoints    = pointCloud.data();
+  normals.resize(pointCloud.size());
+  PointNormal* pNormals = normals.data();
+
+  if (m_parameters.smoothingSize > 0)
+  {
+    buildIntegralImages(pPoints, numColumns, numRows, pExecutor);
+  }
+  forEachRange(pExecutor, numRows, [this, pPoints, numColumns, numRows, pNormals](std::size_t begin, std::size_t end) {
+    computeRows(pPoints, numColumns, numRows, pNormals, begin, end);
+  });
+}
+
+void NormalEstimation::buildIntegralImages(const PointXYZ* pPoints,
+                                           std::size_t     width,
+                                           std::size_t     height,
+                                           IExecutor*      pExecutor)
+{
+  const std::size_t stride = width + 1u;
+  m_integralWidth          = stride;
+  m_sumX.resize(stride * (height + 1u));
+  m_sumY.resize(stride * (height + 1u));
+  m_sumZ.resize(stride * (height + 1u));
+  m_count.resize(stride * (height + 1u));
+
+  // the first row and the first column are 0
+  std::fill(m_sumX.begin(), m_sumX.begin() + static_cast<std::ptrdiff_t>(stride), 0.0);
+  std::fill(m_sumY.begin(), m_sumY.begin() + static_cast<std::ptrdiff_t>(stride), 0.0);
+  std::fill(m_sumZ.begin(), m_sumZ.begin() + static_cast<std::ptrdiff_t>(stride), 0.0);
+  std::fill(m_count.begin(), m_count.begin() + static_cast<std::ptrdiff_t>(stride), 0u);
+
+  // sums along the rows
+  forEachRange(pExecutor, height, [this, pPoints, width, stride](std::size_t begin, std::size_t end) {
+    for (std::size_t row = begin; row < end; ++row)
+    {
+      const PointXYZ*   pRow   = pPoints + row * width;
+      const std::size_t offset = (row + 1u) * stride;
+      double            sumX   = 0.0;
+      double            sumY   = 0.0;
+      double            sumZ   = 0.0;
+      std::uint32_t     count  = 0u;
+      m_sumX[offset]           = 0.0;
+      m_sumY[offset]           = 0.0;
+      m_sumZ[offset]           = 0.0;
+      m_count[offset]          = 0u;
+      for (std::size_t x = 0u; x < width; ++x)
+      {
+        if (isValidPoint(pRow[x]))
+        {
+          sumX += static_cast<double>(pRow[x].x);
+          sumY += static_cast<double>(pRow[x].y);
+          sumZ += static_cast<double>(pRow[x].z);
+          ++count;
+        }
+        m_sumX[offset + x + 1u]  = sumX;
+        m_sumY[offset + x + 1u]  = sumY;
+        m_sumZ[offset + x + 1u]  = sumZ;
+        m_count[offset + x + 1u] = count;
+      }
+    }
+  });
+
+  // sums along the columns
+  forEachRange(pExecutor, width, [this, height, stride](std::size_t begin, std::size_t end) {
+    for (std::size_t row = 2u; row <= height; ++row)
+    {
+      const std::size_t offset = row * stride + 1u;
+      for (std::size_t x = begin; x < end; ++x)
+      {
+        m_sumX[offset + x] += m_sumX[offset + x - stride];
+        m_sumY[offset + x] += m_sumY[offset + x - stride];
+        m_sumZ[offset + x] += m_sumZ[offset + x - stride];
+        m_count[offset + x] += m_count[offset + x - stride];
+      }
+    }
+  });
+}
+
+bool NormalEstimation::getBoxMean(std::size_t x0, std::size_t y0, std::size_t x1, std::size_t y1, PointXYZ& mean) const
+{
+  const std::size_t topLeft     = y0 * m_integralWidth + x0;
+  const std::size_t topRight    = y0 * m_integralWidth + x1 + 1u;
+  const std::size_t bottomLeft  = (y1 + 1u) * m_integralWidth + x0;
+  const std::size_t bottomRight = (y1 + 1u) * m_integralWidth + x1 + 1u;
+
+  const std::uint32_t count = m_count[bottomRight] - m_count[bottomLeft] - m_count[topRight] + m_count[topLeft];
+  if (count == 0u)
+  {
+    return false;
+  }
+  const double scale = 1.0 / count;
+
+  mean.x = static_cast<float>((m_sumX[bottomRight] - m_sumX[bottomLeft] - m_sumX[topRight] + m_sumX[topLeft]) * scale);
+  mean.y = static_cast<float>((m_sumY[bottomRight] - m_sumY[bottomLeft] - m_sumY[topRight] + m_sumY[topLeft]) * scale);
+  mean.z = static_cast<float>((m_sumZ[bottomRight] - m_sumZ[bottomLeft] - m_sumZ[topRight] + m_sumZ[topLeft]) * scale);
+  return true;
+}
+
+void NormalEstimation::computeRows(const PointXYZ* pPoints,
+                                   std::size_t     width,
+                                   std::size_t     height,
+                                   PointNormal*    pNormals,
+                                   std::size_t     rowBegin,
+                                   std::size_t     rowEnd) const
+{
+  const auto distance  = static_cast<std::size_t>(m_parameters.neighborDistance);
+  const auto smoothing = static_cast<std::size_t>(m_parameters.smoothingSize);
+  // maximum distances of the direct neighbors and of the box means, which are (smoothing + 1) / 2 pixels away
+  const float maxNeighborDistance = m_parameters.maxNeighborDistance * static_cast<float>(distance);
+  const float maxBoxDistance      = m_parameters.maxNeighborDistance * 0.5f * static_cast<float>(smoothing + 1u);
+
+  for (std::size_t row = rowBegin; row < rowEnd; ++row)
+  {
+    for (std::size_t x = 0u; x < width; ++x)
+    {
+      const std::size_t i      = row * width + x;
+      const PointXYZ&   center = pPoints[i];
+      PointNormal&      normal = pNormals[i];
+      normal                   = PointNormal{bad_normal, bad_normal, bad_normal};
+      if (!isValidPoint(center))
+      {
+        continue;
+      }
+
+      PointXYZ left{};
+      PointXYZ right{};
+      PointXYZ up{};
+      PointXYZ down{};
+      bool     hasLeft  = false;
+      bool     hasRight = false;
+      bool     hasUp    = false;
+      bool     hasDown  = false;
+      if (smoothing > 0u)
+      {
+        const std::size_t colMin = (x >= smoothing) ? x - smoothing : 0u;
+        const std::size_t colMax = std::min(x + smoothing, width - 1u);
+        const std::size_t rowMin = (row >= smoothing) ? row - smoothing : 0u;
+        const std::size_t rowMax = std::min(row + smoothing, height - 1u);
+
+        hasLeft  = (x > 0u) && getBoxMean(colMin, rowMin, x - 1u, rowMax, left);
+        hasRight = (x + 1u < width) && getBoxMean(x + 1u, rowMin, colMax, rowMax, right);
+        hasUp    = (row > 0u) && getBoxMean(colMin, rowMin, colMax, row - 1u, up);
+        hasDown  = (row + 1u < height) && getBoxMean(colMin, row + 1u, colMax, rowMax, down);
+        hasLeft  = hasLeft && isNear(left, center, maxBoxDistance);
+        hasRight = hasRight && isNear(right, center, maxBoxDistance);
+        hasUp    = hasUp && isNear(up, center, maxBoxDistance);
+        hasDown  = hasDown && isNear(down, center, maxBoxDistance);
+      }
+
+      // without smoothing, or if a box reaches across a depth discontinuity, the direct neighbors are used
+      if (!hasLeft && x >= distance)
+      {
+        left    = pPoints[i - distance];
+        hasLeft = isValidPoint(left) && isNear(left, center, maxNeighborDistance);
+      }
+      if (!hasRight && x + distance < width)
+      {
+        right    = pPoints[i + distance];
+        hasRight = isValidPoint(right) && isNear(right, center, maxNeighborDistance);
+      }
+      if (!hasUp && row >= distance)
+      {
+        up    = pPoints[i - distance * width];
+        hasUp = isValidPoint(up) && isNear(up, center, maxNeighborDistance);
+      }
+      if (!hasDown && row + distance < height)
+      {
+        down    = pPoints[i + distance * width];
+        hasDown = isValidPoint(down) && isNear(down, center, maxNeighborDistance);
+      }
+
+      PointXYZ tangentX{};
+      PointXYZ tangentY{};
+      if (!getTangent(left, hasLeft, center, right, hasRight, tangentX)
+          || !getTangent(up, hasUp, center, down, hasDown, tangentY))
+      {
+        continue;
+      }
+
+      float nx = tangentX.y * tangentY.z - tangentX.z * tangentY.y;
+      float ny = tangentX.z * tangentY.x - tangentX.x * tangentY.z;
+      float nz = tangentX.x * tangentY.y - tangentX.y * tangentY.x;
+
+      // orient towards the viewpoint
+      const PointXYZ toViewpoint = subtract(m_parameters.viewpoint, center);
+      const float    sign   = (nx * toViewpoint.x + ny * toViewpoint.y + nz * toViewpoint.z < 0.0f) ? -1.0f : 1.0f;
+      const float    length = std::sqrt(nx * nx + ny * ny + nz * nz);
+      if (length > 0.0f)
+      {
+        nx *= sign / length;
+        ny *= sign / length;
+        nz *= sign / length;
+        normal = PointNormal{nx, ny, nz};
+      }
+    }
+  }
+}
+
+} // namespace visionary
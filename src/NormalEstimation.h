@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "IExecutor.h"
+#include "PointNormal.h"
+#include "PointXYZ.h"
+
+namespace visionary {
+
+/// Parameters of the NormalEstimation
+struct NormalEstimationParameters
+{
+  /// Image distance in pixels of the neighbors whose difference gives the tangents (without smoothing), at least 1
+  int neighborDistance;
+  /// Half size of the boxes whose mean points give the tangents, 0 disables the smoothing.
+  /// With smoothing the tangent in x is the difference of the means of the (2 * smoothingSize + 1) x smoothingSize
+  /// boxes right and left of the point, calculated in constant time from integral images.
+  int smoothingSize;
+  /// Neighbors (or box means) farther from the point than this distance in meters per pixel of image distance are
+  /// across a depth discontinuity and are not used. 0 disables the check.
+  float maxNeighborDistance;
+  /// The normals point towards this position, e.g. (0, 0, 0) for point clouds in camera coordinates
+  PointXYZ viewpoint;
+};
+
+/// \brief Surface normals of organized point clouds
+///
+/// The point clouds of the data handlers are organized: point (row * width + column) belongs to the pixel
+/// (column, row). So the neighbors of a point are found in the image instead of by a nearest neighbor search.
+/// The normal of a point is the cross product of the tangents in x and y direction, which are differences of the
+/// neighboring points (or of the mean points of neighboring boxes with smoothing).
+///
+/// If a box reaches across a depth discontinuity, the direct neighbor is used instead of its mean. If a neighbor is
+/// invalid or across a depth discontinuity, the one sided difference to the other neighbor is used.
+/// The normal is invalid (NaN) if the point is invalid or a tangent can't be calculated.
+/// The buffers of the integral images are kept between the calls. An instance must not be used by several threads
+/// at the same time.
+class NormalEstimation
+{
+public:
+  explicit NormalEstimation(const NormalEstimationParameters& parameters);
+
+  /// Calculate the normals of the point cloud
+  ///
+  /// \param[in]  pointCloud organized point cloud, invalid points are NaN
+  /// \param[in]  width      width of the point cloud in pixels
+  /// \param[in]  height     height of the point cloud in pixels
+  /// \param[out] normals    the normal of each point, resized to the size of the point cloud
+  void compute(const std::vector<PointXYZ>& pointCloud, int width, int height, std::vector<PointNormal>& normals);
+  /// \copydoc compute
+  /// \param[in] executor executor processing bands of rows in parallel
+  void compute(const std::vector<PointXYZ>& pointCloud,
+               int                          width,
+               int                          height,
+               std::vector<PointNormal>&    normals,
+               IExecutor&                   executor);
+
+private:
+  void computeImpl(const std::vector<PointXYZ>& pointCloud,
+                   int                          width,
+                   int                          height,
+                   std::vector<PointNormal>&    normals,
+                   IExecutor*                   pExecutor);
+
+  // Calculate the integral images of the coordinates and of the number of valid points
+  void buildIntegralImages(const PointXYZ* pPoints, std::size_t width, std::size_t height, IExecutor* pExecutor);
+
+  // Calculate the mean of the valid points in the box [x0, x1] x [y0, y1]. Returns false if there is none.
+  bool getBoxMean(std::size_t x0, std::size_t y0, std::size_t x1, std::size_t y1, PointXYZ& mean) const;
+
+  // Calculate the normals of the rows [rowBegin, rowEnd)
+  void computeRows(const PointXYZ* pPoints,
+                   std::size_t     width,
+                   std::size_t     height,
+                   PointNormal*    pNormals,
+                   std::size_t     rowBegin,
+                   std::size_t     rowEnd) const;
+
+  NormalEstimationParameters m_parameters;
+
+  // integral images of size (width + 1) x (height + 1)
+  std::size_t                m_integralWidth;
+  std::vector<double>        m_sumX;
+  std::vector<double>        m_sumY;
+  std::vector<double>        m_sumZ;
+  std::vector<std::uint32_t> m_count;
+};
+
+} // namespace visionary
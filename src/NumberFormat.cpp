@@ -0,0 +1,405 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "NumberFormat.h"
+
+#include <cstring>
+
+namespace visionary {
+
+namespace {
+// The float formatting follows the Ryu algorithm by Ulf Adams (https://github.com/ulfjack/ryu): the decimal
+// interval of the values rounding to the float is computed with fixed size 64 bit multiplications by tabulated
+// powers of 5, and digits are removed while the interval still contains a shorter number.
+
+const int kFloatMantissaBits = 23;
+const int kFloatExponentBits = 8;
+const int kFloatBias         = 127;
+const int kPow5InvBitCount   = 59;
+const int kPow5BitCount      = 61;
+
+// floor(2^(pow5Bits(q) - 1 + kPow5InvBitCount) / 5^q) + 1
+const std::uint64_t kPow5InvSplit[31] = {
+  576460752303423489u, 461168601842738791u, 368934881474191033u, 295147905179352826u, 472236648286964522u,
+  377789318629571618u, 302231454903657294u, 483570327845851670u, 386856262276681336u, 309485009821345069u,
+  495176015714152110u, 396140812571321688u, 316912650057057351u, 507060240091291761u, 405648192073033409u,
+  324518553658426727u, 519229685853482763u, 415383748682786211u, 332306998946228969u, 531691198313966350u,
+  425352958651173080u, 340282366920938464u, 544451787073501542u, 435561429658801234u, 348449143727040987u,
+  557518629963265579u, 446014903970612463u, 356811923176489971u, 570899077082383953u, 456719261665907162u,
+  365375409332725730u
+};
+
+// 5^i scaled to kPow5BitCount bits
+const std::uint64_t kPow5Split[48] = {
+  1152921504606846976u, 1441151880758558720u, 1801439850948198400u, 2251799813685248000u, 1407374883553280000u,
+  1759218604441600000u, 2199023255552000000u, 1374389534720000000u, 1717986918400000000u, 2147483648000000000u,
+  1342177280000000000u, 1677721600000000000u, 2097152000000000000u, 1310720000000000000u, 1638400000000000000u,
+  2048000000000000000u, 1280000000000000000u, 1600000000000000000u, 2000000000000000000u, 1250000000000000000u,
+  1562500000000000000u, 1953125000000000000u, 1220703125000000000u, 1525878906250000000u, 1907348632812500000u,
+  1192092895507812500u, 1490116119384765625u, 1862645149230957031u, 1164153218269348144u, 1455191522836685180u,
+  1818989403545856475u, 2273736754432320594u, 1421085471520200371u, 1776356839400250464u, 2220446049250313080u,
+  1387778780781445675u, 1734723475976807094u, 2168404344971008868u, 1355252715606880542u, 1694065894508600678u,
+  2117582368135750847u, 1323488980084844279u, 1654361225106055349u, 2067951531382569187u, 1292469707114105741u,
+  1615587133892632177u, 2019483917365790221u, 1262177448353618888u
+};
+
+const char kDigitPairs[] = "00010203040506070809"
+                           "10111213141516171819"
+                           "20212223242526272829"
+                           "30313233343536373839"
+                           "40414243444546474849"
+                           "50515253545556575859"
+                           "60616263646566676869"
+                           "70717273747576777879"
+                           "80818283848586878889"
+                           "90919293949596979899";
+
+// ceil(log2(5^e)) for e > 0, 1 for e = 0
+int pow5Bits(int e)
+{
+  return static_cast<int>((static_cast<std::uint32_t>(e) * 1217359u) >> 19u) + 1;
+}
+
+// floor(log10(2^e)) for 0 <= e <= 1650
+int log10Pow2(int e)
+{
+  return static_cast<int>((static_cast<std::uint32_t>(e) * 78913u) >> 18u);
+}
+
+// floor(log10(5^e)) for 0 <= e <= 2620
+int log10Pow5(int e)
+{
+  return static_cast<int>((static_cast<std::uint32_t>(e) * 732923u) >> 20u);
+}
+
+bool isMultipleOfPowerOf5(std::uint32_t value, int p)
+{
+  int count = 0;
+  for (; value % 5u == 0u && count < p; value /= 5u)
+  {
+    ++count;
+  }
+  return count >= p;
+}
+
+bool isMultipleOfPowerOf2(std::uint32_t value, int p)
+{
+  return (value & ((1u << static_cast<std::uint32_t>(p)) - 1u)) == 0u;
+}
+
+// (m * factor) >> shift with shift > 32
+std::uint32_t mulShift(std::uint32_t m, std::uint64_t factor, int shift)
+{
+  const std::uint64_t factorLo = factor & 0xFFFFFFFFu;
+  const std::uint64_t factorHi = factor >> 32u;
+  const std::uint64_t bits0    = m * factorLo;
+  const std::uint64_t bits1    = m * factorHi;
+  const std::uint64_t sum      = (bits0 >> 32u) + bits1;
+  return static_cast<std::uint32_t>(sum >> static_cast<std::uint32_t>(shift - 32));
+}
+
+std::uint32_t mulPow5InvDivPow2(std::uint32_t m, int q, int j)
+{
+  return mulShift(m, kPow5InvSplit[q], j);
+}
+
+std::uint32_t mulPow5DivPow2(std::uint32_t m, int i, int j)
+{
+  return mulShift(m, kPow5Split[i], j);
+}
+
+// Shortest decimal digits and exponent of a finite positive or zero float, value = digits * 10^exponent
+void floatToDecimal(std::uint32_t ieeeMantissa, int ieeeExponent, std::uint32_t& digits, int& exponent)
+{
+  int           e2 = 0;
+  std::uint32_t m2 = 0u;
+  if (ieeeExponent == 0)
+  {
+    // subnormal, the -2 makes room for the interval bounds
+    e2 = 1 - kFloatBias - kFloatMantissaBits - 2;
+    m2 = ieeeMantissa;
+  }
+  else
+  {
+    e2 = ieeeExponent - kFloatBias - kFloatMantissaBits - 2;
+    m2 = (1u << kFloatMantissaBits) | ieeeMantissa;
+  }
+  // round half to even: the interval bounds belong to the interval if the mantissa is even
+  const bool acceptBounds = (m2 & 1u) == 0u;
+
+  // the interval [mm, mp] of values which round to the float, scaled by 4
+  const std::uint32_t mv      = 4u * m2;
+  const std::uint32_t mp      = 4u * m2 + 2u;
+  const std::uint32_t mmShift = (ieeeMantissa != 0u || ieeeExponent <= 1) ? 1u : 0u;
+  const std::uint32_t mm      = 4u * m2 - 1u - mmShift;
+
+  // the interval in decimal, vr * 10^e10 is the value
+  std::uint32_t vr                = 0u;
+  std::uint32_t vp                = 0u;
+  std::uint32_t vm                = 0u;
+  int           e10               = 0;
+  bool          vmIsTrailingZeros = false;
+  bool          vrIsTrailingZeros = false;
+  std::uint32_t lastRemovedDigit  = 0u;
+  if (e2 >= 0)
+  {
+    const int q = log10Pow2(e2);
+    e10         = q;
+    const int k = kPow5InvBitCount + pow5Bits(q) - 1;
+    const int i = -e2 + q + k;
+    vr          = mulPow5InvDivPow2(mv, q, i);
+    vp          = mulPow5InvDivPow2(mp, q, i);
+    vm          = mulPow5InvDivPow2(mm, q, i);
+    if (q != 0 && (vp - 1u) / 10u <= vm / 10u)
+    {
+      // the loop below removes at least one digit, the last removed one is computed here with one more digit
+      const int l      = kPow5InvBitCount + pow5Bits(q - 1) - 1;
+      lastRemovedDigit = mulPow5InvDivPow2(mv, q - 1, -e2 + q - 1 + l) % 10u;
+    }
+    if (q <= 9)
+    {
+      // only one of mp, mv and mm can be a multiple of 5
+      if (mv % 5u == 0u)
+      {
+        vrIsTrailingZeros = isMultipleOfPowerOf5(mv, q);
+      }
+      else if (acceptBounds)
+      {
+        vmIsTrailingZeros = isMultipleOfPowerOf5(mm, q);
+      }
+      else
+      {
+        vp -= isMultipleOfPowerOf5(mp, q) ? 1u : 0u;
+      }
+    }
+  }
+  else
+  {
+    const int q = log10Pow5(-e2);
+    e10         = q + e2;
+    const int i = -e2 - q;
+    const int k = pow5Bits(i) - kPow5BitCount;
+    int       j = q - k;
+    vr          = mulPow5DivPow2(mv, i, j);
+    vp          = mulPow5DivPow2(mp, i, j);
+    vm          = mulPow5DivPow2(mm, i, j);
+    if (q != 0 && (vp - 1u) / 10u <= vm / 10u)
+    {
+      j                = q - 1 - (pow5Bits(i + 1) - kPow5BitCount);
+      lastRemovedDigit = mulPow5DivPow2(mv, i + 1, j) % 10u;
+    }
+    if (q <= 1)
+    {
+      // mv has at least q trailing zero bits
+      vrIsTrailingZeros = true;
+      if (acceptBounds)
+      {
+        vmIsTrailingZeros = mmShift == 1u;
+      }
+      else
+      {
+        --vp;
+      }
+    }
+    else if (q < 31)
+    {
+      vrIsTrailingZeros = isMultipleOfPowerOf2(mv, q - 1);
+    }
+  }
+
+  // remove the digits which are not needed to identify the float
+  int removed = 0;
+  if (vmIsTrailingZeros || vrIsTrailingZeros)
+  {
+    // rare case, the exact decimal value matters for the bounds and the rounding
+    while (vp / 10u > vm / 10u)
+    {
+      vmIsTrailingZeros &= vm % 10u == 0u;
+      vrIsTrailingZeros &= lastRemovedDigit == 0u;
+      lastRemovedDigit = vr % 10u;
+      vr /= 10u;
+      vp /= 10u;
+      vm /= 10u;
+      ++removed;
+    }
+    if (vmIsTrailingZeros)
+    {
+      while (vm % 10u == 0u)
+      {
+        vrIsTrailingZeros &= lastRemovedDigit == 0u;
+        lastRemovedDigit = vr % 10u;
+        vr /= 10u;
+        vp /= 10u;
+        vm /= 10u;
+        ++removed;
+      }
+    }
+    if (vrIsTrailingZeros && lastRemovedDigit == 5u && vr % 2u == 0u)
+    {
+      // exactly halfway, round to even
+      lastRemovedDigit = 4u;
+    }
+    const bool roundUp = (vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5u;
+    digits = vr + (roundUp ? 1u : 0u);
+  }
+  else
+  {
+    while (vp / 10u > vm / 10u)
+    {
+      lastRemovedDigit = vr % 10u;
+      vr /= 10u;
+      vp /= 10u;
+      vm /= 10u;
+      ++removed;
+    }
+    digits = vr + ((vr == vm || lastRemovedDigit >= 5u) ? 1u : 0u);
+  }
+  exponent = e10 + removed;
+}
+
+int decimalLength(std::uint32_t value)
+{
+  int length = 1;
+  for (; value >= 10u; value /= 10u)
+  {
+    ++length;
+  }
+  return length;
+}
+
+// Write the digits of value right aligned, so the last digit is at pEnd - 1
+void writeDigitsBackwards(std::uint64_t value, char* pEnd)
+{
+  while (value >= 100u)
+  {
+    const std::size_t pair = static_cast<std::size_t>(value % 100u) * 2u;
+    value /= 100u;
+    pEnd -= 2;
+    std::memcpy(pEnd, kDigitPairs + pair, 2u);
+  }
+  if (value >= 10u)
+  {
+    pEnd -= 2;
+    std::memcpy(pEnd, kDigitPairs + static_cast<std::size_t>(value) * 2u, 2u);
+  }
+  else
+  {
+    *--pEnd = static_cast<char>('0' + value);
+  }
+}
+} // namespace
+
+char* formatFloat(float value, char* pOut)
+{
+  std::uint32_t bits = 0u;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const std::uint32_t ieeeMantissa = bits & ((1u << kFloatMantissaBits) - 1u);
+  const int           ieeeExponent = static_cast<int>((bits >> kFloatMantissaBits) & ((1u << kFloatExponentBits) - 1u));
+  const bool          isNegative   = (bits >> (kFloatMantissaBits + kFloatExponentBits)) != 0u;
+
+  if (ieeeExponent == (1 << kFloatExponentBits) - 1)
+  {
+    if (ieeeMantissa != 0u)
+    {
+      std::memcpy(pOut, "nan", 3u);
+      return pOut + 3;
+    }
+    if (isNegative)
+    {
+      *pOut++ = '-';
+    }
+    std::memcpy(pOut, "inf", 3u);
+    return pOut + 3;
+  }
+
+  if (isNegative)
+  {
+    *pOut++ = '-';
+  }
+  if (ieeeExponent == 0 && ieeeMantissa == 0u)
+  {
+    *pOut = '0';
+    return pOut + 1;
+  }
+
+  std::uint32_t digits   = 0u;
+  int           exponent = 0;
+  floatToDecimal(ieeeMantissa, ieeeExponent, digits, exponent);
+  const int length = decimalLength(digits);
+  // decimal exponent of the first digit
+  const int sciExponent = exponent + length - 1;
+
+  if (sciExponent >= -4 && sciExponent < 9)
+  {
+    if (exponent >= 0)
+    {
+      // integer, e.g. 1500
+      writeDigitsBackwards(digits, pOut + length);
+      pOut += length;
+      std::memset(pOut, '0', static_cast<std::size_t>(exponent));
+      return pOut + exponent;
+    }
+    if (sciExponent >= 0)
+    {
+      // e.g. 12.5, the digits are written behind the point position and the integer part is moved before it
+      const int integerLength = sciExponent + 1;
+      writeDigitsBackwards(digits, pOut + length + 1);
+      std::memmove(pOut, pOut + 1, static_cast<std::size_t>(integerLength));
+      pOut[integerLength] = '.';
+      return pOut + length + 1;
+    }
+    // e.g. 0.0125
+    const int numZeros = -sciExponent - 1;
+    pOut[0]            = '0';
+    pOut[1]            = '.';
+    std::memset(pOut + 2, '0', static_cast<std::size_t>(numZeros));
+    pOut += 2 + numZeros;
+    writeDigitsBackwards(digits, pOut + length);
+    return pOut + length;
+  }
+
+  // scientific notation, e.g. 1.25e-07
+  writeDigitsBackwards(digits, pOut + length + 1);
+  pOut[0] = pOut[1];
+  if (length > 1)
+  {
+    pOut[1] = '.';
+    pOut += length + 1;
+  }
+  else
+  {
+    pOut += 1;
+  }
+  *pOut++               = 'e';
+  *pOut++               = sciExponent < 0 ? '-' : '+';
+  const int absExponent = sciExponent < 0 ? -sciExponent : sciExponent;
+  std::memcpy(pOut, kDigitPairs + absExponent * 2, 2u);
+  return pOut + 2;
+}
+
+char* formatUnsigned(std::uint64_t value, char* pOut)
+{
+  std::size_t length = 1u;
+  for (std::uint64_t rest = value; rest >= 10u; rest /= 10u)
+  {
+    ++length;
+  }
+  writeDigitsBackwards(value, pOut + length);
+  return pOut + length;
+}
+
+char* formatInteger(std::int64_t value, char* pOut)
+{
+  std::uint64_t magnitude = static_cast<std::uint64_t>(value);
+  if (value < 0)
+  {
+    *pOut++   = '-';
+    // two's complement negation, also valid for the smallest value
+    magnitude = 0u - magnitude;
+  }
+  return formatUnsigned(magnitude, pOut);
+}
+
+} // namespace visionary
@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace visionary {
+
+/// Size of a buffer which holds any number written by formatFloat
+const std::size_t kMaxFloatChars = 16u;
+
+/// Size of a buffer which holds any number written by formatUnsigned or formatInteger
+const std::size_t kMaxIntegerChars = 20u;
+
+/// Write the shortest decimal representation of a float which reads back to the same value.
+///
+/// The output is locale independent, without a terminating zero. Numbers with a decimal exponent in [-4, 9) are
+/// written in fixed notation (e.g. 0.125, -2.25, 3), others in scientific notation (e.g. 1.5e-07, 1e+10).
+/// NaN is written as nan, infinities as inf and -inf.
+///
+/// \param[in]  value the value to be written
+/// \param[out] pOut  buffer of at least kMaxFloatChars characters
+/// \returns pointer behind the last written character
+char* formatFloat(float value, char* pOut);
+
+/// Write an unsigned integer in decimal notation without a terminating zero
+///
+/// \param[in]  value the value to be written
+/// \param[out] pOut  buffer of at least kMaxIntegerChars characters
+/// \returns pointer behind the last written character
+char* formatUnsigned(std::uint64_t value, char* pOut);
+
+/// Write a signed integer in decimal notation without a terminating zero
+///
+/// \param[in]  value the value to be written
+/// \param[out] pOut  buffer of at least kMaxIntegerChars characters
+/// \returns pointer behind the last written character
+char* formatInteger(std::int64_t value, char* pOut);
+
+} // namespace visionary
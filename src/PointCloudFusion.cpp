@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "PointCloudFusion.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace visionary {
+
+void PointCloudFusion::fuse(const std::vector<FusionSensor>& sensors, std::vector<PointXYZ>& pointCloud)
+{
+  pointCloud.resize(prepare(sensors));
+  fuseImpl(sensors, pointCloud.data(), pointCloud.size(), nullptr);
+}
+
+void PointCloudFusion::fuse(const std::vector<FusionSensor>& sensors,
+                            std::vector<PointXYZ>&           pointCloud,
+                            IExecutor&                       executor)
+{
+  pointCloud.resize(prepare(sensors));
+  fuseImpl(sensors, pointCloud.data(), pointCloud.size(), &executor);
+}
+
+std::size_t PointCloudFusion::fuse(const std::vector<FusionSensor>& sensors, PointXYZ* pPoints, std::size_t capacity)
+{
+  prepare(sensors);
+  return fuseImpl(sensors, pPoints, capacity, nullptr);
+}
+
+std::size_t PointCloudFusion::fuse(const std::vector<FusionSensor>& sensors,
+                                   PointXYZ*                        pPoints,
+                                   std::size_t                      capacity,
+                                   IExecutor&                       executor)
+{
+  prepare(sensors);
+  return fuseImpl(sensors, pPoints, capacity, &executor);
+}
+
+const std::vector<std::size_t>& PointCloudFusion::getOffsets() const
+{
+  return m_offsets;
+}
+
+std::size_t PointCloudFusion::prepare(const std::vector<FusionSensor>& sensors)
+{
+  m_offsets.resize(sensors.size() + 1u);
+  m_transforms.resize(sensors.size());
+  m_validators.resize(sensors.size());
+
+  std::size_t numPoints = 0u;
+  for (std::size_t i = 0u; i < sensors.size(); ++i)
+  {
+    const FusionSensor& sensor = sensors[i];
+    assert(sensor.pData != nullptr);
+
+    // the look-up-tables are updated and the validators are set up once here, as they can't be updated concurrently.
+    // A frame without usable points contributes no points.
+    const bool hasPoints = sensor.pData->prepareWorldPoints(m_validators[i]);
+    m_offsets[i]         = numPoints;
+    numPoints += hasPoints ? sensor.pData->getPointCloudSize() : 0u;
+
+    if (sensor.hasExtrinsic)
+    {
+      // turn the translation from [mm] to [m]
+      for (std::size_t row = 0u; row < 3u; ++row)
+      {
+        m_transforms[i].m[row * 4u + 0u] = static_cast<float>(sensor.extrinsic[row * 4u + 0u]);
+        m_transforms[i].m[row * 4u + 1u] = static_cast<float>(sensor.extrinsic[row * 4u + 1u]);
+        m_transforms[i].m[row * 4u + 2u] = static_cast<float>(sensor.extrinsic[row * 4u + 2u]);
+        m_transforms[i].m[row * 4u + 3u] = static_cast<float>(sensor.extrinsic[row * 4u + 3u] / 1000.);
+      }
+    }
+  }
+  m_offsets[sensors.size()] = numPoints;
+  return numPoints;
+}
+
+std::size_t PointCloudFusion::fuseImpl(const std::vector<FusionSensor>& sensors,
+                                       PointXYZ*                        pPoints,
+                                       std::size_t                      capacity,
+                                       IExecutor*                       pExecutor)
+{
+  const std::size_t numPoints = m_offsets.back();
+  if (numPoints > capacity)
+  {
+    return 0u;
+  }
+
+  if (pExecutor == nullptr)
+  {
+    fuseRange(sensors, pPoints, 0u, numPoints);
+  }
+  else
+  {
+    pExecutor->parallelFor(numPoints, [this, &sensors, pPoints](std::size_t begin, std::size_t end) {
+      fuseRange(sensors, pPoints, begin, end);
+    });
+  }
+  return numPoints;
+}
+
+void PointCloudFusion::fuseRange(const std::vector<FusionSensor>& sensors,
+                                 PointXYZ*                        pPoints,
+                                 std::size_t                      begin,
+                                 std::size_t                      end) const
+{
+  // first sensor whose points end after begin
+  std::size_t sensorIndex =
+    static_cast<std::size_t>(std::upper_bound(m_offsets.begin(), m_offsets.end(), begin) - m_offsets.begin()) - 1u;
+
+  for (std::size_t position = begin; position < end; ++sensorIndex)
+  {
+    const std::size_t sensorBegin = m_offsets[sensorIndex];
+    const std::size_t rangeEnd    = std::min(end, m_offsets[sensorIndex + 1u]);
+    if (rangeEnd == position)
+    {
+      continue; // sensor without points
+    }
+
+    PointXYZ* pRange = pPoints + position;
+    sensors[sensorIndex].pData->generateWorldPoints(
+      m_validators[sensorIndex], position - sensorBegin, rangeEnd - sensorBegin, pRange);
+
+    if (sensors[sensorIndex].hasExtrinsic)
+    {
+      // the points are still in the cache, invalid points stay NaN
+      const float* m = m_transforms[sensorIndex].m;
+      for (PointXYZ* it = pRange; it != pPoints + rangeEnd; ++it)
+      {
+        const PointXYZ p = *it;
+        it->x            = m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3];
+        it->y            = m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7];
+        it->z            = m[8] * p.x + m[9] * p.y + m[10] * p.z + m[11];
+      }
+    }
+    position = rangeEnd;
+  }
+}
+
+} // namespace visionary
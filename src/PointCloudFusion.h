@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "IExecutor.h"
+#include "PointXYZ.h"
+#include "VisionaryData.h"
+
+namespace visionary {
+
+/// Frame of one sensor to be fused into the common point cloud
+struct FusionSensor
+{
+  /// Data handler holding the parsed frame of the sensor
+  VisionaryData* pData;
+  /// True if extrinsic is applied to the world points of the sensor
+  bool hasExtrinsic;
+  /// Transformation applied on top of the Cam2World matrix of the sensor, e.g. from the sensor's world frame into the
+  /// common frame. Row major 4x4 matrix with the translation in millimeters like the Cam2World matrix.
+  double extrinsic[4 * 4];
+};
+
+/// \brief Fusion of the world point clouds of several sensors into one point cloud
+///
+/// The points of the sensors are written one after another into a single output buffer, sensor i starting at
+/// getOffsets()[i]. Each point is calculated from the distance map and the world look-up-table of its sensor and
+/// transformed by the extrinsic of the sensor in the same pass, so no intermediate point clouds are needed.
+/// With an executor the points of all sensors are split into ranges which are calculated in parallel.
+///
+/// Matching the frames of the sensors by their timestamps is up to the caller. The data handlers must not receive
+/// new frames while the fusion is running. An instance must not be used by several threads at the same time.
+class PointCloudFusion
+{
+public:
+  /// Fuse the world point clouds of the sensors. Units are in meters.
+  ///
+  /// \param[in]  sensors    frames of the sensors
+  /// \param[out] pointCloud fused point cloud, resized to the total number of points. No memory is allocated if it
+  ///                        already has this size.
+  void fuse(const std::vector<FusionSensor>& sensors, std::vector<PointXYZ>& pointCloud);
+  /// \copydoc fuse(const std::vector<FusionSensor>&, std::vector<PointXYZ>&)
+  /// \param[in] executor executor calculating ranges of points in parallel
+  void fuse(const std::vector<FusionSensor>& sensors, std::vector<PointXYZ>& pointCloud, IExecutor& executor);
+
+  /// Fuse the world point clouds of the sensors into a buffer of the caller. Units are in meters.
+  ///
+  /// \param[in]  sensors  frames of the sensors
+  /// \param[out] pPoints  buffer receiving the fused point cloud
+  /// \param[in]  capacity number of points fitting into the buffer
+  /// \returns the number of points written, 0 if they don't fit into the buffer
+  std::size_t fuse(const std::vector<FusionSensor>& sensors, PointXYZ* pPoints, std::size_t capacity);
+  /// \copydoc fuse(const std::vector<FusionSensor>&, PointXYZ*, std::size_t)
+  /// \param[in] executor executor calculating ranges of points in parallel
+  std::size_t
+  fuse(const std::vector<FusionSensor>& sensors, PointXYZ* pPoints, std::size_t capacity, IExecutor& executor);
+
+  /// Returns the offset of the points of each sensor in the fused point cloud and the total number of points as last
+  /// element, as of the last call of fuse
+  const std::vector<std::size_t>& getOffsets() const;
+
+private:
+  // Update the look-up-tables, pixel validators and extrinsics of the sensors and calculate the offsets.
+  // Returns the total number of points.
+  std::size_t prepare(const std::vector<FusionSensor>& sensors);
+
+  std::size_t fuseImpl(const std::vector<FusionSensor>& sensors,
+                       PointXYZ*                        pPoints,
+                       std::size_t                      capacity,
+                       IExecutor*                       pExecutor);
+
+  // Calculate the points [begin, end) of the fused point cloud
+  void fuseRange(const std::vector<FusionSensor>& sensors, PointXYZ* pPoints, std::size_t begin, std::size_t end) const;
+
+  // Extrinsic of each sensor as 3x4 matrix with the translation in meters
+  struct Transform
+  {
+    float m[3 * 4];
+  };
+
+  std::vector<std::size_t>                   m_offsets;
+  std::vector<Transform>                     m_transforms;
+  std::vector<VisionaryData::PixelValidator> m_validators;
+};
+
+} // namespace visionary
@@ -0,0 +1,566 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "PointCloudPcdWriter.h"
+
+#include "FileStream.h"
+#include "LzfCompression.h"
+#include "NumberFormat.h"
+#include "PositionalFileWriter.h"
+#include "VisionaryEndian.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <locale>
+#include <numeric>
+#include <sstream>
+#include <string>
+
+namespace visionary {
+
+namespace {
+// Number of points whose binary records are assembled in one chunk before they are written
+const size_t kChunkPoints = 1u << 16u;
+
+// Field written after the coordinates
+enum ExtraField
+{
+  EXTRA_NONE,
+  EXTRA_RGB,
+  EXTRA_INTENSITY
+};
+
+// Value of the extra field of point i as little endian bits
+uint32_t extraFieldValue(ExtraField extra, const uint32_t* pRgba, const uint16_t* pIntensity, size_t i)
+{
+  uint32_t value = 0u;
+  if (extra == EXTRA_RGB)
+  {
+    // the first 3 bytes of the RGBA value in memory order are red, green and blue
+    uint8_t rgba[4];
+    std::memcpy(rgba, &pRgba[i], sizeof(rgba));
+    value = (static_cast<uint32_t>(rgba[0]) << 16u) | (static_cast<uint32_t>(rgba[1]) << 8u) | rgba[2];
+  }
+  else if (extra == EXTRA_INTENSITY)
+  {
+    const float intensity = static_cast<float>(pIntensity[i]) / 65535.0f;
+    std::memcpy(&value, &intensity, sizeof(value));
+  }
+  return nativeToLittleEndian(value);
+}
+
+// Assemble the records of the points [begin, end) into pOut, returns the number of bytes written.
+// Unorganized clouds skip the invalid points.
+size_t encodeBinaryChunk(const std::vector<PointXYZ>& points,
+                         const uint32_t*              pRgba,
+                         const uint16_t*              pIntensity,
+                         ExtraField                   extra,
+                         bool                         organized,
+                         size_t                       begin,
+                         size_t                       end,
+                         char*                        pOut)
+{
+  char* pRecord = pOut;
+  for (size_t i = begin; i < end; ++i)
+  {
+    const PointXYZ& point = points[i];
+    if (!organized && std::isnan(point.z))
+    {
+      continue;
+    }
+    const float coordinates[3] = {
+      nativeToLittleEndian(point.x), nativeToLittleEndian(point.y), nativeToLittleEndian(point.z)};
+    std::memcpy(pRecord, coordinates, sizeof(coordinates));
+    pRecord += sizeof(coordinates);
+    if (extra != EXTRA_NONE)
+    {
+      const uint32_t value = extraFieldValue(extra, pRgba, pIntensity, i);
+      std::memcpy(pRecord, &value, sizeof(value));
+      pRecord += sizeof(value);
+    }
+  }
+  return static_cast<size_t>(pRecord - pOut);
+}
+
+// Store the fields one after the other (all x, all y, all z, all extra values) as needed for binary_compressed.
+// The points [begin, end) are stored from index firstIndex on, pFields has room for numPoints points.
+void encodeFields(const std::vector<PointXYZ>& points,
+                  const uint32_t*              pRgba,
+                  const uint16_t*              pIntensity,
+                  ExtraField                   extra,
+                  bool                         organized,
+                  size_t                       numPoints,
+                  size_t                       begin,
+                  size_t                       end,
+                  size_t                       firstIndex,
+                  uint8_t*                     pFields)
+{
+  uint8_t* pX     = pFields;
+  uint8_t* pY     = pX + numPoints * sizeof(float);
+  uint8_t* pZ     = pY + numPoints * sizeof(float);
+  uint8_t* pExtra = pZ + numPoints * sizeof(float);
+
+  size_t index = firstIndex;
+  for (size_t i = begin; i < end; ++i)
+  {
+    const PointXYZ& point = points[i];
+    if (!organized && std::isnan(point.z))
+    {
+      continue;
+    }
+    const size_t offset = index * sizeof(float);
+    const float  x      = nativeToLittleEndian(point.x);
+    const float  y      = nativeToLittleEndian(point.y);
+    const float  z      = nativeToLittleEndian(point.z);
+    std::memcpy(pX + offset, &x, sizeof(x));
+    std::memcpy(pY + offset, &y, sizeof(y));
+    std::memcpy(pZ + offset, &z, sizeof(z));
+    if (extra != EXTRA_NONE)
+    {
+      const uint32_t value = extraFieldValue(extra, pRgba, pIntensity, i);
+      std::memcpy(pExtra + offset, &value, sizeof(value));
+    }
+    ++index;
+  }
+}
+
+// Lines of the header from WIDTH to DATA
+void writeHeaderShape(std::ostream& stream, PcdEncoding encoding, size_t width, size_t height, size_t numberOfPoints)
+{
+  stream << "WIDTH " << width << "\n";
+  stream << "HEIGHT " << height << "\n";
+  stream << "VIEWPOINT 0 0 0 1 0 0 0\n";
+  stream << "POINTS " << numberOfPoints << "\n";
+  stream << "DATA " << ((encoding == PCD_BINARY_COMPRESSED) ? "binary_compressed" : "binary") << "\n";
+}
+
+void writeHeader(std::ostream& stream,
+                 ExtraField    extra,
+                 PcdEncoding   encoding,
+                 size_t        width,
+                 size_t        height,
+                 size_t        numberOfPoints)
+{
+  stream << "# .PCD v0.7 - Point Cloud Data file format\n";
+  stream << "VERSION 0.7\n";
+  if (extra == EXTRA_NONE)
+  {
+    stream << "FIELDS x y z\nSIZE 4 4 4\nTYPE F F F\nCOUNT 1 1 1\n";
+  }
+  else
+  {
+    stream << "FIELDS x y z " << ((extra == EXTRA_RGB) ? "rgb" : "intensity") << "\n";
+    stream << "SIZE 4 4 4 4\n";
+    stream << "TYPE F F F " << ((extra == EXTRA_RGB) ? "U" : "F") << "\n";
+    stream << "COUNT 1 1 1 1\n";
+  }
+  writeHeaderShape(stream, encoding, width, height, numberOfPoints);
+}
+
+// Number of points of each chunk of kChunkPoints points which are written, unorganized clouds skip the invalid points
+void countChunkPoints(const std::vector<PointXYZ>& points,
+                      bool                         organized,
+                      IExecutor&                   executor,
+                      std::vector<size_t>&         numChunkPoints)
+{
+  numChunkPoints.resize((points.size() + kChunkPoints - 1u) / kChunkPoints);
+  executor.parallelFor(numChunkPoints.size(), [&](size_t beginChunk, size_t endChunk) {
+    for (size_t chunk = beginChunk; chunk < endChunk; ++chunk)
+    {
+      const size_t begin = chunk * kChunkPoints;
+      const size_t end   = std::min(points.size(), begin + kChunkPoints);
+      if (organized)
+      {
+        numChunkPoints[chunk] = end - begin;
+      }
+      else
+      {
+        numChunkPoints[chunk] = static_cast<size_t>(
+          std::count_if(points.begin() + static_cast<std::ptrdiff_t>(begin),
+                        points.begin() + static_cast<std::ptrdiff_t>(end),
+                        [](const PointXYZ& point) { return !std::isnan(point.z); }));
+      }
+    }
+  });
+}
+
+// Encode the chunks in parallel and write them behind the header. Binary records have a fixed size, so the offset
+// of each chunk is known before the encoding and every worker writes its chunks as soon as they are encoded. The
+// compressed data is one LZF block, only the fields are assembled in parallel.
+bool writeParallel(PositionalFileWriter&        file,
+                   const std::string&           header,
+                   const std::vector<PointXYZ>& points,
+                   const std::vector<size_t>&   numChunkPoints,
+                   const uint32_t*              pRgba,
+                   const uint16_t*              pIntensity,
+                   ExtraField                   extra,
+                   bool                         organized,
+                   PcdEncoding                  encoding,
+                   IExecutor&                   executor)
+{
+  const size_t recordSize = ((extra == EXTRA_NONE) ? 3u : 4u) * sizeof(float);
+
+  // index of the first point of each chunk in the file
+  std::vector<size_t> chunkIndices(numChunkPoints.size());
+  size_t              numberOfPoints = 0u;
+  for (size_t chunk = 0u; chunk < numChunkPoints.size(); ++chunk)
+  {
+    chunkIndices[chunk] = numberOfPoints;
+    numberOfPoints += numChunkPoints[chunk];
+  }
+
+  if (encoding == PCD_BINARY_COMPRESSED)
+  {
+    std::vector<uint8_t> fields(numberOfPoints * recordSize);
+    executor.parallelFor(numChunkPoints.size(), [&](size_t beginChunk, size_t endChunk) {
+      for (size_t chunk = beginChunk; chunk < endChunk; ++chunk)
+      {
+        const size_t begin = chunk * kChunkPoints;
+        const size_t end   = std::min(points.size(), begin + kChunkPoints);
+        encodeFields(
+          points, pRgba, pIntensity, extra, organized, numberOfPoints, begin, end, chunkIndices[chunk], fields.data());
+      }
+    });
+    std::vector<uint8_t> compressed;
+    lzfCompress(fields.data(), fields.size(), compressed);
+
+    uint8_t sizes[8];
+    writeUnalignLittleEndian<uint32_t>(sizes, 4u, static_cast<uint32_t>(compressed.size()));
+    writeUnalignLittleEndian<uint32_t>(sizes + 4u, 4u, static_cast<uint32_t>(fields.size()));
+    const WriteBuffer buffers[3] = {{header.data(), header.size()},
+                                    {reinterpret_cast<const char*>(sizes), sizeof(sizes)},
+                                    {reinterpret_cast<const char*>(compressed.data()), compressed.size()}};
+    return file.writeAt(0u, buffers, 3u);
+  }
+
+  const WriteBuffer headerBuffer = {header.data(), header.size()};
+  if (!file.writeAt(0u, &headerBuffer, 1u))
+  {
+    return false;
+  }
+  std::atomic<bool> success(true);
+  executor.parallelFor(numChunkPoints.size(), [&](size_t beginChunk, size_t endChunk) {
+    std::vector<char> buffer(kChunkPoints * recordSize);
+    for (size_t chunk = beginChunk; chunk < endChunk && success; ++chunk)
+    {
+      const size_t      begin       = chunk * kChunkPoints;
+      const size_t      end         = std::min(points.size(), begin + kChunkPoints);
+      const WriteBuffer writeBuffer = {
+        buffer.data(), encodeBinaryChunk(points, pRgba, pIntensity, extra, organized, begin, end, buffer.data())};
+      const std::uint64_t offset = header.size() + static_cast<std::uint64_t>(chunkIndices[chunk]) * recordSize;
+      if (!file.writeAt(offset, &writeBuffer, 1u))
+      {
+        success = false;
+      }
+    }
+  });
+  return success;
+}
+
+bool writePCD(const char*                  filename,
+              const std::vector<PointXYZ>& points,
+              const uint32_t*              pRgba,
+              const uint16_t*              pIntensity,
+              ExtraField                   extra,
+              PcdEncoding                  encoding,
+              int                          organizedWidth,
+              IExecutor*                   pExecutor)
+{
+  const bool organized = organizedWidth > 0;
+  if (organizedWidth < 0 || (organized && points.size() % static_cast<size_t>(organizedWidth) != 0u))
+  {
+    return false;
+  }
+
+  std::vector<size_t> numChunkPoints;
+  size_t              numberOfPoints = points.size();
+  if (pExecutor != nullptr)
+  {
+    countChunkPoints(points, organized, *pExecutor, numChunkPoints);
+    numberOfPoints = std::accumulate(numChunkPoints.begin(), numChunkPoints.end(), size_t{0u});
+  }
+  else if (!organized)
+  {
+    numberOfPoints = static_cast<size_t>(
+      std::count_if(points.begin(), points.end(), [](const PointXYZ& point) { return !std::isnan(point.z); }));
+  }
+  const size_t width  = organized ? static_cast<size_t>(organizedWidth) : numberOfPoints;
+  const size_t height = organized ? points.size() / width : 1u;
+
+  if (pExecutor != nullptr)
+  {
+    std::ostringstream header;
+    header.imbue(std::locale::classic());
+    writeHeader(header, extra, encoding, width, height, numberOfPoints);
+
+    PositionalFileWriter file;
+    if (!file.open(filename))
+    {
+      return false;
+    }
+    const bool success = writeParallel(
+      file, header.str(), points, numChunkPoints, pRgba, pIntensity, extra, organized, encoding, *pExecutor);
+    return file.close() && success;
+  }
+
+  std::ofstream     stream;
+  std::vector<char> streamBuffer;
+  if (!openFileStream(stream, streamBuffer, filename, true))
+  {
+    return false;
+  }
+
+  writeHeader(stream, extra, encoding, width, height, numberOfPoints);
+
+  if (encoding == PCD_BINARY_COMPRESSED)
+  {
+    // the compression works on the whole data part, so it can't be streamed in chunks
+    std::vector<uint8_t> fields(numberOfPoints * ((extra == EXTRA_NONE) ? 3u : 4u) * sizeof(float));
+    std::vector<uint8_t> compressed;
+    encodeFields(points, pRgba, pIntensity, extra, organized, numberOfPoints, 0u, points.size(), 0u, fields.data());
+    lzfCompress(fields.data(), fields.size(), compressed);
+
+    // compressed and uncompressed size followed by the compressed data
+    uint8_t sizes[8];
+    writeUnalignLittleEndian<uint32_t>(sizes, 4u, static_cast<uint32_t>(compressed.size()));
+    writeUnalignLittleEndian<uint32_t>(sizes + 4u, 4u, static_cast<uint32_t>(fields.size()));
+    stream.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    stream.write(reinterpret_cast<const char*>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+  }
+  else
+  {
+    const size_t      recordSize = ((extra == EXTRA_NONE) ? 3u : 4u) * sizeof(float);
+    std::vector<char> chunk(std::min(points.size(), kChunkPoints) * recordSize);
+    for (size_t begin = 0u; begin < points.size() && stream; begin += kChunkPoints)
+    {
+      const size_t end = std::min(points.size(), begin + kChunkPoints);
+      const size_t numBytes =
+        encodeBinaryChunk(points, pRgba, pIntensity, extra, organized, begin, end, chunk.data());
+      stream.write(chunk.data(), static_cast<std::streamsize>(numBytes));
+    }
+  }
+
+  stream.close();
+  return !stream.fail();
+}
+// Assemble the records of the fixed point coordinates of the points [begin, end) into pOut, returns the number of
+// bytes written. Every record is written and kept by advancing the position, so unorganized clouds skip the invalid
+// points without branches; pOut has room for the records of all points of the range.
+template <typename T>
+size_t encodeQuantizedChunk(const std::vector<QuantizedPointXYZ<T>>& points,
+                            bool                                     organized,
+                            size_t                                   begin,
+                            size_t                                   end,
+                            char*                                    pOut)
+{
+  char* pRecord = pOut;
+  for (size_t i = begin; i < end; ++i)
+  {
+    const QuantizedPointXYZ<T>& point          = points[i];
+    const T                     coordinates[3] = {
+      nativeToLittleEndian(point.x), nativeToLittleEndian(point.y), nativeToLittleEndian(point.z)};
+    std::memcpy(pRecord, coordinates, sizeof(coordinates));
+    pRecord += (organized || point.isValid()) ? sizeof(coordinates) : 0u;
+  }
+  return static_cast<size_t>(pRecord - pOut);
+}
+
+// Store the fixed point fields one after the other (all x, all y, all z) as needed for binary_compressed.
+// pFields has room for numPoints points.
+template <typename T>
+void encodeQuantizedFields(const std::vector<QuantizedPointXYZ<T>>& points,
+                           bool                                     organized,
+                           size_t                                   numPoints,
+                           uint8_t*                                 pFields)
+{
+  uint8_t* pX = pFields;
+  uint8_t* pY = pX + numPoints * sizeof(T);
+  uint8_t* pZ = pY + numPoints * sizeof(T);
+
+  size_t index = 0u;
+  for (const QuantizedPointXYZ<T>& point : points)
+  {
+    if (!organized && !point.isValid())
+    {
+      continue;
+    }
+    const size_t offset = index * sizeof(T);
+    const T      x      = nativeToLittleEndian(point.x);
+    const T      y      = nativeToLittleEndian(point.y);
+    const T      z      = nativeToLittleEndian(point.z);
+    std::memcpy(pX + offset, &x, sizeof(x));
+    std::memcpy(pY + offset, &y, sizeof(y));
+    std::memcpy(pZ + offset, &z, sizeof(z));
+    ++index;
+  }
+}
+
+template <typename T>
+bool writeQuantizedPCD(const char*                              filename,
+                       const std::vector<QuantizedPointXYZ<T>>& points,
+                       float                                    scale,
+                       PcdEncoding                              encoding,
+                       int                                      organizedWidth)
+{
+  const bool organized = organizedWidth > 0;
+  if (organizedWidth < 0 || (organized && points.size() % static_cast<size_t>(organizedWidth) != 0u))
+  {
+    return false;
+  }
+
+  size_t numberOfPoints = points.size();
+  if (!organized)
+  {
+    numberOfPoints = static_cast<size_t>(
+      std::count_if(points.begin(), points.end(), [](const QuantizedPointXYZ<T>& point) { return point.isValid(); }));
+  }
+  const size_t width  = organized ? static_cast<size_t>(organizedWidth) : numberOfPoints;
+  const size_t height = organized ? points.size() / width : 1u;
+
+  std::ofstream     stream;
+  std::vector<char> streamBuffer;
+  if (!openFileStream(stream, streamBuffer, filename, true))
+  {
+    return false;
+  }
+
+  // the scale is a comment, so readers which don't know it still read the integer coordinates
+  char        scaleChars[kMaxFloatChars];
+  const char* pScaleEnd = formatFloat(scale, scaleChars);
+  stream << "# .PCD v0.7 - Point Cloud Data file format\n";
+  stream << "# scale ";
+  stream.write(scaleChars, pScaleEnd - scaleChars);
+  stream << "\n";
+  stream << "VERSION 0.7\n";
+  stream << "FIELDS x y z\n";
+  stream << "SIZE " << sizeof(T) << " " << sizeof(T) << " " << sizeof(T) << "\n";
+  stream << "TYPE I I I\nCOUNT 1 1 1\n";
+  writeHeaderShape(stream, encoding, width, height, numberOfPoints);
+
+  const size_t recordSize = 3u * sizeof(T);
+  if (encoding == PCD_BINARY_COMPRESSED)
+  {
+    std::vector<uint8_t> fields(numberOfPoints * recordSize);
+    std::vector<uint8_t> compressed;
+    encodeQuantizedFields(points, organized, numberOfPoints, fields.data());
+    lzfCompress(fields.data(), fields.size(), compressed);
+
+    uint8_t sizes[8];
+    writeUnalignLittleEndian<uint32_t>(sizes, 4u, static_cast<uint32_t>(compressed.size()));
+    writeUnalignLittleEndian<uint32_t>(sizes + 4u, 4u, static_cast<uint32_t>(fields.size()));
+    stream.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    stream.write(reinterpret_cast<const char*>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+  }
+  else
+  {
+    std::vector<char> chunk(std::min(points.size(), kChunkPoints) * recordSize);
+    for (size_t begin = 0u; begin < points.size() && stream; begin += kChunkPoints)
+    {
+      const size_t end      = std::min(points.size(), begin + kChunkPoints);
+      const size_t numBytes = encodeQuantizedChunk(points, organized, begin, end, chunk.data());
+      stream.write(chunk.data(), static_cast<std::streamsize>(numBytes));
+    }
+  }
+
+  stream.close();
+  return !stream.fail();
+}
+} // namespace
+
+bool PointCloudPcdWriter::WriteFormatPCD(const char*                  filename,
+                                         const std::vector<PointXYZ>& points,
+                                         PcdEncoding                  encoding,
+                                         int                          organizedWidth)
+{
+  return writePCD(filename, points, nullptr, nullptr, EXTRA_NONE, encoding, organizedWidth, nullptr);
+}
+
+bool PointCloudPcdWriter::WriteFormatPCD(const char*                  filename,
+                                         const std::vector<PointXYZ>& points,
+                                         const std::vector<uint32_t>& rgbaMap,
+                                         PcdEncoding                  encoding,
+                                         int                          organizedWidth)
+{
+  if (rgbaMap.size() != points.size())
+  {
+    return false;
+  }
+  return writePCD(filename, points, rgbaMap.data(), nullptr, EXTRA_RGB, encoding, organizedWidth, nullptr);
+}
+
+bool PointCloudPcdWriter::WriteFormatPCD(const char*                  filename,
+                                         const std::vector<PointXYZ>& points,
+                                         const std::vector<uint16_t>& intensityMap,
+                                         PcdEncoding                  encoding,
+                                         int                          organizedWidth)
+{
+  if (intensityMap.size() != points.size())
+  {
+    return false;
+  }
+  return writePCD(filename, points, nullptr, intensityMap.data(), EXTRA_INTENSITY, encoding, organizedWidth, nullptr);
+}
+
+bool PointCloudPcdWriter::WriteFormatPCD(const char*                  filename,
+                                         const std::vector<PointXYZ>& points,
+                                         PcdEncoding                  encoding,
+                                         int                          organizedWidth,
+                                         IExecutor&                   executor)
+{
+  return writePCD(filename, points, nullptr, nullptr, EXTRA_NONE, encoding, organizedWidth, &executor);
+}
+
+bool PointCloudPcdWriter::WriteFormatPCD(const char*                  filename,
+                                         const std::vector<PointXYZ>& points,
+                                         const std::vector<uint32_t>& rgbaMap,
+                                         PcdEncoding                  encoding,
+                                         int                          organizedWidth,
+                                         IExecutor&                   executor)
+{
+  if (rgbaMap.size() != points.size())
+  {
+    return false;
+  }
+  return writePCD(filename, points, rgbaMap.data(), nullptr, EXTRA_RGB, encoding, organizedWidth, &executor);
+}
+
+bool PointCloudPcdWriter::WriteFormatPCD(const char*                  filename,
+                                         const std::vector<PointXYZ>& points,
+                                         const std::vector<uint16_t>& intensityMap,
+                                         PcdEncoding                  encoding,
+                                         int                          organizedWidth,
+                                         IExecutor&                   executor)
+{
+  if (intensityMap.size() != points.size())
+  {
+    return false;
+  }
+  return writePCD(filename, points, nullptr, intensityMap.data(), EXTRA_INTENSITY, encoding, organizedWidth, &executor);
+}
+
+bool PointCloudPcdWriter::WriteFormatPCD(const char*                             filename,
+                                         const std::vector<QuantizedPointXYZ16>& points,
+                                         float                                   scale,
+                                         PcdEncoding                             encoding,
+                                         int                                     organizedWidth)
+{
+  return writeQuantizedPCD(filename, points, scale, encoding, organizedWidth);
+}
+
+bool PointCloudPcdWriter::WriteFormatPCD(const char*                             filename,
+                                         const std::vector<QuantizedPointXYZ32>& points,
+                                         float                                   scale,
+                                         PcdEncoding                             encoding,
+                                         int                                     organizedWidth)
+{
+  return writeQuantizedPCD(filename, points, scale, encoding, organizedWidth);
+}
+
+PointCloudPcdWriter::PointCloudPcdWriter() = default;
+
+PointCloudPcdWriter::~PointCloudPcdWriter() = default;
+} // namespace visionary
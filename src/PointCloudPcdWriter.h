@@ -0,0 +1,145 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "IExecutor.h"
+#include "PointXYZ.h"
+#include "QuantizedPointXYZ.h"
+
+namespace visionary {
+
+enum PcdEncoding
+{
+  /// Points as binary records (DATA binary)
+  PCD_BINARY = 0,
+
+  /// Fields stored one after the other and LZF compressed (DATA binary_compressed)
+  PCD_BINARY_COMPRESSED = 1
+};
+
+/// <summary>Class for writing point clouds to PCD files of the Point Cloud Library.</summary>
+///
+/// Organized clouds keep all points with NaN coordinates for invalid points, their width is usually the width of the
+/// image the points were generated from. Unorganized clouds only contain the valid points.
+/// Colors are written as field "rgb" (packed 0x00RRGGBB, type U), intensities as field "intensity" (type F) normalized
+/// to [0, 1] like in the PLY files.
+class PointCloudPcdWriter
+{
+public:
+  PointCloudPcdWriter(const PointCloudPcdWriter&)                  = delete;
+  const PointCloudPcdWriter& operator=(const PointCloudPcdWriter&) = delete;
+
+  /// <summary>Save a point cloud to a file in Point Cloud Data format (PCD), see:
+  /// https://pointclouds.org/documentation/tutorials/pcd_file_format.html </summary>
+  /// <param name="filename">The file to save the point cloud to</param> <param name="points">The points to
+  /// save</param> <param name="encoding">Binary or LZF compressed binary data</param> <param
+  /// name="organizedWidth">Width of an organized cloud, points.size() must be a multiple of it. 0 writes an
+  /// unorganized cloud without the invalid points [optional]</param> <returns>Returns true if write was successful
+  /// and false otherwise</returns>
+  static bool WriteFormatPCD(const char*                  filename,
+                             const std::vector<PointXYZ>& points,
+                             PcdEncoding                  encoding,
+                             int                          organizedWidth = 0);
+
+  /// <summary>Save a point cloud to a file in Point Cloud Data format (PCD) which has colors for each point</summary>
+  /// <param name="filename">The file to save the point cloud to</param> <param name="points">The points to
+  /// save</param> <param name="rgbaMap">RGBA colors for each point, must be same length as points</param> <param
+  /// name="encoding">Binary or LZF compressed binary data</param> <param name="organizedWidth">Width of an organized
+  /// cloud, 0 writes an unorganized cloud [optional]</param> <returns>Returns true if write was successful and false
+  /// otherwise</returns>
+  static bool WriteFormatPCD(const char*                  filename,
+                             const std::vector<PointXYZ>& points,
+                             const std::vector<uint32_t>& rgbaMap,
+                             PcdEncoding                  encoding,
+                             int                          organizedWidth = 0);
+
+  /// <summary>Save a point cloud to a file in Point Cloud Data format (PCD) which has intensities for each
+  /// point</summary> <param name="filename">The file to save the point cloud to</param> <param name="points">The
+  /// points to save</param> <param name="intensityMap">Intensities for each point, must be same length as
+  /// points</param> <param name="encoding">Binary or LZF compressed binary data</param> <param
+  /// name="organizedWidth">Width of an organized cloud, 0 writes an unorganized cloud [optional]</param>
+  /// <returns>Returns true if write was successful and false otherwise</returns>
+  static bool WriteFormatPCD(const char*                  filename,
+                             const std::vector<PointXYZ>& points,
+                             const std::vector<uint16_t>& intensityMap,
+                             PcdEncoding                  encoding,
+                             int                          organizedWidth = 0);
+
+  /// <summary>Save a point cloud to a file in Point Cloud Data format (PCD), encoding chunks of the points in
+  /// parallel. Binary chunks are written at their precomputed file offsets by the workers; for compressed data the
+  /// fields are assembled in parallel and compressed as one block.</summary> <param name="filename">The file to save
+  /// the point cloud to</param> <param name="points">The points to save</param> <param name="encoding">Binary or LZF
+  /// compressed binary data</param> <param name="organizedWidth">Width of an organized cloud, 0 writes an
+  /// unorganized cloud</param> <param name="executor">Executor encoding the chunks, e.g. a ThreadPool with the number
+  /// of threads to use</param> <returns>Returns true if write was successful and false otherwise</returns>
+  static bool WriteFormatPCD(const char*                  filename,
+                             const std::vector<PointXYZ>& points,
+                             PcdEncoding                  encoding,
+                             int                          organizedWidth,
+                             IExecutor&                   executor);
+
+  /// <summary>Save a point cloud with colors to a PCD file, encoding chunks of the points in parallel</summary>
+  /// <param name="filename">The file to save the point cloud to</param> <param name="points">The points to
+  /// save</param> <param name="rgbaMap">RGBA colors for each point, must be same length as points</param> <param
+  /// name="encoding">Binary or LZF compressed binary data</param> <param name="organizedWidth">Width of an organized
+  /// cloud, 0 writes an unorganized cloud</param> <param name="executor">Executor encoding the chunks</param>
+  /// <returns>Returns true if write was successful and false otherwise</returns>
+  static bool WriteFormatPCD(const char*                  filename,
+                             const std::vector<PointXYZ>& points,
+                             const std::vector<uint32_t>& rgbaMap,
+                             PcdEncoding                  encoding,
+                             int                          organizedWidth,
+                             IExecutor&                   executor);
+
+  /// <summary>Save a point cloud with intensities to a PCD file, encoding chunks of the points in parallel</summary>
+  /// <param name="filename">The file to save the point cloud to</param> <param name="points">The points to
+  /// save</param> <param name="intensityMap">Intensities for each point, must be same length as points</param>
+  /// <param name="encoding">Binary or LZF compressed binary data</param> <param name="organizedWidth">Width of an
+  /// organized cloud, 0 writes an unorganized cloud</param> <param name="executor">Executor encoding the
+  /// chunks</param> <returns>Returns true if write was successful and false otherwise</returns>
+  static bool WriteFormatPCD(const char*                  filename,
+                             const std::vector<PointXYZ>& points,
+                             const std::vector<uint16_t>& intensityMap,
+                             PcdEncoding                  encoding,
+                             int                          organizedWidth,
+                             IExecutor&                   executor);
+
+  /// <summary>Save a point cloud with fixed point coordinates to a PCD file. The coordinates are written as 16 bit
+  /// integers (TYPE I, SIZE 2), the scale is stored as comment "# scale" in the header.</summary> <param
+  /// name="filename">The file to save the point cloud to</param> <param name="points">The points to save</param>
+  /// <param name="scale">Size of one coordinate unit in meters</param> <param name="encoding">Binary or LZF
+  /// compressed binary data</param> <param name="organizedWidth">Width of an organized cloud, invalid points keep
+  /// their invalid marker value. 0 writes an unorganized cloud without the invalid points [optional]</param>
+  /// <returns>Returns true if write was successful and false otherwise</returns>
+  static bool WriteFormatPCD(const char*                             filename,
+                             const std::vector<QuantizedPointXYZ16>& points,
+                             float                                   scale,
+                             PcdEncoding                             encoding,
+                             int                                     organizedWidth = 0);
+
+  /// <summary>Save a point cloud with fixed point coordinates to a PCD file. The coordinates are written as 32 bit
+  /// integers (TYPE I, SIZE 4), the scale is stored as comment "# scale" in the header.</summary> <param
+  /// name="filename">The file to save the point cloud to</param> <param name="points">The points to save</param>
+  /// <param name="scale">Size of one coordinate unit in meters</param> <param name="encoding">Binary or LZF
+  /// compressed binary data</param> <param name="organizedWidth">Width of an organized cloud, invalid points keep
+  /// their invalid marker value. 0 writes an unorganized cloud without the invalid points [optional]</param>
+  /// <returns>Returns true if write was successful and false otherwise</returns>
+  static bool WriteFormatPCD(const char*                             filename,
+                             const std::vector<QuantizedPointXYZ32>& points,
+                             float                                   scale,
+                             PcdEncoding                             encoding,
+                             int                                     organizedWidth = 0);
+
+private:
+  // No instantiations
+  PointCloudPcdWriter();
+  virtual ~PointCloudPcdWriter();
+};
+
+} // namespace visionary
@@ -0,0 +1,616 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "PointCloudPlyReader.h"
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include "VisionaryEndian.h"
+
+namespace visionary {
+
+namespace {
+const char kEndHeader[] = "end_header";
+
+bool isSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Parse a number of an ASCII PLY file independent of the locale, including nan and inf.
+// Returns false if there is no number before pEnd.
+bool parseNumber(const char*& p, const char* pEnd, double& value)
+{
+  while (p != pEnd && isSpace(*p))
+  {
+    ++p;
+  }
+  const char* pBegin     = p;
+  const bool  isNegative = (p != pEnd && *p == '-');
+  if (p != pEnd && (*p == '-' || *p == '+'))
+  {
+    ++p;
+  }
+
+  if (p != pEnd && (*p == 'n' || *p == 'N' || *p == 'i' || *p == 'I'))
+  {
+    const bool isNan = (*p == 'n' || *p == 'N');
+    while (p != pEnd && !isSpace(*p))
+    {
+      ++p;
+    }
+    value = isNan ? std::numeric_limits<double>::quiet_NaN() : std::numeric_limits<double>::infinity();
+    value = isNegative ? -value : value;
+    return true;
+  }
+
+  // up to 19 significant digits fit into the mantissa, further digits only shift the exponent
+  std::uint64_t mantissa  = 0u;
+  int           exponent  = 0;
+  int           numDigits = 0;
+  bool          hasDigits = false;
+  for (; p != pEnd && *p >= '0' && *p <= '9'; ++p)
+  {
+    hasDigits = true;
+    if (numDigits < 19)
+    {
+      mantissa = mantissa * 10u + static_cast<std::uint64_t>(*p - '0');
+      numDigits += (mantissa != 0u) ? 1 : 0;
+    }
+    else
+    {
+      ++exponent;
+    }
+  }
+  if (p != pEnd && *p == '.')
+  {
+    for (++p; p != pEnd && *p >= '0' && *p <= '9'; ++p)
+    {
+      hasDigits = true;
+      if (numDigits < 19)
+      {
+        mantissa = mantissa * 10u + static_cast<std::uint64_t>(*p - '0');
+        numDigits += (mantissa != 0u) ? 1 : 0;
+        --exponent;
+      }
+    }
+  }
+  if (!hasDigits)
+  {
+    p = pBegin;
+    return false;
+  }
+  if (p != pEnd && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    const bool isNegativeExponent = (p != pEnd && *p == '-');
+    if (p != pEnd && (*p == '-' || *p == '+'))
+    {
+      ++p;
+    }
+    int exponentValue = 0;
+    for (; p != pEnd && *p >= '0' && *p <= '9'; ++p)
+    {
+      exponentValue = std::min(exponentValue * 10 + (*p - '0'), 10000);
+    }
+    exponent += isNegativeExponent ? -exponentValue : exponentValue;
+  }
+
+  // powers of 10 up to 1e22 are exact doubles
+  static const double kPowers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const double        base      = static_cast<double>(mantissa);
+  if (exponent >= 0 && exponent <= 22)
+  {
+    value = base * kPowers[exponent];
+  }
+  else if (exponent < 0 && exponent >= -22)
+  {
+    value = base / kPowers[-exponent];
+  }
+  else
+  {
+    value = base * std::pow(10., exponent);
+  }
+  value = isNegative ? -value : value;
+  return p == pEnd || isSpace(*p);
+}
+
+// Convert a normalized intensity back to the 16 bit range
+uint16_t toIntensity(double value)
+{
+  return static_cast<uint16_t>(std::min(std::max(value * 65535. + 0.5, 0.), 65535.));
+}
+
+// Set color channel (0 = red, 1 = green, 2 = blue) of an RGBA value
+void setColorChannel(uint32_t& rgba, std::size_t channel, double value)
+{
+  uint8_t bytes[4];
+  std::memcpy(bytes, &rgba, sizeof(bytes));
+  bytes[channel] = static_cast<uint8_t>(std::min(std::max(value, 0.), 255.));
+  std::memcpy(&rgba, bytes, sizeof(bytes));
+}
+
+uint32_t opaqueBlack()
+{
+  const uint8_t bytes[4] = {0u, 0u, 0u, 0xFFu};
+  uint32_t      rgba     = 0u;
+  std::memcpy(&rgba, bytes, sizeof(bytes));
+  return rgba;
+}
+} // namespace
+
+PointCloudPlyReader::PointCloudPlyReader()
+  : m_pFile(nullptr)
+  , m_fileSize(0u)
+  , m_isBinary(false)
+  , m_dataOffset(0u)
+  , m_numPoints(0u)
+  , m_stride(0u)
+  , m_pPoints(nullptr)
+{
+}
+
+PointCloudPlyReader::~PointCloudPlyReader()
+{
+  close();
+}
+
+bool PointCloudPlyReader::open(const char* filename)
+{
+  close();
+  if (!mapFile(filename))
+  {
+    std::cout << "Could not map the PLY file " << filename << std::endl;
+    return false;
+  }
+
+  const bool success = parseHeader() && (m_isBinary ? readBinary() : parseAscii());
+  if (!success)
+  {
+    std::cout << "Malformed or unsupported PLY file " << filename << std::endl;
+    close();
+  }
+  return success;
+}
+
+void PointCloudPlyReader::close()
+{
+  unmapFile();
+  m_isBinary   = false;
+  m_dataOffset = 0u;
+  m_numPoints  = 0u;
+  m_stride     = 0u;
+  m_properties.clear();
+  m_pPoints = nullptr;
+  m_points.clear();
+  m_rgbaMap.clear();
+  m_intensityMap.clear();
+}
+
+std::size_t PointCloudPlyReader::getNumPoints() const
+{
+  return m_numPoints;
+}
+
+bool PointCloudPlyReader::hasColors() const
+{
+  return findProperty("red") >= 0 && findProperty("green") >= 0 && findProperty("blue") >= 0;
+}
+
+bool PointCloudPlyReader::hasIntensities() const
+{
+  return findProperty("intensity") >= 0;
+}
+
+const PointXYZ* PointCloudPlyReader::getPoints() const
+{
+  return m_pPoints;
+}
+
+bool PointCloudPlyReader::isZeroCopy() const
+{
+  return m_pPoints != nullptr && m_pPoints != m_points.data();
+}
+
+void PointCloudPlyReader::readPoints(std::vector<PointXYZ>& points) const
+{
+  points.assign(m_pPoints, m_pPoints + m_numPoints);
+}
+
+bool PointCloudPlyReader::readColors(std::vector<uint32_t>& rgbaMap) const
+{
+  if (!hasColors())
+  {
+    return false;
+  }
+  if (!m_isBinary)
+  {
+    rgbaMap = m_rgbaMap;
+    return true;
+  }
+
+  const std::size_t channels[3] = {static_cast<std::size_t>(findProperty("red")),
+                                   static_cast<std::size_t>(findProperty("green")),
+                                   static_cast<std::size_t>(findProperty("blue"))};
+  rgbaMap.assign(m_numPoints, opaqueBlack());
+  for (std::size_t i = 0u; i < m_numPoints; ++i)
+  {
+    for (std::size_t channel = 0u; channel < 3u; ++channel)
+    {
+      setColorChannel(rgbaMap[i], channel, readBinaryValue(channels[channel], i));
+    }
+  }
+  return true;
+}
+
+bool PointCloudPlyReader::readIntensities(std::vector<uint16_t>& intensityMap) const
+{
+  if (!hasIntensities())
+  {
+    return false;
+  }
+  if (!m_isBinary)
+  {
+    intensityMap = m_intensityMap;
+    return true;
+  }
+
+  const auto propertyIndex = static_cast<std::size_t>(findProperty("intensity"));
+  intensityMap.resize(m_numPoints);
+  for (std::size_t i = 0u; i < m_numPoints; ++i)
+  {
+    intensityMap[i] = toIntensity(readBinaryValue(propertyIndex, i));
+  }
+  return true;
+}
+
+bool PointCloudPlyReader::mapFile(const char* filename)
+{
+#ifdef _WIN32
+  HANDLE file =
+    CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+  {
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr)
+  {
+    return false;
+  }
+  // the view keeps the mapping alive
+  const void* pView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (pView == nullptr)
+  {
+    return false;
+  }
+  m_pFile    = static_cast<const std::uint8_t*>(pView);
+  m_fileSize = static_cast<std::size_t>(size.QuadPart);
+#else
+  const int file = ::open(filename, O_RDONLY);
+  if (file < 0)
+  {
+    return false;
+  }
+  struct stat status;
+  if (::fstat(file, &status) != 0 || status.st_size <= 0)
+  {
+    ::close(file);
+    return false;
+  }
+  const auto size  = static_cast<std::size_t>(status.st_size);
+  void*      pView = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+  // the mapping stays valid after closing the file
+  ::close(file);
+  if (pView == MAP_FAILED)
+  {
+    return false;
+  }
+  m_pFile    = static_cast<const std::uint8_t*>(pView);
+  m_fileSize = size;
+#endif
+  return true;
+}
+
+void PointCloudPlyReader::unmapFile()
+{
+  if (m_pFile == nullptr)
+  {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(m_pFile);
+#else
+  ::munmap(const_cast<std::uint8_t*>(m_pFile), m_fileSize);
+#endif
+  m_pFile    = nullptr;
+  m_fileSize = 0u;
+}
+
+bool PointCloudPlyReader::parseHeader()
+{
+  const char* pText = reinterpret_cast<const char*>(m_pFile);
+  const char* pEnd  = pText + m_fileSize;
+
+  bool isInVertex  = false;
+  bool hasVertices = false;
+  bool hasFormat   = false;
+  bool isFirstLine = true;
+  for (const char* pLine = pText; pLine < pEnd;)
+  {
+    const char*       pLineEnd = std::find(pLine, pEnd, '\n');
+    std::string       line(pLine, pLineEnd);
+    const std::size_t nextLine = static_cast<std::size_t>(pLineEnd - pText) + 1u;
+    pLine                      = pLineEnd + ((pLineEnd == pEnd) ? 0 : 1);
+    if (!line.empty() && line.back() == '\r')
+    {
+      line.pop_back();
+    }
+
+    std::istringstream tokens(line);
+    std::string        keyword;
+    tokens >> keyword;
+    if (isFirstLine)
+    {
+      if (keyword != "ply")
+      {
+        return false;
+      }
+      isFirstLine = false;
+    }
+    else if (keyword == "format")
+    {
+      std::string format;
+      tokens >> format;
+      if (format != "ascii" && format != "binary_little_endian")
+      {
+        return false;
+      }
+      m_isBinary = (format == "binary_little_endian");
+      hasFormat  = true;
+    }
+    else if (keyword == "element")
+    {
+      std::string name;
+      std::size_t count = 0u;
+      tokens >> name >> count;
+      if (!hasVertices)
+      {
+        // other elements before the vertices are not supported
+        if (name != "vertex" || tokens.fail())
+        {
+          return false;
+        }
+        m_numPoints = count;
+        hasVertices = true;
+      }
+      isInVertex = (name == "vertex");
+    }
+    else if (keyword == "property" && isInVertex)
+    {
+      std::string typeName;
+      std::string name;
+      tokens >> typeName >> name;
+      static const char* const kTypeNames[][2] = {{"char", "int8"},
+                                                  {"uchar", "uint8"},
+                                                  {"short", "int16"},
+                                                  {"ushort", "uint16"},
+                                                  {"int", "int32"},
+                                                  {"uint", "uint32"},
+                                                  {"float", "float32"},
+                                                  {"double", "float64"}};
+      static const std::size_t kTypeSizes[]      = {1u, 1u, 2u, 2u, 4u, 4u, 4u, 8u};
+      int                      type              = -1;
+      for (int t = 0; t < 8; ++t)
+      {
+        if (typeName == kTypeNames[t][0] || typeName == kTypeNames[t][1])
+        {
+          type = t;
+        }
+      }
+      // list properties are not supported
+      if (type < 0 || name.empty())
+      {
+        return false;
+      }
+      m_properties.push_back(Property{name, static_cast<PropertyType>(type), m_stride});
+      m_stride += kTypeSizes[type];
+    }
+    else if (keyword == kEndHeader)
+    {
+      m_dataOffset = std::min(nextLine, m_fileSize);
+      return hasFormat && hasVertices && findProperty("x") >= 0 && findProperty("y") >= 0 && findProperty("z") >= 0;
+    }
+  }
+  return false;
+}
+
+bool PointCloudPlyReader::readBinary()
+{
+  if (m_numPoints > (m_fileSize - m_dataOffset) / m_stride)
+  {
+    return false;
+  }
+
+  const int           xIndex = findProperty("x");
+  const int           yIndex = findProperty("y");
+  const int           zIndex = findProperty("z");
+  const std::uint8_t* pData  = m_pFile + m_dataOffset;
+  const bool          isPointLayout =
+    m_stride == sizeof(PointXYZ) && m_properties[static_cast<std::size_t>(xIndex)].type == TYPE_FLOAT32
+    && m_properties[static_cast<std::size_t>(xIndex)].offset == offsetof(PointXYZ, x)
+    && m_properties[static_cast<std::size_t>(yIndex)].type == TYPE_FLOAT32
+    && m_properties[static_cast<std::size_t>(yIndex)].offset == offsetof(PointXYZ, y)
+    && m_properties[static_cast<std::size_t>(zIndex)].type == TYPE_FLOAT32
+    && m_properties[static_cast<std::size_t>(zIndex)].offset == offsetof(PointXYZ, z);
+  if (isPointLayout && endian::native == endian::little
+      && reinterpret_cast<std::uintptr_t>(pData) % alignof(PointXYZ) == 0u)
+  {
+    // the vertices are PointXYZ in the file, no copy is needed
+    m_pPoints = reinterpret_cast<const PointXYZ*>(pData);
+    return true;
+  }
+
+  m_points.resize(m_numPoints);
+  for (std::size_t i = 0u; i < m_numPoints; ++i)
+  {
+    m_points[i].x = static_cast<float>(readBinaryValue(static_cast<std::size_t>(xIndex), i));
+    m_points[i].y = static_cast<float>(readBinaryValue(static_cast<std::size_t>(yIndex), i));
+    m_points[i].z = static_cast<float>(readBinaryValue(static_cast<std::size_t>(zIndex), i));
+  }
+  m_pPoints = m_points.data();
+  return true;
+}
+
+bool PointCloudPlyReader::parseAscii()
+{
+  // fields of the vertices
+  enum Field
+  {
+    FIELD_IGNORED,
+    FIELD_X,
+    FIELD_Y,
+    FIELD_Z,
+    FIELD_RED,
+    FIELD_GREEN,
+    FIELD_BLUE,
+    FIELD_INTENSITY
+  };
+  static const char* const kFieldNames[] = {"", "x", "y", "z", "red", "green", "blue", "intensity"};
+  std::vector<Field>       fields(m_properties.size(), FIELD_IGNORED);
+  for (std::size_t i = 0u; i < m_properties.size(); ++i)
+  {
+    for (int field = FIELD_X; field <= FIELD_INTENSITY; ++field)
+    {
+      if (m_properties[i].name == kFieldNames[field])
+      {
+        fields[i] = static_cast<Field>(field);
+      }
+    }
+  }
+
+  // each value takes at least one character and a separator
+  if (m_numPoints > (m_fileSize - m_dataOffset + 1u) / (2u * m_properties.size()))
+  {
+    return false;
+  }
+
+  m_points.resize(m_numPoints);
+  if (hasColors())
+  {
+    m_rgbaMap.assign(m_numPoints, opaqueBlack());
+  }
+  if (hasIntensities())
+  {
+    m_intensityMap.resize(m_numPoints);
+  }
+
+  const char* p    = reinterpret_cast<const char*>(m_pFile + m_dataOffset);
+  const char* pEnd = reinterpret_cast<const char*>(m_pFile + m_fileSize);
+  for (std::size_t i = 0u; i < m_numPoints; ++i)
+  {
+    for (Field field : fields)
+    {
+      double value = 0.;
+      if (!parseNumber(p, pEnd, value))
+      {
+        return false;
+      }
+      switch (field)
+      {
+        case FIELD_X:
+          m_points[i].x = static_cast<float>(value);
+          break;
+        case FIELD_Y:
+          m_points[i].y = static_cast<float>(value);
+          break;
+        case FIELD_Z:
+          m_points[i].z = static_cast<float>(value);
+          break;
+        case FIELD_RED:
+        case FIELD_GREEN:
+        case FIELD_BLUE:
+          setColorChannel(m_rgbaMap[i], static_cast<std::size_t>(field - FIELD_RED), value);
+          break;
+        case FIELD_INTENSITY:
+          m_intensityMap[i] = toIntensity(value);
+          break;
+        case FIELD_IGNORED:
+          break;
+      }
+    }
+  }
+  m_pPoints = m_points.data();
+  return true;
+}
+
+int PointCloudPlyReader::findProperty(const char* name) const
+{
+  for (std::size_t i = 0u; i < m_properties.size(); ++i)
+  {
+    if (m_properties[i].name == name)
+    {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+double PointCloudPlyReader::readBinaryValue(std::size_t propertyIndex, std::size_t i) const
+{
+  const Property&     property = m_properties[propertyIndex];
+  const std::uint8_t* pValue   = m_pFile + m_dataOffset + i * m_stride + property.offset;
+  switch (property.type)
+  {
+    case TYPE_INT8:
+      return static_cast<std::int8_t>(*pValue);
+    case TYPE_UINT8:
+      return *pValue;
+    case TYPE_INT16:
+      return readUnalignLittleEndian<std::int16_t>(pValue);
+    case TYPE_UINT16:
+      return readUnalignLittleEndian<std::uint16_t>(pValue);
+    case TYPE_INT32:
+      return readUnalignLittleEndian<std::int32_t>(pValue);
+    case TYPE_UINT32:
+      return readUnalignLittleEndian<std::uint32_t>(pValue);
+    case TYPE_FLOAT32:
+      return static_cast<double>(readUnalignLittleEndian<float>(pValue));
+    case TYPE_FLOAT64:
+      return readUnalignLittleEndian<double>(pValue);
+  }
+  return 0.;
+}
+
+} // namespace visionary
@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "PointXYZ.h"
+
+namespace visionary {
+
+/// <summary>Class for reading point clouds from PLY files, e.g. files written by PointCloudPlyWriter.</summary>
+///
+/// The file is memory mapped. If a binary little endian file has vertices of exactly the float properties x, y and z
+/// and the vertex data is 4 byte aligned in the file, the points are a view into the mapped file and are not copied.
+/// Other binary layouts are converted into an internal buffer, ASCII files are parsed locale independently.
+/// Colors (red, green, blue as uchar) and intensities (float in [0, 1] as written by PointCloudPlyWriter) are read if
+/// present. Only the vertex element is read, it must be the first element of the file.
+class PointCloudPlyReader
+{
+public:
+  PointCloudPlyReader();
+  ~PointCloudPlyReader();
+
+  PointCloudPlyReader(const PointCloudPlyReader&)            = delete;
+  PointCloudPlyReader& operator=(const PointCloudPlyReader&) = delete;
+
+  /// Open a PLY file, a previously opened file is closed
+  ///
+  /// \param[in] filename the file to read
+  /// \returns false if the file can't be read or is not a supported PLY file
+  bool open(const char* filename);
+
+  /// Close the file, invalidates the point view
+  void close();
+
+  std::size_t getNumPoints() const;
+  bool        hasColors() const;
+  bool        hasIntensities() const;
+
+  /// Returns the points, valid until close or the next open.
+  /// Invalid points are NaN or 0 depending on how the file was written.
+  const PointXYZ* getPoints() const;
+
+  /// Returns true if getPoints is a view into the mapped file
+  bool isZeroCopy() const;
+
+  /// Copy the points
+  ///
+  /// \param[out] points the points, resized to getNumPoints
+  void readPoints(std::vector<PointXYZ>& points) const;
+
+  /// Read the colors as RGBA values with the bytes red, green, blue in memory order and an alpha of 255
+  ///
+  /// \param[out] rgbaMap the colors, resized to getNumPoints
+  /// \returns false if the file has no colors
+  bool readColors(std::vector<uint32_t>& rgbaMap) const;
+
+  /// Read the intensities scaled back to the 16 bit range of the intensity maps
+  ///
+  /// \param[out] intensityMap the intensities, resized to getNumPoints
+  /// \returns false if the file has no intensities
+  bool readIntensities(std::vector<uint16_t>& intensityMap) const;
+
+private:
+  enum PropertyType
+  {
+    TYPE_INT8,
+    TYPE_UINT8,
+    TYPE_INT16,
+    TYPE_UINT16,
+    TYPE_INT32,
+    TYPE_UINT32,
+    TYPE_FLOAT32,
+    TYPE_FLOAT64
+  };
+
+  struct Property
+  {
+    std::string  name;
+    PropertyType type;
+    // byte offset in a binary vertex
+    std::size_t offset;
+  };
+
+  bool mapFile(const char* filename);
+  void unmapFile();
+  // Parse the header and set the data offset, returns false if the header is malformed or not supported
+  bool parseHeader();
+  bool readBinary();
+  bool parseAscii();
+  // Index of the property with the name or -1
+  int findProperty(const char* name) const;
+  // Value of property of vertex i of a binary file
+  double readBinaryValue(std::size_t propertyIndex, std::size_t i) const;
+
+  // the mapped file
+  const std::uint8_t* m_pFile;
+  std::size_t         m_fileSize;
+
+  bool                  m_isBinary;
+  std::size_t           m_dataOffset;
+  std::size_t           m_numPoints;
+  std::size_t           m_stride;
+  std::vector<Property> m_properties;
+
+  const PointXYZ* m_pPoints;
+  // converted data if the file can't be used directly
+  std::vector<PointXYZ> m_points;
+  std::vector<uint32_t> m_rgbaMap;
+  std::vector<uint16_t> m_intensityMap;
+};
+
+} // namespace visionary
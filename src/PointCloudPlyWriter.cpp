@@ -5,13 +5,494 @@
 
 #include "PointCloudPlyWriter.h"
 
+#include "FileStream.h"
+#include "NumberFormat.h"
+#include "PositionalFileWriter.h"
 #include "VisionaryEndian.h"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstring>
 #include <fstream>
+#include <locale>
+#include <numeric>
 #include <sstream>
+#include <string>
 
 namespace visionary {
 
+namespace {
+// Number of points whose binary records are assembled in one chunk. A chunk is larger than the stream buffer, so it
+// is written to the file directly.
+const size_t kBinaryChunkPoints = 1u << 16u;
+
+// Assemble the binary vertex records of the points [begin, end) into pOut, returns the number of bytes written.
+// The optional properties are template parameters, so the loop has no per point branches for them.
+template <bool kHasColors, bool kHasIntensities>
+size_t encodeBinaryChunk(const PointXYZ*          pPoints,
+                         const uint32_t*          pRgba,
+                         const uint16_t*          pIntensity,
+                         size_t                   begin,
+                         size_t                   end,
+                         InvalidPointPresentation presentation,
+                         char*                    pOut)
+{
+  char* pRecord = pOut;
+  for (size_t i = begin; i < end; ++i)
+  {
+    PointXYZ point = pPoints[i];
+    // The X and Y values are calculated using the Z/distance value, so they should only be NaN if Z is NaN
+    if (presentation == INVALID_SKIP && std::isnan(point.z))
+    {
+      continue;
+    }
+    if (presentation == INVALID_AS_ZERO)
+    {
+      point.x = std::isnan(point.x) ? 0.0f : point.x;
+      point.y = std::isnan(point.y) ? 0.0f : point.y;
+      point.z = std::isnan(point.z) ? 0.0f : point.z;
+    }
+
+    const float coordinates[3] = {
+      nativeToLittleEndian(point.x), nativeToLittleEndian(point.y), nativeToLittleEndian(point.z)};
+    std::memcpy(pRecord, coordinates, sizeof(coordinates));
+    pRecord += sizeof(coordinates);
+    if (kHasColors)
+    {
+      // the first 3 bytes of the RGBA value in memory order
+      std::memcpy(pRecord, &pRgba[i], 3u);
+      pRecord += 3u;
+    }
+    if (kHasIntensities)
+    {
+      const float intensity = nativeToLittleEndian(static_cast<float>(pIntensity[i]) / 65535.0f);
+      std::memcpy(pRecord, &intensity, sizeof(intensity));
+      pRecord += sizeof(intensity);
+    }
+  }
+  return static_cast<size_t>(pRecord - pOut);
+}
+
+// Write the binary vertex records chunk by chunk with one write call per chunk
+template <bool kHasColors, bool kHasIntensities>
+void writeBinaryPoints(std::ofstream&               stream,
+                       const std::vector<PointXYZ>& points,
+                       const uint32_t*              pRgba,
+                       const uint16_t*              pIntensity,
+                       InvalidPointPresentation     presentation)
+{
+  const size_t      recordSize =
+    3u * sizeof(float) + (kHasColors ? 3u : 0u) + (kHasIntensities ? sizeof(float) : 0u);
+  std::vector<char> chunk(std::min(points.size(), kBinaryChunkPoints) * recordSize);
+  for (size_t begin = 0u; begin < points.size() && stream; begin += kBinaryChunkPoints)
+  {
+    const size_t end      = std::min(points.size(), begin + kBinaryChunkPoints);
+    const size_t numBytes = encodeBinaryChunk<kHasColors, kHasIntensities>(
+      points.data(), pRgba, pIntensity, begin, end, presentation, chunk.data());
+    stream.write(chunk.data(), static_cast<std::streamsize>(numBytes));
+  }
+}
+
+// Number of points whose ASCII lines are assembled in one chunk
+const size_t kAsciiChunkPoints = 1u << 14u;
+
+// Upper bound of the length of an ASCII vertex line including the separators and the line break
+const size_t kMaxAsciiLineChars = 4u * (kMaxFloatChars + 1u) + 3u * 4u;
+
+// Write an ASCII coordinate, invalid coordinates are written as 0.0 on INVALID_AS_ZERO
+char* encodeAsciiCoordinate(float value, InvalidPointPresentation presentation, char* pOut)
+{
+  if (presentation == INVALID_AS_ZERO && std::isnan(value))
+  {
+    std::memcpy(pOut, "0.0", 3u);
+    return pOut + 3;
+  }
+  return formatFloat(value, pOut);
+}
+
+// Assemble the ASCII vertex lines of the points [begin, end) into pOut, returns the number of characters written.
+// The numbers are formatted into the buffer directly instead of going through the locale aware stream formatting.
+template <bool kHasColors, bool kHasIntensities>
+size_t encodeAsciiChunk(const PointXYZ*          pPoints,
+                        const uint32_t*          pRgba,
+                        const uint16_t*          pIntensity,
+                        size_t                   begin,
+                        size_t                   end,
+                        InvalidPointPresentation presentation,
+                        char*                    pOut)
+{
+  char* pLine = pOut;
+  for (size_t i = begin; i < end; ++i)
+  {
+    const PointXYZ& point = pPoints[i];
+    // Handle PLY file presentation of X Y Z values (nan, 0.0 or SKIP)
+    if (presentation == INVALID_SKIP && std::isnan(point.z))
+    {
+      continue;
+    }
+
+    pLine    = encodeAsciiCoordinate(point.x, presentation, pLine);
+    *pLine++ = ' ';
+    pLine    = encodeAsciiCoordinate(point.y, presentation, pLine);
+    *pLine++ = ' ';
+    pLine    = encodeAsciiCoordinate(point.z, presentation, pLine);
+    if (kHasColors)
+    {
+      const auto rgba = reinterpret_cast<const uint8_t*>(&pRgba[i]);
+      for (size_t channel = 0u; channel < 3u; ++channel)
+      {
+        *pLine++ = ' ';
+        pLine    = formatUnsigned(rgba[channel], pLine);
+      }
+    }
+    if (kHasIntensities)
+    {
+      *pLine++ = ' ';
+      pLine    = formatFloat(static_cast<float>(pIntensity[i]) / 65535.0f, pLine);
+    }
+    *pLine++ = '\n';
+  }
+  return static_cast<size_t>(pLine - pOut);
+}
+
+// Write the ASCII vertex lines chunk by chunk with one write call per chunk
+template <bool kHasColors, bool kHasIntensities>
+void writeAsciiPoints(std::ofstream&               stream,
+                      const std::vector<PointXYZ>& points,
+                      const uint32_t*              pRgba,
+                      const uint16_t*              pIntensity,
+                      InvalidPointPresentation     presentation)
+{
+  std::vector<char> chunk(std::min(points.size(), kAsciiChunkPoints) * kMaxAsciiLineChars);
+  for (size_t begin = 0u; begin < points.size() && stream; begin += kAsciiChunkPoints)
+  {
+    const size_t end      = std::min(points.size(), begin + kAsciiChunkPoints);
+    const size_t numChars = encodeAsciiChunk<kHasColors, kHasIntensities>(
+      points.data(), pRgba, pIntensity, begin, end, presentation, chunk.data());
+    stream.write(chunk.data(), static_cast<std::streamsize>(numChars));
+  }
+}
+
+template <bool kHasColors, bool kHasIntensities>
+void writePoints(std::ofstream&               stream,
+                 const std::vector<PointXYZ>& points,
+                 const uint32_t*              pRgba,
+                 const uint16_t*              pIntensity,
+                 bool                         useBinary,
+                 InvalidPointPresentation     presentation)
+{
+  if (useBinary)
+  {
+    writeBinaryPoints<kHasColors, kHasIntensities>(stream, points, pRgba, pIntensity, presentation);
+  }
+  else
+  {
+    writeAsciiPoints<kHasColors, kHasIntensities>(stream, points, pRgba, pIntensity, presentation);
+  }
+}
+
+// Pad the header with a comment, so the binary data starts 4 byte aligned in the file and can be used by
+// PointCloudPlyReader without copying it
+void alignBinaryHeader(std::ostream& stream)
+{
+  const char           kComment[]   = "comment";
+  const char           kEndHeader[] = "end_header\n";
+  const std::streamoff headerEnd =
+    static_cast<std::streamoff>(stream.tellp()) + std::streamoff(sizeof(kComment) + sizeof(kEndHeader) - 1);
+  stream << kComment << std::string(static_cast<size_t>((4 - headerEnd % 4) % 4), ' ') << "\n";
+}
+
+void writeHeader(std::ostream& stream, size_t numberOfPoints, bool hasColors, bool hasIntensities, bool useBinary)
+{
+  stream << "ply\n";
+  stream << "format " << (useBinary ? "binary_little_endian" : "ascii") << " 1.0\n";
+  stream << "element vertex " << numberOfPoints << "\n";
+  stream << "property float x\n";
+  stream << "property float y\n";
+  stream << "property float z\n";
+  if (hasColors)
+  {
+    stream << "property uchar red\n";
+    stream << "property uchar green\n";
+    stream << "property uchar blue\n";
+  }
+  if (hasIntensities)
+  {
+    stream << "property float intensity\n";
+  }
+  if (useBinary)
+  {
+    alignBinaryHeader(stream);
+  }
+  stream << "end_header\n";
+}
+
+// Number of points of each chunk of kBinaryChunkPoints points which are written, invalid points are skipped on
+// INVALID_SKIP
+void countChunkPoints(const std::vector<PointXYZ>& points,
+                      InvalidPointPresentation     presentation,
+                      IExecutor&                   executor,
+                      std::vector<size_t>&         numChunkPoints)
+{
+  numChunkPoints.resize((points.size() + kBinaryChunkPoints - 1u) / kBinaryChunkPoints);
+  executor.parallelFor(numChunkPoints.size(), [&](size_t beginChunk, size_t endChunk) {
+    for (size_t chunk = beginChunk; chunk < endChunk; ++chunk)
+    {
+      const size_t begin = chunk * kBinaryChunkPoints;
+      const size_t end   = std::min(points.size(), begin + kBinaryChunkPoints);
+      if (presentation == INVALID_SKIP)
+      {
+        numChunkPoints[chunk] = static_cast<size_t>(
+          std::count_if(points.begin() + static_cast<std::ptrdiff_t>(begin),
+                        points.begin() + static_cast<std::ptrdiff_t>(end),
+                        [](const PointXYZ& point) { return !std::isnan(point.z); }));
+      }
+      else
+      {
+        numChunkPoints[chunk] = end - begin;
+      }
+    }
+  });
+}
+
+// Number of ASCII chunks encoded per executor thread in one batch. The length of the ASCII lines is only known after
+// the encoding, so the chunks are encoded in batches which are written behind each other.
+const size_t kAsciiChunksPerThread = 2u;
+
+// Encode the points in chunks in parallel and write the chunks at their file offsets behind the header
+template <bool kHasColors, bool kHasIntensities>
+bool writePointsParallel(PositionalFileWriter&        file,
+                         std::uint64_t                dataOffset,
+                         const std::vector<PointXYZ>& points,
+                         const std::vector<size_t>&   numChunkPoints,
+                         const uint32_t*              pRgba,
+                         const uint16_t*              pIntensity,
+                         bool                         useBinary,
+                         InvalidPointPresentation     presentation,
+                         IExecutor&                   executor)
+{
+  if (useBinary)
+  {
+    // The records have a fixed size, so the offset of each chunk is known before the encoding and every worker
+    // writes its chunks as soon as they are encoded
+    const size_t               recordSize =
+      3u * sizeof(float) + (kHasColors ? 3u : 0u) + (kHasIntensities ? sizeof(float) : 0u);
+    std::vector<std::uint64_t> chunkOffsets(numChunkPoints.size());
+    std::uint64_t              offset = dataOffset;
+    for (size_t chunk = 0u; chunk < numChunkPoints.size(); ++chunk)
+    {
+      chunkOffsets[chunk] = offset;
+      offset += numChunkPoints[chunk] * recordSize;
+    }
+
+    std::atomic<bool> success(true);
+    executor.parallelFor(numChunkPoints.size(), [&](size_t beginChunk, size_t endChunk) {
+      std::vector<char> buffer(kBinaryChunkPoints * recordSize);
+      for (size_t chunk = beginChunk; chunk < endChunk && success; ++chunk)
+      {
+        const size_t      begin       = chunk * kBinaryChunkPoints;
+        const size_t      end         = std::min(points.size(), begin + kBinaryChunkPoints);
+        const WriteBuffer writeBuffer = {buffer.data(),
+                                         encodeBinaryChunk<kHasColors, kHasIntensities>(
+                                           points.data(), pRgba, pIntensity, begin, end, presentation, buffer.data())};
+        if (!file.writeAt(chunkOffsets[chunk], &writeBuffer, 1u))
+        {
+          success = false;
+        }
+      }
+    });
+    return success;
+  }
+
+  const size_t                   numChunks = (points.size() + kAsciiChunkPoints - 1u) / kAsciiChunkPoints;
+  const size_t                   batchSize = std::max<size_t>(1u, executor.getConcurrency()) * kAsciiChunksPerThread;
+  std::vector<std::vector<char>> buffers(std::min(numChunks, batchSize));
+  std::vector<WriteBuffer>       writeBuffers(buffers.size());
+  std::uint64_t                  offset = dataOffset;
+  for (size_t firstChunk = 0u; firstChunk < numChunks; firstChunk += batchSize)
+  {
+    const size_t numBatchChunks = std::min(batchSize, numChunks - firstChunk);
+    executor.parallelFor(numBatchChunks, [&](size_t beginIndex, size_t endIndex) {
+      for (size_t index = beginIndex; index < endIndex; ++index)
+      {
+        const size_t begin = (firstChunk + index) * kAsciiChunkPoints;
+        const size_t end   = std::min(points.size(), begin + kAsciiChunkPoints);
+        buffers[index].resize(kAsciiChunkPoints * kMaxAsciiLineChars);
+        writeBuffers[index].pData = buffers[index].data();
+        writeBuffers[index].size  = encodeAsciiChunk<kHasColors, kHasIntensities>(
+          points.data(), pRgba, pIntensity, begin, end, presentation, buffers[index].data());
+      }
+    });
+    // the whole batch in one gathered write
+    if (!file.writeAt(offset, writeBuffers.data(), numBatchChunks))
+    {
+      return false;
+    }
+    for (size_t index = 0u; index < numBatchChunks; ++index)
+    {
+      offset += writeBuffers[index].size;
+    }
+  }
+  return true;
+}
+
+// PLY type name of the fixed point coordinates
+template <typename T>
+const char* plyTypeName();
+
+template <>
+const char* plyTypeName<int16_t>()
+{
+  return "short";
+}
+
+template <>
+const char* plyTypeName<int32_t>()
+{
+  return "int";
+}
+
+// Assemble the binary records of the fixed point coordinates of the points [begin, end) into pOut, returns the
+// number of bytes written. Every record is written and kept by advancing the position, so the invalid points are
+// replaced or skipped without branches.
+template <typename T>
+size_t encodeQuantizedBinaryChunk(const QuantizedPointXYZ<T>* pPoints,
+                                  size_t                      begin,
+                                  size_t                      end,
+                                  InvalidPointPresentation    presentation,
+                                  char*                       pOut)
+{
+  const bool skipInvalid = presentation == INVALID_SKIP;
+  const bool zeroInvalid = presentation == INVALID_AS_ZERO;
+
+  char* pRecord = pOut;
+  for (size_t i = begin; i < end; ++i)
+  {
+    const QuantizedPointXYZ<T>& point          = pPoints[i];
+    const bool                  isValid        = point.isValid();
+    const bool                  isZero         = zeroInvalid && !isValid;
+    const T                     coordinates[3] = {nativeToLittleEndian(isZero ? T(0) : point.x),
+                                                  nativeToLittleEndian(isZero ? T(0) : point.y),
+                                                  nativeToLittleEndian(isZero ? T(0) : point.z)};
+    std::memcpy(pRecord, coordinates, sizeof(coordinates));
+    pRecord += (isValid || !skipInvalid) ? sizeof(coordinates) : 0u;
+  }
+  return static_cast<size_t>(pRecord - pOut);
+}
+
+// Write the binary records of the fixed point coordinates chunk by chunk with one write call per chunk
+template <typename T>
+void writeQuantizedBinaryPoints(std::ofstream&                           stream,
+                                const std::vector<QuantizedPointXYZ<T>>& points,
+                                InvalidPointPresentation                 presentation)
+{
+  const size_t      recordSize = 3u * sizeof(T);
+  std::vector<char> chunk(std::min(points.size(), kBinaryChunkPoints) * recordSize);
+  for (size_t begin = 0u; begin < points.size() && stream; begin += kBinaryChunkPoints)
+  {
+    const size_t end      = std::min(points.size(), begin + kBinaryChunkPoints);
+    const size_t numBytes = encodeQuantizedBinaryChunk(points.data(), begin, end, presentation, chunk.data());
+    stream.write(chunk.data(), static_cast<std::streamsize>(numBytes));
+  }
+}
+
+// Upper bound of the length of an ASCII line of fixed point coordinates including the separators and the line break
+const size_t kMaxQuantizedAsciiLineChars = 3u * (kMaxIntegerChars + 1u);
+
+// Assemble the ASCII lines of the fixed point coordinates of the points [begin, end) into pOut, returns the number
+// of characters written. The line of a skipped point is overwritten by the next one.
+template <typename T>
+size_t encodeQuantizedAsciiChunk(const QuantizedPointXYZ<T>* pPoints,
+                                 size_t                      begin,
+                                 size_t                      end,
+                                 InvalidPointPresentation    presentation,
+                                 char*                       pOut)
+{
+  const bool skipInvalid = presentation == INVALID_SKIP;
+  const bool zeroInvalid = presentation == INVALID_AS_ZERO;
+
+  char* pLine = pOut;
+  for (size_t i = begin; i < end; ++i)
+  {
+    const QuantizedPointXYZ<T>& point   = pPoints[i];
+    const bool                  isValid = point.isValid();
+    const bool                  isZero  = zeroInvalid && !isValid;
+
+    char* pEnd = formatInteger(isZero ? T(0) : point.x, pLine);
+    *pEnd++    = ' ';
+    pEnd       = formatInteger(isZero ? T(0) : point.y, pEnd);
+    *pEnd++    = ' ';
+    pEnd       = formatInteger(isZero ? T(0) : point.z, pEnd);
+    *pEnd++    = '\n';
+    pLine      = (isValid || !skipInvalid) ? pEnd : pLine;
+  }
+  return static_cast<size_t>(pLine - pOut);
+}
+
+// Write the ASCII lines of the fixed point coordinates chunk by chunk with one write call per chunk
+template <typename T>
+void writeQuantizedAsciiPoints(std::ofstream&                           stream,
+                               const std::vector<QuantizedPointXYZ<T>>& points,
+                               InvalidPointPresentation                 presentation)
+{
+  std::vector<char> chunk(std::min(points.size(), kAsciiChunkPoints) * kMaxQuantizedAsciiLineChars);
+  for (size_t begin = 0u; begin < points.size() && stream; begin += kAsciiChunkPoints)
+  {
+    const size_t end      = std::min(points.size(), begin + kAsciiChunkPoints);
+    const size_t numChars = encodeQuantizedAsciiChunk(points.data(), begin, end, presentation, chunk.data());
+    stream.write(chunk.data(), static_cast<std::streamsize>(numChars));
+  }
+}
+
+template <typename T>
+bool writeQuantizedPLY(const char*                              filename,
+                       const std::vector<QuantizedPointXYZ<T>>& points,
+                       float                                    scale,
+                       bool                                     useBinary,
+                       InvalidPointPresentation                 presentation)
+{
+  size_t numberOfPoints = points.size();
+  if (presentation == INVALID_SKIP)
+  {
+    numberOfPoints = static_cast<size_t>(
+      std::count_if(points.begin(), points.end(), [](const QuantizedPointXYZ<T>& point) { return point.isValid(); }));
+  }
+
+  std::ofstream     stream;
+  std::vector<char> streamBuffer;
+  if (!openFileStream(stream, streamBuffer, filename, useBinary))
+  {
+    return false;
+  }
+
+  // Write header
+  stream << "ply\n";
+  stream << "format " << (useBinary ? "binary_little_endian" : "ascii") << " 1.0\n";
+  char        scaleChars[kMaxFloatChars];
+  const char* pScaleEnd = formatFloat(scale, scaleChars);
+  stream << "comment scale ";
+  stream.write(scaleChars, pScaleEnd - scaleChars);
+  stream << "\n";
+  stream << "element vertex " << numberOfPoints << "\n";
+  stream << "property " << plyTypeName<T>() << " x\n";
+  stream << "property " << plyTypeName<T>() << " y\n";
+  stream << "property " << plyTypeName<T>() << " z\n";
+  stream << "end_header\n";
+
+  if (useBinary)
+  {
+    writeQuantizedBinaryPoints(stream, points, presentation);
+  }
+  else
+  {
+    writeQuantizedAsciiPoints(stream, points, presentation);
+  }
+
+  stream.close();
+  return !stream.fail();
+}
+} // namespace
+
 bool PointCloudPlyWriter::WriteFormatPLY(const char*                  filename,
                                          const std::vector<PointXYZ>& points,
                                          bool                         useBinary,
@@ -45,216 +526,128 @@ bool PointCloudPlyWriter::WriteFormatPLY(const char*                  filename,
                                          bool                         useBinary,
                                          InvalidPointPresentation     presentation)
 {
-  bool success = true;
-
-  bool hasColors      = points.size() == rgbaMap.size();
-  bool hasIntensities = points.size() == intensityMap.size();
+  const bool hasColors      = points.size() == rgbaMap.size();
+  const bool hasIntensities = points.size() == intensityMap.size();
 
-  std::ofstream stream; // output file stream for PLY file
-  std::stringstream
-    strstream; // temporary data buffer stream
-               // Reason: On presentation mode INVALID_SKIP we only know the number of "element vertex ?"
-               //         in the header of the PLY file after iterating through the "vector<PointXYZ>& points"
-               //         and checking if it has the value NaN. The header has to be printed before and
-               //         therefore the data part has to be temprorarily buffered.
+  // On presentation mode INVALID_SKIP the number of vertices in the header is only known after checking all points,
+  // so they are counted in a pre-pass instead of buffering the data part.
+  // The X and Y values are calculated using the Z/distance value which is received by the device.
+  // So X and Y should only be NaN if Z/distance is NaN.
+  size_t numberOfPoints = points.size();
+  if (presentation == INVALID_SKIP)
+  {
+    numberOfPoints = static_cast<size_t>(
+      std::count_if(points.begin(), points.end(), [](const PointXYZ& point) { return !std::isnan(point.z); }));
+  }
 
-  int numberOfValidPoints = 0;
-  if (useBinary == false)
+  std::ofstream     stream;
+  std::vector<char> streamBuffer;
+  if (!openFileStream(stream, streamBuffer, filename, useBinary))
   {
-    // Write all points
-    for (size_t i = 0; i < points.size(); i++)
-    {
-      PointXYZ point = points.at(i);
+    return false;
+  }
 
-      // Handle PLY file presentation of X Y Z values (nan, 0.0 or SKIP)
-      if (presentation == INVALID_AS_NAN)
-      {
-        strstream << point.x << " " << point.y << " " << point.z;
-      }
-      if (presentation == INVALID_AS_ZERO)
-      {
-        if (std::isnan(point.x))
-          strstream << "0.0";
-        else
-          strstream << point.x;
-        strstream << " ";
-
-        if (std::isnan(point.y))
-          strstream << "0.0";
-        else
-          strstream << point.y;
-        strstream << " ";
-
-        if (std::isnan(point.z))
-          strstream << "0.0";
-        else
-          strstream << point.z;
-      }
-      if (presentation == INVALID_AS_NAN || presentation == INVALID_AS_ZERO)
-      {
-        if (hasColors)
-        {
-          const auto rgba = reinterpret_cast<const uint8_t*>(&rgbaMap.at(i));
-          strstream << " " << static_cast<uint32_t>(rgba[0]) << " " << static_cast<uint32_t>(rgba[1]) << " "
-                    << static_cast<uint32_t>(rgba[2]);
-        }
-        if (hasIntensities)
-        {
-          float intensity = static_cast<float>(intensityMap.at(i)) / 65535.0f;
-          strstream << " " << intensity;
-        }
-        strstream << "\n";
-      }
-      if (presentation == INVALID_SKIP)
-      {
-        // The X and Y values are calculated using the Z/distance value which is received by the device.
-        // So X and Y should only be NaN if Z/distance is NaN.
-        if (std::isnan(point.z))
-        {
-          continue;
-        }
-        else
-        {
-          strstream << point.x << " " << point.y << " " << point.z;
-
-          if (hasColors)
-          {
-            const auto rgba = reinterpret_cast<const uint8_t*>(&rgbaMap.at(i));
-            strstream << " " << static_cast<uint32_t>(rgba[0]) << " " << static_cast<uint32_t>(rgba[1]) << " "
-                      << static_cast<uint32_t>(rgba[2]);
-          }
-          if (hasIntensities)
-          {
-            float intensity = static_cast<float>(intensityMap.at(i)) / 65535.0f;
-            strstream << " " << intensity;
-          }
-          strstream << "\n";
-
-          numberOfValidPoints++;
-        }
-      }
-    }
+  writeHeader(stream, numberOfPoints, hasColors, hasIntensities, useBinary);
+
+  const uint32_t* pRgba      = hasColors ? rgbaMap.data() : nullptr;
+  const uint16_t* pIntensity = hasIntensities ? intensityMap.data() : nullptr;
+  if (hasColors && hasIntensities)
+  {
+    writePoints<true, true>(stream, points, pRgba, pIntensity, useBinary, presentation);
+  }
+  else if (hasColors)
+  {
+    writePoints<true, false>(stream, points, pRgba, pIntensity, useBinary, presentation);
+  }
+  else if (hasIntensities)
+  {
+    writePoints<false, true>(stream, points, pRgba, pIntensity, useBinary, presentation);
   }
   else
   {
-    // Write all points
-    for (size_t i = 0; i < points.size(); i++)
-    {
-      PointXYZ point = points.at(i);
+    writePoints<false, false>(stream, points, pRgba, pIntensity, useBinary, presentation);
+  }
 
-      // Handle PLY file presentation of X Y Z values (nan, 0.0 or SKIP)
-      if (presentation == INVALID_AS_NAN)
-      {
-        // Nothing to do, use values as they are available
-      }
-      if (presentation == INVALID_AS_ZERO)
-      {
-        if (std::isnan(point.x))
-          point.x = 0.0f;
-        if (std::isnan(point.y))
-          point.y = 0.0f;
-        if (std::isnan(point.z))
-          point.z = 0.0f;
-      }
-      if (presentation == INVALID_AS_NAN || presentation == INVALID_AS_ZERO)
-      {
-        float x = nativeToLittleEndian(point.x);
-        float y = nativeToLittleEndian(point.y);
-        float z = nativeToLittleEndian(point.z);
+  stream.close();
+  return !stream.fail();
+}
 
-        strstream.write(reinterpret_cast<char*>(&x), 4);
-        strstream.write(reinterpret_cast<char*>(&y), 4);
-        strstream.write(reinterpret_cast<char*>(&z), 4);
+bool PointCloudPlyWriter::WriteFormatPLY(const char*                  filename,
+                                         const std::vector<PointXYZ>& points,
+                                         const std::vector<uint32_t>& rgbaMap,
+                                         const std::vector<uint16_t>& intensityMap,
+                                         bool                         useBinary,
+                                         InvalidPointPresentation     presentation,
+                                         IExecutor&                   executor)
+{
+  const bool hasColors      = points.size() == rgbaMap.size();
+  const bool hasIntensities = points.size() == intensityMap.size();
 
-        if (hasColors)
-        {
-          strstream.write(reinterpret_cast<const char*>(&rgbaMap.at(i)), 3);
-        }
-        if (hasIntensities)
-        {
-          float intensity = static_cast<float>(intensityMap.at(i)) / 65535.0f;
-          strstream.write(reinterpret_cast<const char*>(&intensity), 4);
-        }
-      }
-      if (presentation == INVALID_SKIP)
-      {
-        // The X and Y values are calculated using the Z/distance value which is received by the device.
-        // So X and Y should only be NaN if Z/distance is NaN.
-        if (std::isnan(point.z))
-        {
-          continue;
-        }
-        else
-        {
-          float x = nativeToLittleEndian(point.x);
-          float y = nativeToLittleEndian(point.y);
-          float z = nativeToLittleEndian(point.z);
-
-          strstream.write(reinterpret_cast<char*>(&x), 4);
-          strstream.write(reinterpret_cast<char*>(&y), 4);
-          strstream.write(reinterpret_cast<char*>(&z), 4);
-
-          if (hasColors)
-          {
-            strstream.write(reinterpret_cast<const char*>(&rgbaMap.at(i)), 3);
-          }
-          if (hasIntensities)
-          {
-            float intensity = static_cast<float>(intensityMap.at(i)) / 65535.0f;
-            strstream.write(reinterpret_cast<const char*>(&intensity), 4);
-          }
-
-          numberOfValidPoints++;
-        }
-      }
-    }
-  }
+  // the number of vertices in the header and the offsets of the binary chunks
+  std::vector<size_t> numChunkPoints;
+  countChunkPoints(points, presentation, executor, numChunkPoints);
+  const size_t numberOfPoints = std::accumulate(numChunkPoints.begin(), numChunkPoints.end(), size_t{0u});
 
-  // Open file
-  stream.open(filename, useBinary ? (std::ios_base::out | std::ios_base::binary) : std::ios_base::out);
+  std::ostringstream header;
+  header.imbue(std::locale::classic());
+  writeHeader(header, numberOfPoints, hasColors, hasIntensities, useBinary);
+  const std::string headerText = header.str();
 
-  if (stream.is_open())
+  PositionalFileWriter file;
+  if (!file.open(filename))
   {
-    // Write header
-    stream << "ply\n";
-    stream << "format " << (useBinary ? "binary_little_endian" : "ascii") << " 1.0\n";
-
-    if (presentation == INVALID_SKIP)
-    {
-      stream << "element vertex " << numberOfValidPoints << "\n";
-    }
-    else
-    {
-      stream << "element vertex " << points.size() << "\n";
-    }
+    return false;
+  }
+  const WriteBuffer headerBuffer = {headerText.data(), headerText.size()};
+  if (!file.writeAt(0u, &headerBuffer, 1u))
+  {
+    file.close();
+    return false;
+  }
 
-    stream << "property float x\n";
-    stream << "property float y\n";
-    stream << "property float z\n";
-    if (hasColors)
-    {
-      stream << "property uchar red\n";
-      stream << "property uchar green\n";
-      stream << "property uchar blue\n";
-    }
-    if (hasIntensities)
-    {
-      stream << "property float intensity\n";
-    }
-    stream << "end_header\n";
+  const uint32_t* pRgba      = hasColors ? rgbaMap.data() : nullptr;
+  const uint16_t* pIntensity = hasIntensities ? intensityMap.data() : nullptr;
+  const auto      dataOffset = static_cast<std::uint64_t>(headerText.size());
+  bool            success    = false;
+  if (hasColors && hasIntensities)
+  {
+    success = writePointsParallel<true, true>(
+      file, dataOffset, points, numChunkPoints, pRgba, pIntensity, useBinary, presentation, executor);
+  }
+  else if (hasColors)
+  {
+    success = writePointsParallel<true, false>(
+      file, dataOffset, points, numChunkPoints, pRgba, pIntensity, useBinary, presentation, executor);
+  }
+  else if (hasIntensities)
+  {
+    success = writePointsParallel<false, true>(
+      file, dataOffset, points, numChunkPoints, pRgba, pIntensity, useBinary, presentation, executor);
   }
   else
   {
-    success = false;
+    success = writePointsParallel<false, false>(
+      file, dataOffset, points, numChunkPoints, pRgba, pIntensity, useBinary, presentation, executor);
   }
+  return file.close() && success;
+}
 
-  // Add the temporarily buffered data part to the ofstream
-  stream << strstream.rdbuf();
-
-  // Close file
-  stream.close();
+bool PointCloudPlyWriter::WriteFormatPLY(const char*                             filename,
+                                         const std::vector<QuantizedPointXYZ16>& points,
+                                         float                                   scale,
+                                         bool                                    useBinary,
+                                         InvalidPointPresentation                presentation)
+{
+  return writeQuantizedPLY(filename, points, scale, useBinary, presentation);
+}
 
-  return success;
+bool PointCloudPlyWriter::WriteFormatPLY(const char*                             filename,
+                                         const std::vector<QuantizedPointXYZ32>& points,
+                                         float                                   scale,
+                                         bool                                    useBinary,
+                                         InvalidPointPresentation                presentation)
+{
+  return writeQuantizedPLY(filename, points, scale, useBinary, presentation);
 }
 
 PointCloudPlyWriter::PointCloudPlyWriter() = default;
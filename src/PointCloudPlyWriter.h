@@ -8,7 +8,9 @@
 #include <cstdint>
 #include <vector>
 
+#include "IExecutor.h"
 #include "PointXYZ.h"
+#include "QuantizedPointXYZ.h"
 
 namespace visionary {
 
@@ -78,6 +80,50 @@ public:
                              bool                         useBinary,
                              InvalidPointPresentation     presentation = INVALID_AS_NAN);
 
+  /// <summary>Save a point cloud with optional colors and intensities to a file in Polygon File Format (PLY), encoding
+  /// chunks of the points in parallel. Each chunk is encoded into its own buffer and written at its file offset, the
+  /// offsets of binary chunks are known before the encoding.</summary> <param name="filename">The file to save the
+  /// point cloud to</param> <param name="points">The points to save</param> <param name="rgbaMap">RGBA colors for
+  /// each point, no colors are written if the length differs from points</param> <param name="intensityMap">Intensities
+  /// for each point, no intensities are written if the length differs from points</param> <param name="useBinary">If
+  /// the output file is binary or ascii</param> <param name="presentation">Definition how invalid points should be
+  /// presented inside the PLY file</param> <param name="executor">Executor encoding the chunks, e.g. a ThreadPool
+  /// with the number of threads to use</param> <returns>Returns true if write was successful and false
+  /// otherwise</returns>
+  static bool WriteFormatPLY(const char*                  filename,
+                             const std::vector<PointXYZ>& points,
+                             const std::vector<uint32_t>& rgbaMap,
+                             const std::vector<uint16_t>& intensityMap,
+                             bool                         useBinary,
+                             InvalidPointPresentation     presentation,
+                             IExecutor&                   executor);
+
+  /// <summary>Save a point cloud with fixed point coordinates to a file in Polygon File Format (PLY). The coordinates
+  /// are written as 16 bit integers ("short"), the scale is stored as comment in the header.</summary>
+  /// <param name="filename">The file to save the point cloud to</param> <param name="points">The points to
+  /// save</param> <param name="scale">Size of one coordinate unit in meters</param> <param name="useBinary">If the
+  /// output file is binary or ascii</param> <param name="presentation">Definition how invalid points should be
+  /// presented inside the PLY file; INVALID_AS_NAN keeps the invalid marker value [optional]</param> <returns>Returns
+  /// true if write was successful and false otherwise</returns>
+  static bool WriteFormatPLY(const char*                             filename,
+                             const std::vector<QuantizedPointXYZ16>& points,
+                             float                                   scale,
+                             bool                                    useBinary,
+                             InvalidPointPresentation                presentation = INVALID_AS_NAN);
+
+  /// <summary>Save a point cloud with fixed point coordinates to a file in Polygon File Format (PLY). The coordinates
+  /// are written as 32 bit integers ("int"), the scale is stored as comment in the header.</summary>
+  /// <param name="filename">The file to save the point cloud to</param> <param name="points">The points to
+  /// save</param> <param name="scale">Size of one coordinate unit in meters</param> <param name="useBinary">If the
+  /// output file is binary or ascii</param> <param name="presentation">Definition how invalid points should be
+  /// presented inside the PLY file; INVALID_AS_NAN keeps the invalid marker value [optional]</param> <returns>Returns
+  /// true if write was successful and false otherwise</returns>
+  static bool WriteFormatPLY(const char*                             filename,
+                             const std::vector<QuantizedPointXYZ32>& points,
+                             float                                   scale,
+                             bool                                    useBinary,
+                             InvalidPointPresentation                presentation = INVALID_AS_NAN);
+
 private:
   // No instantiations
   PointCloudPlyWriter();
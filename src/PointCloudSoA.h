@@ -0,0 +1,40 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+
+#include "AlignedAllocator.h"
+
+namespace visionary {
+
+/// Point cloud in structure-of-arrays layout
+///
+/// The coordinates are stored in three separate planes, each aligned to 64 bytes.
+/// Point i is (x[i], y[i], z[i]). Per axis processing (e.g. height filtering or bounding boxes) reads
+/// contiguous streams, and vectorized code needs no shuffles.
+struct PointCloudSoA
+{
+  AlignedVector<float> x;
+  AlignedVector<float> y;
+  AlignedVector<float> z;
+
+  /// Returns the number of points
+  std::size_t size() const
+  {
+    return z.size();
+  }
+
+  /// Resize all planes to \a numPoints
+  void resize(std::size_t numPoints)
+  {
+    x.resize(numPoints);
+    y.resize(numPoints);
+    z.resize(numPoints);
+  }
+};
+
+} // namespace visionary
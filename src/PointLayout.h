@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace visionary {
+
+/// Data written into a field of a point
+enum PointFieldSource
+{
+  /// Coordinates in meters, NaN for invalid points
+  FIELD_X = 0,
+  FIELD_Y = 1,
+  FIELD_Z = 2,
+
+  /// Value of the intensity map (Visionary-T and Visionary-T Mini), 0 if not available
+  FIELD_INTENSITY = 3,
+
+  /// Value of the confidence map (Visionary-T and Visionary-S), 0 if not available
+  FIELD_CONFIDENCE = 4,
+
+  /// Value of the RGBA map (Visionary-S) with the bytes in the order of the map, 0 if not available
+  FIELD_RGBA = 5,
+
+  /// Index of the pixel the point belongs to
+  FIELD_PIXEL_INDEX = 6
+};
+
+/// Type of a field in the point buffer. Values outside the range of integer types are clamped.
+enum PointFieldType
+{
+  FIELD_FLOAT32 = 0,
+  FIELD_UINT8   = 1,
+  FIELD_UINT16  = 2,
+  FIELD_UINT32  = 3
+};
+
+/// One field of a point, e.g. the x coordinate as float at byte offset 0
+struct PointField
+{
+  PointFieldSource source;
+  /// Coordinates must be FIELD_FLOAT32
+  PointFieldType type;
+  /// Byte offset of the field in the point
+  std::size_t offset;
+};
+
+/// Memory layout of the points of a point cloud, similar to the fields of a ROS PointCloud2 message.
+/// Bytes of a point which are not covered by a field, e.g. padding, are not written.
+struct PointLayout
+{
+  std::vector<PointField> fields;
+  /// Distance in bytes between the starts of consecutive points
+  std::size_t stride;
+};
+
+} // namespace visionary
@@ -0,0 +1,18 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+namespace visionary {
+
+// Unit surface normal of a point, NaN if the normal could not be estimated
+struct PointNormal
+{
+  float nx;
+  float ny;
+  float nz;
+};
+
+} // namespace visionary
@@ -0,0 +1,27 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstdint>
+
+namespace visionary {
+
+// Point with the color of its pixel. The point is padded to 16 bytes, so that each point can be loaded and stored
+// with a single aligned vector access.
+struct alignas(16) PointXYZRGB
+{
+  float        x;
+  float        y;
+  float        z;
+  std::uint8_t r;
+  std::uint8_t g;
+  std::uint8_t b;
+  std::uint8_t a;
+};
+
+static_assert(sizeof(PointXYZRGB) == 16u, "PointXYZRGB must be packed into 16 bytes");
+
+} // namespace visionary
@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "PositionalFileWriter.h"
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#endif
+
+#include <algorithm>
+
+namespace visionary {
+
+PositionalFileWriter::PositionalFileWriter()
+#ifdef _WIN32
+  : m_handle(INVALID_HANDLE_VALUE)
+#else
+  : m_file(-1)
+#endif
+{
+}
+
+PositionalFileWriter::~PositionalFileWriter()
+{
+  close();
+}
+
+bool PositionalFileWriter::open(const char* filename)
+{
+  close();
+#ifdef _WIN32
+  m_handle = CreateFileA(filename, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  return m_handle != INVALID_HANDLE_VALUE;
+#else
+  m_file = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  return m_file >= 0;
+#endif
+}
+
+bool PositionalFileWriter::writeAt(std::uint64_t offset, const WriteBuffer* pBuffers, std::size_t count)
+{
+#ifdef _WIN32
+  for (std::size_t i = 0u; i < count; ++i)
+  {
+    if (!writeBuffer(offset, pBuffers[i].pData, pBuffers[i].size))
+    {
+      return false;
+    }
+    offset += pBuffers[i].size;
+  }
+  return true;
+#else
+  // gather the buffers in groups, so no vector array has to be allocated
+  const std::size_t kMaxVectors = 64u;
+  struct iovec      vectors[kMaxVectors];
+  for (std::size_t first = 0u; first < count; first += kMaxVectors)
+  {
+    const std::size_t numVectors = std::min(kMaxVectors, count - first);
+    for (std::size_t i = 0u; i < numVectors; ++i)
+    {
+      vectors[i].iov_base = const_cast<char*>(pBuffers[first + i].pData);
+      vectors[i].iov_len  = pBuffers[first + i].size;
+    }
+    const ssize_t written = ::pwritev(m_file, vectors, static_cast<int>(numVectors), static_cast<off_t>(offset));
+    if (written < 0 && errno != EINTR)
+    {
+      return false;
+    }
+
+    // a partial or interrupted write is finished buffer by buffer
+    std::size_t numDone = (written > 0) ? static_cast<std::size_t>(written) : 0u;
+    for (std::size_t i = 0u; i < numVectors; ++i)
+    {
+      const WriteBuffer& buffer = pBuffers[first + i];
+      if (numDone >= buffer.size)
+      {
+        numDone -= buffer.size;
+      }
+      else
+      {
+        if (!writeBuffer(offset + numDone, buffer.pData + numDone, buffer.size - numDone))
+        {
+          return false;
+        }
+        numDone = 0u;
+      }
+      offset += buffer.size;
+    }
+  }
+  return true;
+#endif
+}
+
+bool PositionalFileWriter::close()
+{
+#ifdef _WIN32
+  if (m_handle == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+  const bool success = CloseHandle(m_handle) != 0;
+  m_handle           = INVALID_HANDLE_VALUE;
+#else
+  if (m_file < 0)
+  {
+    return false;
+  }
+  const bool success = ::close(m_file) == 0;
+  m_file             = -1;
+#endif
+  return success;
+}
+
+bool PositionalFileWriter::writeBuffer(std::uint64_t offset, const char* pData, std::size_t size)
+{
+  while (size > 0u)
+  {
+#ifdef _WIN32
+    // WriteFile takes 32 bit sizes, the offset is given by the OVERLAPPED structure also for synchronous handles
+    OVERLAPPED overlapped = {};
+    overlapped.Offset     = static_cast<DWORD>(offset & 0xFFFFFFFFu);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32u);
+    DWORD written         = 0u;
+    if (!WriteFile(m_handle, pData, static_cast<DWORD>(std::min<std::size_t>(size, 1u << 30u)), &written, &overlapped)
+        || written == 0u)
+    {
+      return false;
+    }
+    const std::size_t numWritten = written;
+#else
+    const ssize_t written = ::pwrite(m_file, pData, size, static_cast<off_t>(offset));
+    if (written < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (written <= 0)
+    {
+      return false;
+    }
+    const auto numWritten = static_cast<std::size_t>(written);
+#endif
+    pData += numWritten;
+    offset += numWritten;
+    size -= numWritten;
+  }
+  return true;
+}
+
+} // namespace visionary
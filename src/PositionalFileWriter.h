@@ -0,0 +1,63 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace visionary {
+
+/// Buffer of a gathered write
+struct WriteBuffer
+{
+  const char* pData;
+  std::size_t size;
+};
+
+/// \brief File which is written at explicit offsets, so several threads can write disjoint parts of it
+///
+/// On POSIX systems the buffers of a write are gathered with one pwritev call, on Windows they are written with
+/// WriteFile at an explicit offset. Neither moves a shared file position, so writes of different threads do not
+/// need to be ordered.
+class PositionalFileWriter
+{
+public:
+  PositionalFileWriter();
+  ~PositionalFileWriter();
+
+  PositionalFileWriter(const PositionalFileWriter&)            = delete;
+  PositionalFileWriter& operator=(const PositionalFileWriter&) = delete;
+
+  /// Create or truncate the file
+  ///
+  /// \param[in] filename the file to write
+  /// \returns false if the file can't be opened for writing
+  bool open(const char* filename);
+
+  /// Write buffers one after the other, starting at an offset. Thread safe for disjoint file ranges.
+  ///
+  /// \param[in] offset   byte offset of the first buffer in the file
+  /// \param[in] pBuffers the buffers
+  /// \param[in] count    number of buffers
+  /// \returns false if not all bytes could be written
+  bool writeAt(std::uint64_t offset, const WriteBuffer* pBuffers, std::size_t count);
+
+  /// Close the file
+  ///
+  /// \returns false if the file was not open or closing it failed
+  bool close();
+
+private:
+  bool writeBuffer(std::uint64_t offset, const char* pData, std::size_t size);
+
+#ifdef _WIN32
+  void* m_handle;
+#else
+  int m_file;
+#endif
+};
+
+} // namespace visionary
@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace visionary {
+
+/// Point with fixed point coordinates
+///
+/// The coordinates are multiples of a scale (e.g. 0.001 m for millimeters) which is chosen when the
+/// point cloud is generated. Invalid points have all coordinates set to invalid().
+///
+/// \tparam T signed integer type of the coordinates
+template <typename T>
+struct QuantizedPointXYZ
+{
+  T x;
+  T y;
+  T z;
+
+  /// Returns the coordinate value of invalid points (lowest value of T)
+  static constexpr T invalid()
+  {
+    return std::numeric_limits<T>::lowest();
+  }
+
+  /// Returns true if the point is valid
+  bool isValid() const
+  {
+    return z != invalid();
+  }
+};
+
+/// Point with 16 bit coordinates, i.e. +/- 32.7 m at 1 mm scale
+using QuantizedPointXYZ16 = QuantizedPointXYZ<std::int16_t>;
+/// Point with 32 bit coordinates
+using QuantizedPointXYZ32 = QuantizedPointXYZ<std::int32_t>;
+
+} // namespace visionary
@@ -0,0 +1,232 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "TemporalFilter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace visionary {
+
+namespace {
+
+bool isInvalidValue(std::uint16_t value)
+{
+  return (value == 0u) || (value == 0xFFFFu);
+}
+
+} // namespace
+
+TemporalFilter::TemporalFilter(const TemporalFilterParameters& parameters)
+  : m_parameters(parameters)
+  , m_isAllocated(false)
+  , m_changeCounter(0u)
+  , m_numPixels(0u)
+  , m_numFrames(0u)
+  , m_roi()
+  , m_ringSlot(0u)
+{
+  assert(m_parameters.mode != TEMPORAL_WINDOWED || m_parameters.windowSize > 0u);
+  assert(m_parameters.mode != TEMPORAL_EXPONENTIAL || (m_parameters.alpha > 0.0f && m_parameters.alpha <= 1.0f));
+}
+
+void TemporalFilter::apply(VisionaryData& data, const std::vector<std::uint16_t>& confidenceMap)
+{
+  updateRegionOfInterest(data);
+  applyImpl(data.getPointCloudSourceMap(), confidenceMap, data.getChangeCounter(), nullptr);
+}
+
+void TemporalFilter::apply(VisionaryData& data, const std::vector<std::uint16_t>& confidenceMap, IExecutor& executor)
+{
+  updateRegionOfInterest(data);
+  applyImpl(data.getPointCloudSourceMap(), confidenceMap, data.getChangeCounter(), &executor);
+}
+
+void TemporalFilter::apply(std::vector<std::uint16_t>&       map,
+                           const std::vector<std::uint16_t>& confidenceMap,
+                           std::uint32_t                     changeCounter)
+{
+  applyImpl(map, confidenceMap, changeCounter, nullptr);
+}
+
+void TemporalFilter::apply(std::vector<std::uint16_t>&       map,
+                           const std::vector<std::uint16_t>& confidenceMap,
+                           std::uint32_t                     changeCounter,
+                           IExecutor&                        executor)
+{
+  applyImpl(map, confidenceMap, changeCounter, &executor);
+}
+
+void TemporalFilter::reset()
+{
+  m_isAllocated = false;
+  m_numFrames   = 0u;
+}
+
+std::size_t TemporalFilter::getNumFrames() const
+{
+  return m_numFrames;
+}
+
+void TemporalFilter::applyImpl(std::vector<std::uint16_t>&       map,
+                               const std::vector<std::uint16_t>& confidenceMap,
+                               std::uint32_t                     changeCounter,
+                               IExecutor*                        pExecutor)
+{
+  assert(confidenceMap.empty() || confidenceMap.size() == map.size());
+
+  if (!m_isAllocated || changeCounter != m_changeCounter || map.size() != m_numPixels)
+  {
+    allocate(map.size());
+    m_changeCounter = changeCounter;
+  }
+
+  std::uint16_t*       pMap        = map.data();
+  const std::uint16_t* pConfidence = confidenceMap.empty() ? nullptr : confidenceMap.data();
+  const auto           applyRange  = [this, pMap, pConfidence](std::size_t begin, std::size_t end) {
+    if (m_parameters.mode == TEMPORAL_WINDOWED)
+    {
+      applyWindowedRange(pMap, pConfidence, begin, end);
+    }
+    else
+    {
+      applyExponentialRange(pMap, pConfidence, begin, end);
+    }
+  };
+  if (pExecutor == nullptr)
+  {
+    applyRange(0u, m_numPixels);
+  }
+  else
+  {
+    pExecutor->parallelFor(m_numPixels, applyRange);
+  }
+
+  if (m_parameters.mode == TEMPORAL_WINDOWED)
+  {
+    m_ringSlot  = (m_ringSlot + 1u) % m_parameters.windowSize;
+    m_numFrames = std::min(m_numFrames + 1u, m_parameters.windowSize);
+  }
+  else
+  {
+    ++m_numFrames;
+  }
+}
+
+void TemporalFilter::updateRegionOfInterest(const VisionaryData& data)
+{
+  // a region of the same size at another offset keeps the size of the map, but each pixel sees another point
+  const RegionOfInterest& roi = data.getRegionOfInterest();
+  if (m_roi.left != roi.left || m_roi.top != roi.top || m_roi.width != roi.width || m_roi.height != roi.height)
+  {
+    reset();
+    m_roi = roi;
+  }
+}
+
+void TemporalFilter::allocate(std::size_t numPixels)
+{
+  m_numPixels = numPixels;
+  m_numFrames = 0u;
+  m_ringSlot  = 0u;
+  if (m_parameters.mode == TEMPORAL_WINDOWED)
+  {
+    m_ringValues.assign(m_parameters.windowSize * numPixels, 0u);
+    m_ringWeights.assign(m_parameters.windowSize * numPixels, 0u);
+    m_ringWeightSum.assign(numPixels, 0u);
+    m_ringValueSum.assign(numPixels, 0u);
+  }
+  else
+  {
+    m_average.assign(numPixels, 0.0f);
+    m_weightSum.assign(numPixels, 0.0f);
+  }
+  m_isAllocated = true;
+}
+
+void TemporalFilter::applyExponentialRange(std::uint16_t*       pMap,
+                                           const std::uint16_t* pConfidence,
+                                           std::size_t          begin,
+                                           std::size_t          end)
+{
+  const float decay           = 1.0f - m_parameters.alpha;
+  const auto  motionThreshold = static_cast<float>(m_parameters.motionThreshold);
+  for (std::size_t i = begin; i < end; ++i)
+  {
+    if (isInvalidValue(pMap[i]))
+    {
+      continue;
+    }
+    const float value  = static_cast<float>(pMap[i]);
+    const float weight = (pConfidence == nullptr) ? 1.0f : static_cast<float>(pConfidence[i]);
+
+    float      average   = m_average[i];
+    float      weightSum = m_weightSum[i] * decay;
+    const bool hasMoved =
+      (motionThreshold > 0.0f) && (m_weightSum[i] > 0.0f) && (std::fabs(value - average) > motionThreshold);
+    weightSum = hasMoved ? 0.0f : weightSum;
+    weightSum += weight;
+    if (weightSum > 0.0f)
+    {
+      // weighted running average, the weight of the history decays with each frame
+      average += (weight / weightSum) * (value - average);
+      pMap[i] = static_cast<std::uint16_t>(average + 0.5f);
+    }
+    m_average[i]   = average;
+    m_weightSum[i] = weightSum;
+  }
+}
+
+void TemporalFilter::applyWindowedRange(std::uint16_t*       pMap,
+                                        const std::uint16_t* pConfidence,
+                                        std::size_t          begin,
+                                        std::size_t          end)
+{
+  const std::size_t   windowSize      = m_parameters.windowSize;
+  const std::size_t   slotOffset      = m_ringSlot * m_numPixels;
+  const std::uint32_t motionThreshold = m_parameters.motionThreshold;
+  for (std::size_t i = begin; i < end; ++i)
+  {
+    const std::uint16_t value  = pMap[i];
+    std::uint16_t       weight = (pConfidence == nullptr) ? std::uint16_t(1u) : pConfidence[i];
+    weight                     = isInvalidValue(value) ? std::uint16_t(0u) : weight;
+
+    // drop the oldest frame of the window
+    const std::uint16_t oldValue  = m_ringValues[slotOffset + i];
+    const std::uint16_t oldWeight = m_ringWeights[slotOffset + i];
+    std::uint32_t       weightSum = m_ringWeightSum[i] - oldWeight;
+    std::uint64_t       valueSum  = m_ringValueSum[i] - std::uint64_t(oldWeight) * oldValue;
+
+    if (motionThreshold > 0u && weight > 0u && weightSum > 0u)
+    {
+      const std::uint64_t average    = (valueSum + weightSum / 2u) / weightSum;
+      const std::uint64_t difference = (average > value) ? (average - value) : (value - average);
+      if (difference > motionThreshold)
+      {
+        for (std::size_t slot = 0u; slot < windowSize; ++slot)
+        {
+          m_ringWeights[slot * m_numPixels + i] = 0u;
+        }
+        weightSum = 0u;
+        valueSum  = 0u;
+      }
+    }
+
+    m_ringValues[slotOffset + i]  = value;
+    m_ringWeights[slotOffset + i] = weight;
+    weightSum += weight;
+    valueSum += std::uint64_t(weight) * value;
+    m_ringWeightSum[i] = weightSum;
+    m_ringValueSum[i]  = valueSum;
+
+    if (!isInvalidValue(value) && weightSum > 0u)
+    {
+      pMap[i] = static_cast<std::uint16_t>((valueSum + weightSum / 2u) / weightSum);
+    }
+  }
+}
+
+} // namespace visionary
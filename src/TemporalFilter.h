@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "IExecutor.h"
+#include "VisionaryData.h"
+
+namespace visionary {
+
+enum TemporalFilterMode
+{
+  /// Exponentially decaying average of all previous frames
+  TEMPORAL_EXPONENTIAL = 0,
+
+  /// Average of the last windowSize frames
+  TEMPORAL_WINDOWED = 1
+};
+
+/// Parameters of the TemporalFilter
+struct TemporalFilterParameters
+{
+  /// Kind of the per pixel average
+  TemporalFilterMode mode;
+  /// Number of frames of the TEMPORAL_WINDOWED average
+  std::size_t windowSize;
+  /// Weight of a new frame in the TEMPORAL_EXPONENTIAL average, in (0, 1]
+  float alpha;
+  /// A pixel whose new value differs from its average by more than this number of map values has moved, so its
+  /// history is discarded. 0 disables the motion check.
+  std::uint16_t motionThreshold;
+};
+
+/// \brief Per pixel average of the depth maps of consecutive frames
+///
+/// Reduces the temporal noise of static scenes. Each valid pixel of a new map is replaced by the average of its
+/// values in the previous frames, weighted with the confidence of each value if a confidence map is given.
+/// Map values 0 and 0xFFFF are invalid: they are not added to the history and stay unchanged in the output.
+///
+/// Typical use with a FrameGrabber of a Visionary-T:
+/// \code
+/// std::shared_ptr<VisionaryTData> pDataHandler;
+/// grabber.getNextFrame(pDataHandler);
+/// filter.apply(*pDataHandler, pDataHandler->getConfidenceMap());
+/// pDataHandler->generatePointCloud(pointCloud);
+/// \endcode
+///
+/// The history is kept in a ring which is allocated on the first frame and again only if the change counter or the
+/// size of the map changes, or the region of interest of the data handler. An instance must not be used by several
+/// threads at the same time.
+class TemporalFilter
+{
+public:
+  explicit TemporalFilter(const TemporalFilterParameters& parameters);
+
+  /// Add the distance map the point clouds of the data handler are calculated from to the history and replace it by
+  /// the per pixel average
+  ///
+  /// \param[in,out] data          data handler of the new frame, its getPointCloudSourceMap() is filtered
+  /// \param[in]     confidenceMap confidence of each pixel used as weight, or empty for equal weights
+  void apply(VisionaryData& data, const std::vector<std::uint16_t>& confidenceMap);
+  /// \copydoc apply(VisionaryData&, const std::vector<std::uint16_t>&)
+  /// \param[in] executor executor processing ranges of pixels in parallel
+  void apply(VisionaryData& data, const std::vector<std::uint16_t>& confidenceMap, IExecutor& executor);
+
+  /// Add the map to the history and replace it by the per pixel average
+  ///
+  /// \param[in,out] map           depth map of the new frame
+  /// \param[in]     confidenceMap confidence of each pixel used as weight, or empty for equal weights
+  /// \param[in]     changeCounter change counter of the frame, the history is discarded when it changes
+  ///
+  /// Call reset() if the pixels of the map move without a change of its size, e.g. by a new region of interest.
+  void apply(std::vector<std::uint16_t>&       map,
+             const std::vector<std::uint16_t>& confidenceMap,
+             std::uint32_t                     changeCounter);
+  /// \copydoc apply(std::vector<std::uint16_t>&, const std::vector<std::uint16_t>&, std::uint32_t)
+  /// \param[in] executor executor processing ranges of pixels in parallel
+  void apply(std::vector<std::uint16_t>&       map,
+             const std::vector<std::uint16_t>& confidenceMap,
+             std::uint32_t                     changeCounter,
+             IExecutor&                        executor);
+
+  /// Discard the history, the next frame starts a new average
+  void reset();
+
+  /// Returns the number of frames in the history (limited to the window size in TEMPORAL_WINDOWED mode)
+  std::size_t getNumFrames() const;
+
+private:
+  void applyImpl(std::vector<std::uint16_t>&       map,
+                 const std::vector<std::uint16_t>& confidenceMap,
+                 std::uint32_t                     changeCounter,
+                 IExecutor*                        pExecutor);
+
+  // Discard the history if the region of interest of the data handler changed
+  void updateRegionOfInterest(const VisionaryData& data);
+
+  // Allocate the history for maps of numPixels pixels
+  void allocate(std::size_t numPixels);
+
+  void applyExponentialRange(std::uint16_t* pMap, const std::uint16_t* pConfidence, std::size_t begin, std::size_t end);
+  void applyWindowedRange(std::uint16_t* pMap, const std::uint16_t* pConfidence, std::size_t begin, std::size_t end);
+
+  TemporalFilterParameters m_parameters;
+
+  bool          m_isAllocated;
+  std::uint32_t m_changeCounter;
+  std::size_t   m_numPixels;
+  std::size_t   m_numFrames;
+  // region of interest of the data handler of the history
+  RegionOfInterest m_roi;
+
+  // TEMPORAL_EXPONENTIAL: average and decayed sum of the weights of each pixel
+  std::vector<float> m_average;
+  std::vector<float> m_weightSum;
+
+  // TEMPORAL_WINDOWED: ring of windowSize maps and weights (slot-major) and the sums over the ring of each pixel
+  std::vector<std::uint16_t> m_ringValues;
+  std::vector<std::uint16_t> m_ringWeights;
+  std::vector<std::uint32_t> m_ringWeightSum;
+  std::vector<std::uint64_t> m_ringValueSum;
+  // slot of the ring receiving the current frame
+  std::size_t m_ringSlot;
+};
+
+} // namespace visionary
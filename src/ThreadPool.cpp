@@ -0,0 +1,165 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace visionary {
+
+namespace {
+// pool whose range the current thread is processing, nested execute() calls on it run inline
+thread_local const ThreadPool* t_pCurrentPool = nullptr;
+
+// marks the current thread as working for a pool while it processes a range, also if the range throws
+class CurrentPoolGuard
+{
+public:
+  explicit CurrentPoolGuard(const ThreadPool* pPool) : m_pPrevious(t_pCurrentPool)
+  {
+    t_pCurrentPool = pPool;
+  }
+  ~CurrentPoolGuard()
+  {
+    t_pCurrentPool = m_pPrevious;
+  }
+  CurrentPoolGuard(const CurrentPoolGuard&)            = delete;
+  CurrentPoolGuard& operator=(const CurrentPoolGuard&) = delete;
+
+private:
+  const ThreadPool* m_pPrevious;
+};
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t numThreads)
+  : m_numThreads(std::max<std::size_t>(
+    1u, (numThreads == 0u) ? static_cast<std::size_t>(std::thread::hardware_concurrency()) : numThreads))
+  , m_isRunning(true)
+  , m_generation(0u)
+  , m_numPending(0u)
+  , m_function(nullptr)
+  , m_pContext(nullptr)
+  , m_count(0u)
+{
+  m_workers.reserve(m_numThreads - 1u);
+  for (std::size_t i = 1u; i < m_numThreads; ++i)
+  {
+    m_workers.emplace_back(&ThreadPool::run, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_isRunning = false;
+  }
+  m_startCv.notify_all();
+  for (auto& worker : m_workers)
+  {
+    worker.join();
+  }
+}
+
+std::size_t ThreadPool::getConcurrency() const
+{
+  return m_numThreads;
+}
+
+void ThreadPool::execute(std::size_t count, RangeFunction function, void* pContext)
+{
+  if (count == 0u)
+  {
+    return;
+  }
+  // a range calling execute() again can't wait for the other threads, they may be busy with the outer job
+  if (m_workers.empty() || count == 1u || t_pCurrentPool == this)
+  {
+    function(pContext, 0u, count);
+    return;
+  }
+
+  std::lock_guard<std::mutex> executeGuard(m_executeMutex);
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_function   = function;
+    m_pContext   = pContext;
+    m_count      = count;
+    m_numPending = m_workers.size();
+    m_exception  = nullptr;
+    ++m_generation;
+  }
+  m_startCv.notify_all();
+
+  processRange(0u);
+
+  // the workers use the function and the context of the caller until all of them are done, also after an exception
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> guard(m_mutex);
+    m_doneCv.wait(guard, [this] { return m_numPending == 0u; });
+    std::swap(exception, m_exception);
+  }
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+void ThreadPool::processRange(std::size_t threadIndex)
+{
+  // contiguous ranges of (almost) equal size, the first ranges get one element less on uneven splits
+  const std::size_t begin = (m_count * threadIndex) / m_numThreads;
+  const std::size_t end   = (m_count * (threadIndex + 1u)) / m_numThreads;
+  if (begin < end)
+  {
+    try
+    {
+      const CurrentPoolGuard currentPoolGuard(this);
+      m_function(m_pContext, begin, end);
+    }
+    catch (...)
+    {
+      // keep the first exception for the caller of execute
+      std::lock_guard<std::mutex> guard(m_mutex);
+      if (!m_exception)
+      {
+        m_exception = std::current_exception();
+      }
+    }
+  }
+}
+
+void ThreadPool::run(std::size_t threadIndex)
+{
+  std::uint64_t lastGeneration = 0u;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> guard(m_mutex);
+      m_startCv.wait(guard, [this, lastGeneration] { return !m_isRunning || m_generation != lastGeneration; });
+      if (!m_isRunning)
+      {
+        return;
+      }
+      lastGeneration = m_generation;
+    }
+
+    processRange(threadIndex);
+
+    bool isLast = false;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      isLast = (--m_numPending == 0u);
+    }
+    if (isLast)
+    {
+      m_doneCv.notify_one();
+    }
+  }
+}
+
+} // namespace visionary
@@ -0,0 +1,68 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "IExecutor.h"
+
+namespace visionary {
+
+/// \brief Fixed size pool of worker threads implementing the IExecutor interface.
+///
+/// The index range of an execute() call is split into one contiguous range per thread. The calling thread processes
+/// the first range itself, so a pool of size 1 runs everything sequentially without any thread switch.
+/// Dispatching work does not allocate memory. The first exception thrown by a range is rethrown by execute() once
+/// all threads are done. A range calling execute() or parallelFor() on the same pool again processes the nested
+/// range inline on its own thread. Ranges calling each other across two pools are not supported.
+class ThreadPool : public IExecutor
+{
+public:
+  /// Create the pool
+  ///
+  /// \param[in] numThreads number of threads working on a range including the calling thread.
+  ///                       0 uses the number of hardware threads.
+  explicit ThreadPool(std::size_t numThreads = 0u);
+  ~ThreadPool() override;
+
+  ThreadPool(const ThreadPool&)            = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  std::size_t getConcurrency() const override;
+  void        execute(std::size_t count, RangeFunction function, void* pContext) override;
+
+private:
+  void run(std::size_t threadIndex);
+  void processRange(std::size_t threadIndex);
+
+  std::vector<std::thread> m_workers;
+  const std::size_t        m_numThreads;
+
+  // serializes concurrent execute() calls from different threads
+  std::mutex m_executeMutex;
+
+  std::mutex              m_mutex;
+  std::condition_variable m_startCv;
+  std::condition_variable m_doneCv;
+  bool                    m_isRunning;
+  std::uint64_t           m_generation;
+  std::size_t             m_numPending;
+
+  // the job of the current generation
+  RangeFunction m_function;
+  void*         m_pContext;
+  std::size_t   m_count;
+  // first exception thrown by a range of the current job
+  std::exception_ptr m_exception;
+};
+
+} // namespace visionary
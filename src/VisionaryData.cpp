@@ -16,17 +16,61 @@
 #include <limits>
 #include <sstream>
 
+#include "NumericConv.h"
+
 namespace visionary {
 
 const float bad_point = std::numeric_limits<float>::quiet_NaN();
 
+// Number of pixels covered by one word of the validity mask of a compact point cloud
+const size_t kPixelsPerMaskWord = 64u;
+
+// Round a coordinate given in units of the quantization scale to the coordinate type.
+// The lowest value of the type is reserved for invalid points, so it is never returned.
+template <typename T>
+T quantize(double value)
+{
+  const T quantized = castClamped<T>(std::floor(value + 0.5));
+  return std::max(quantized, static_cast<T>(QuantizedPointXYZ<T>::invalid() + 1));
+}
+
+// Store the values of a chunk into a field of consecutive points of a layout, clamped to the range of the type
+template <typename T>
+void storeFieldValues(const uint32_t* pValues, size_t numValues, uint8_t* pField, size_t stride)
+{
+  for (size_t i = 0u; i < numValues; ++i)
+  {
+    const T value = castClamped<T>(pValues[i]);
+    std::memcpy(pField + i * stride, &value, sizeof(T));
+  }
+}
+
+template <>
+void storeFieldValues<float>(const uint32_t* pValues, size_t numValues, uint8_t* pField, size_t stride)
+{
+  for (size_t i = 0u; i < numValues; ++i)
+  {
+    const auto value = static_cast<float>(pValues[i]);
+    std::memcpy(pField + i * stride, &value, sizeof(float));
+  }
+}
+
+constexpr size_t VisionaryData::kPointChunkSize;
+
 VisionaryData::VisionaryData()
   : m_scaleZ(0.0f)
   , m_changeCounter(0u)
   , m_frameNum(0u)
   , m_blobTimestamp(0u)
   , m_preCalcCamInfoType(VisionaryData::UNKNOWN)
+  , m_preCalcWorldInfoValid(false)
+  , m_preCalcWorldOffset()
 {
+  m_validityPolicy.minDistance      = 0.0f;
+  m_validityPolicy.maxDistance      = std::numeric_limits<float>::infinity();
+  m_validityPolicy.minConfidence    = 0u;
+  m_validityPolicy.invalidStateMask = 0u;
+
   m_cameraParams.width  = 0;
   m_cameraParams.height = 0;
 }
@@ -70,16 +114,16 @@ void VisionaryData::preCalcCamInfo(const ImageType& imgType)
   assert(m_cameraParams.width > 0);
 
   m_preCalcCamInfo.clear();
-  m_preCalcCamInfo.reserve(static_cast<size_t>(m_cameraParams.height * m_cameraParams.width));
+  m_preCalcCamInfo.reserve(static_cast<size_t>(m_roi.height * m_roi.width));
 
   //-----------------------------------------------
-  // transform each pixel into Cartesian coordinates
-  for (int row = 0; row < m_cameraParams.height; row++)
+  // transform each pixel of the region of interest into Cartesian coordinates
+  for (int row = m_roi.top; row < m_roi.top + m_roi.height; row++)
   {
     double yp  = (m_cameraParams.cy - row) / m_cameraParams.fy;
     double yp2 = yp * yp;
 
-    for (int col = 0; col < m_cameraParams.width; col++)
+    for (int col = m_roi.left; col < m_roi.left + m_roi.width; col++)
     {
       // we map from image coordinates with origin top left and x
       // horizontal (right) and y vertical
@@ -119,7 +163,86 @@ void VisionaryData::preCalcCamInfo(const ImageType& imgType)
       m_preCalcCamInfo.push_back(point);
     }
   }
-  m_preCalcCamInfoType = imgType;
+
+  m_preCalcCamInfoSoA.resize(m_preCalcCamInfo.size());
+  for (size_t i = 0; i < m_preCalcCamInfo.size(); ++i)
+  {
+    m_preCalcCamInfoSoA.x[i] = m_preCalcCamInfo[i].x;
+    m_preCalcCamInfoSoA.y[i] = m_preCalcCamInfo[i].y;
+    m_preCalcCamInfoSoA.z[i] = m_preCalcCamInfo[i].z;
+  }
+  m_preCalcCamInfoType    = imgType;
+  m_preCalcWorldInfoValid = false;
+}
+
+void VisionaryData::preCalcWorldInfo()
+{
+  const double* m = m_cameraParams.cam2worldMatrix;
+
+  m_preCalcWorldInfo.resize(m_preCalcCamInfo.size());
+  for (size_t i = 0; i < m_preCalcCamInfo.size(); ++i)
+  {
+    const double x = m_preCalcCamInfo[i].x;
+    const double y = m_preCalcCamInfo[i].y;
+    const double z = m_preCalcCamInfo[i].z;
+
+    m_preCalcWorldInfo[i].x = static_cast<float>(x * m[0] + y * m[1] + z * m[2]);
+    m_preCalcWorldInfo[i].y = static_cast<float>(x * m[4] + y * m[5] + z * m[6]);
+    m_preCalcWorldInfo[i].z = static_cast<float>(x * m[8] + y * m[9] + z * m[10]);
+  }
+
+  // The camera point is (d * dir - (0, 0, f2rc)), so the focal to ray cross correction becomes a constant offset
+  // along the rotated z axis. Translations and f2rc are turned from [mm] to [m].
+  const double f2rc = m_cameraParams.f2rc / 1000.;
+
+  m_preCalcWorldOffset.x = static_cast<float>(m[3] / 1000. - f2rc * m[2]);
+  m_preCalcWorldOffset.y = static_cast<float>(m[7] / 1000. - f2rc * m[6]);
+  m_preCalcWorldOffset.z = static_cast<float>(m[11] / 1000. - f2rc * m[10]);
+
+  m_preCalcWorldInfoValid = true;
+}
+
+bool VisionaryData::updateCamLookUpTable(const std::vector<uint16_t>& map, const ImageType& imgType)
+{
+  if (m_preCalcCamInfoType != imgType)
+  {
+    preCalcCamInfo(imgType);
+  }
+  // the maps of a rejected frame can still have the size of the previous region of interest
+  return m_preCalcCamInfo.size() == map.size();
+}
+
+bool VisionaryData::updateWorldLookUpTables(const std::vector<uint16_t>& map)
+{
+  if (!updateCamLookUpTable(map, getPointCloudImageType()))
+  {
+    return false;
+  }
+  if (!m_preCalcWorldInfoValid)
+  {
+    preCalcWorldInfo();
+  }
+  return true;
+}
+
+template <class TFunction>
+void VisionaryData::parallelForRows(IExecutor& executor, size_t numPoints, const TFunction& function) const
+{
+  const auto width = static_cast<size_t>(m_roi.width);
+  if (numPoints == 0u || width == 0u)
+  {
+    return;
+  }
+  const size_t numRows = (numPoints + width - 1u) / width;
+
+  executor.parallelFor(numRows, [&function, width, numPoints](size_t rowBegin, size_t rowEnd) {
+    function(rowBegin * width, std::min(rowEnd * width, numPoints));
+  });
+}
+
+void VisionaryData::generatePointCloud(std::vector<PointXYZ>& pointCloud, IExecutor&)
+{
+  generatePointCloud(pointCloud);
 }
 
 void VisionaryData::generatePointCloud(const std::vector<uint16_t>& map,
@@ -127,29 +250,55 @@ void VisionaryData::generatePointCloud(const std::vector<uint16_t>& map,
                                        std::vector<PointXYZ>&       pointCloud)
 {
   // Calculate disortion data from XML metadata once.
-  if (m_preCalcCamInfoType != imgType)
+  if (!updateCamLookUpTable(map, imgType))
   {
-    preCalcCamInfo(imgType);
+    pointCloud.clear();
+    return;
   }
   size_t cloudSize = map.size();
   pointCloud.resize(cloudSize);
 
+  generatePointCloudRange(getPixelValidator(map), pointCloud.data(), 0u, cloudSize);
+}
+
+void VisionaryData::generatePointCloud(const std::vector<uint16_t>& map,
+                                       const ImageType&             imgType,
+                                       std::vector<PointXYZ>&       pointCloud,
+                                       IExecutor&                   executor)
+{
+  // Calculate disortion data from XML metadata once, before the bands are processed concurrently.
+  if (!updateCamLookUpTable(map, imgType))
+  {
+    pointCloud.clear();
+    return;
+  }
+  pointCloud.resize(map.size());
+
+  const PixelValidator validator   = getPixelValidator(map);
+  PointXYZ*            pPointCloud = pointCloud.data();
+  parallelForRows(executor, map.size(), [this, &validator, pPointCloud](size_t begin, size_t end) {
+    generatePointCloudRange(validator, pPointCloud + begin, begin, end);
+  });
+}
+
+void VisionaryData::generatePointCloudRange(const PixelValidator& validator,
+                                            PointXYZ*             pPointCloud,
+                                            size_t                begin,
+                                            size_t                end) const
+{
   const auto f2rc = static_cast<float>(m_cameraParams.f2rc / 1000.f); // PointCloud should be in [m] and not in [mm]
 
   const float pixelSizeZ = m_scaleZ;
 
   //-----------------------------------------------
   // transform each pixel into Cartesian coordinates
-  auto itMap         = map.begin();
-  auto itUndistorted = m_preCalcCamInfo.begin();
-  auto itPC          = pointCloud.begin();
-  for (uint32_t i = 0; i < cloudSize; ++i, ++itPC, ++itMap, ++itUndistorted)
-  // for (std::vector<PointXYZ>::iterator itPC = pointCloud.begin(), itEnd = pointCloud.end(); itPC != itEnd; ++itPC,
-  // ++itMap, ++itUndistorted)
+  const uint16_t* pMap         = validator.pDistance;
+  const PointXYZ* pUndistorted = m_preCalcCamInfo.data();
+  for (size_t i = begin; i < end; ++i)
   {
     PointXYZ point{};
     // If point is valid put it to point cloud
-    if (*itMap == 0 || *itMap == uint16_t(0xFFFF))
+    if (!validator.isValid(i))
     {
       point.x = bad_point;
       point.y = bad_point;
@@ -158,46 +307,749 @@ void VisionaryData::generatePointCloud(const std::vector<uint16_t>& map,
     else
     {
       // calculate coordinates & store in point cloud vector
-      float distance = static_cast<float>((*itMap)) * pixelSizeZ;
-      point.x        = itUndistorted->x * distance;
-      point.y        = itUndistorted->y * distance;
-      point.z        = itUndistorted->z * distance - f2rc;
+      float distance = static_cast<float>(pMap[i]) * pixelSizeZ;
+      point.x        = pUndistorted[i].x * distance;
+      point.y        = pUndistorted[i].y * distance;
+      point.z        = pUndistorted[i].z * distance - f2rc;
+    }
+    pPointCloud[i - begin] = point;
+  }
+}
+
+void VisionaryData::generateWorldPointCloud(std::vector<PointXYZ>& pointCloud)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (!updateWorldLookUpTables(map))
+  {
+    pointCloud.clear();
+    return;
+  }
+  pointCloud.resize(map.size());
+
+  generateWorldPointCloudRange(getPixelValidator(map), pointCloud.data(), 0u, map.size());
+}
+
+void VisionaryData::generateWorldPointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (!updateWorldLookUpTables(map))
+  {
+    pointCloud.clear();
+    return;
+  }
+  pointCloud.resize(map.size());
+
+  const PixelValidator validator   = getPixelValidator(map);
+  PointXYZ*            pPointCloud = pointCloud.data();
+  parallelForRows(executor, map.size(), [this, &validator, pPointCloud](size_t begin, size_t end) {
+    generateWorldPointCloudRange(validator, pPointCloud + begin, begin, end);
+  });
+}
+
+size_t VisionaryData::generatePointCloudInto(PointXYZ* pPoints, size_t capacity)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (map.size() > capacity || !updateCamLookUpTable(map, getPointCloudImageType()))
+  {
+    return 0u;
+  }
+
+  generatePointCloudRange(getPixelValidator(map), pPoints, 0u, map.size());
+  return map.size();
+}
+
+size_t VisionaryData::generatePointCloudInto(PointXYZ* pPoints, size_t capacity, IExecutor& executor)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (map.size() > capacity || !updateCamLookUpTable(map, getPointCloudImageType()))
+  {
+    return 0u;
+  }
+
+  const PixelValidator validator = getPixelValidator(map);
+  parallelForRows(executor, map.size(), [this, &validator, pPoints](size_t begin, size_t end) {
+    generatePointCloudRange(validator, pPoints + begin, begin, end);
+  });
+  return map.size();
+}
+
+size_t VisionaryData::generateWorldPointCloudInto(PointXYZ* pPoints, size_t capacity)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (map.size() > capacity || !updateWorldLookUpTables(map))
+  {
+    return 0u;
+  }
+
+  generateWorldPointCloudRange(getPixelValidator(map), pPoints, 0u, map.size());
+  return map.size();
+}
+
+size_t VisionaryData::generateWorldPointCloudInto(PointXYZ* pPoints, size_t capacity, IExecutor& executor)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (map.size() > capacity || !updateWorldLookUpTables(map))
+  {
+    return 0u;
+  }
+
+  const PixelValidator validator = getPixelValidator(map);
+  parallelForRows(executor, map.size(), [this, &validator, pPoints](size_t begin, size_t end) {
+    generateWorldPointCloudRange(validator, pPoints + begin, begin, end);
+  });
+  return map.size();
+}
+
+size_t VisionaryData::generateLayoutPointCloud(const PointLayout& layout,
+                                               void*              pBuffer,
+                                               size_t             capacity,
+                                               bool               worldCoordinates)
+{
+  return generateLayoutPointCloudImpl(layout, pBuffer, capacity, worldCoordinates, nullptr);
+}
+
+size_t VisionaryData::generateLayoutPointCloud(const PointLayout& layout,
+                                               void*              pBuffer,
+                                               size_t             capacity,
+                                               IExecutor&         executor,
+                                               bool               worldCoordinates)
+{
+  return generateLayoutPointCloudImpl(layout, pBuffer, capacity, worldCoordinates, &executor);
+}
+
+size_t VisionaryData::generateLayoutPointCloudImpl(const PointLayout& layout,
+                                                   void*              pBuffer,
+                                                   size_t             capacity,
+                                                   bool               worldCoordinates,
+                                                   IExecutor*         pExecutor)
+{
+  const size_t   numPoints = getPointCloudMap().size();
+  PixelValidator validator{};
+  if (numPoints > capacity || !preparePointChunks(worldCoordinates, validator))
+  {
+    return 0u;
+  }
+  auto* pBytes = static_cast<uint8_t*>(pBuffer);
+
+  if (pExecutor == nullptr)
+  {
+    generateLayoutRange(layout, validator, worldCoordinates, pBytes, 0u, numPoints);
+  }
+  else
+  {
+    parallelForRows(
+      *pExecutor, numPoints, [this, &layout, &validator, worldCoordinates, pBytes](size_t begin, size_t end) {
+        generateLayoutRange(layout, validator, worldCoordinates, pBytes, begin, end);
+      });
+  }
+  return numPoints;
+}
+
+bool VisionaryData::preparePointChunks(bool worldCoordinates, PixelValidator& validator)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (worldCoordinates ? !updateWorldLookUpTables(map) : !updateCamLookUpTable(map, getPointCloudImageType()))
+  {
+    return false;
+  }
+  validator = getPixelValidator(map);
+  return true;
+}
+
+void VisionaryData::generatePointChunk(const PixelValidator& validator,
+                                       bool                  worldCoordinates,
+                                       PointXYZ*             pChunk,
+                                       size_t                begin,
+                                       size_t                end) const
+{
+  if (worldCoordinates)
+  {
+    generateWorldPointCloudRange(validator, pChunk, begin, end);
+  }
+  else
+  {
+    generatePointCloudRange(validator, pChunk, begin, end);
+  }
+}
+
+void VisionaryData::generateLayoutRange(const PointLayout&    layout,
+                                        const PixelValidator& validator,
+                                        bool                  worldCoordinates,
+                                        uint8_t*              pBuffer,
+                                        size_t                begin,
+                                        size_t                end) const
+{
+  const std::vector<uint16_t>& map           = getPointCloudMap();
+  const std::vector<uint16_t>& intensityMap  = getPointCloudIntensityMap();
+  const std::vector<uint16_t>& confidenceMap = getPointCloudConfidenceMap();
+  const std::vector<uint32_t>& rgbaMap       = getPointCloudRGBAMap();
+  const size_t                 stride        = layout.stride;
+
+  // The points are calculated in chunks, then each field is written for the whole chunk in a tight loop
+  PointXYZ chunk[kPointChunkSize];
+  uint32_t values[kPointChunkSize];
+  for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += kPointChunkSize)
+  {
+    const size_t numValues = std::min(end - chunkBegin, size_t(kPointChunkSize));
+    generatePointChunk(validator, worldCoordinates, chunk, chunkBegin, chunkBegin + numValues);
+    uint8_t* pChunkBuffer = pBuffer + chunkBegin * stride;
+
+    for (const PointField& field : layout.fields)
+    {
+      uint8_t* pField = pChunkBuffer + field.offset;
+      if (field.source <= FIELD_Z)
+      {
+        assert(field.type == FIELD_FLOAT32); // coordinates are always float
+        const size_t coordinateOffset = (field.source == FIELD_X)   ? offsetof(PointXYZ, x)
+                                        : (field.source == FIELD_Y) ? offsetof(PointXYZ, y)
+                                                                    : offsetof(PointXYZ, z);
+        const uint8_t* pCoordinates = reinterpret_cast<const uint8_t*>(chunk) + coordinateOffset;
+        for (size_t i = 0u; i < numValues; ++i)
+        {
+          std::memcpy(pField + i * stride, pCoordinates + i * sizeof(PointXYZ), sizeof(float));
+        }
+        continue;
+      }
+
+      for (size_t i = 0u; i < numValues; ++i)
+      {
+        const size_t pixel = chunkBegin + i;
+        uint32_t     value = 0u;
+        switch (field.source)
+        {
+          case FIELD_INTENSITY:
+            value = (intensityMap.size() == map.size()) ? intensityMap[pixel] : 0u;
+            break;
+          case FIELD_CONFIDENCE:
+            value = (confidenceMap.size() == map.size()) ? confidenceMap[pixel] : 0u;
+            break;
+          case FIELD_RGBA:
+            value = (rgbaMap.size() == map.size()) ? rgbaMap[pixel] : 0u;
+            break;
+          default:
+            value = static_cast<uint32_t>(pixel);
+            break;
+        }
+        values[i] = value;
+      }
+      switch (field.type)
+      {
+        case FIELD_FLOAT32:
+          storeFieldValues<float>(values, numValues, pField, stride);
+          break;
+        case FIELD_UINT8:
+          storeFieldValues<uint8_t>(values, numValues, pField, stride);
+          break;
+        case FIELD_UINT16:
+          storeFieldValues<uint16_t>(values, numValues, pField, stride);
+          break;
+        default:
+          storeFieldValues<uint32_t>(values, numValues, pField, stride);
+          break;
+      }
+    }
+  }
+}
+
+bool VisionaryData::prepareWorldPoints(PixelValidator& validator)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (!updateWorldLookUpTables(map))
+  {
+    return false;
+  }
+  validator = getPixelValidator(map);
+  return true;
+}
+
+void VisionaryData::generateWorldPoints(const PixelValidator& validator,
+                                        size_t                begin,
+                                        size_t                end,
+                                        PointXYZ*             pPoints) const
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  assert(m_preCalcWorldInfoValid && m_preCalcWorldInfo.size() == map.size()); // prepareWorldPoints must be called
+  assert(validator.pDistance == map.data());
+  assert(begin <= end && end <= map.size());
+  (void)map;
+
+  generateWorldPointCloudRange(validator, pPoints, begin, end);
+}
+
+size_t VisionaryData::getPointCloudSize() const
+{
+  return getPointCloudMap().size();
+}
+
+void VisionaryData::generateWorldPointCloudRange(const PixelValidator& validator,
+                                                 PointXYZ*             pPoints,
+                                                 size_t                begin,
+                                                 size_t                end) const
+{
+  const float    pixelSizeZ = m_scaleZ;
+  const PointXYZ offset     = m_preCalcWorldOffset;
+
+  //-----------------------------------------------
+  // scale the rotated direction of each pixel and move it by the offset
+  const uint16_t* pMap       = validator.pDistance;
+  const PointXYZ* pDirection = m_preCalcWorldInfo.data();
+  for (size_t i = begin; i < end; ++i)
+  {
+    PointXYZ point{};
+    // If point is valid put it to point cloud
+    if (!validator.isValid(i))
+    {
+      point.x = bad_point;
+      point.y = bad_point;
+      point.z = bad_point;
+    }
+    else
+    {
+      float distance = static_cast<float>(pMap[i]) * pixelSizeZ;
+      point.x        = pDirection[i].x * distance + offset.x;
+      point.y        = pDirection[i].y * distance + offset.y;
+      point.z        = pDirection[i].z * distance + offset.z;
+    }
+    pPoints[i - begin] = point;
+  }
+}
+
+void VisionaryData::generatePointCloudSoA(PointCloudSoA& pointCloud)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (!updateCamLookUpTable(map, getPointCloudImageType()))
+  {
+    pointCloud.resize(0u);
+    return;
+  }
+  pointCloud.resize(map.size());
+
+  generatePointCloudSoARange(getPixelValidator(map), pointCloud, 0u, map.size());
+}
+
+void VisionaryData::generatePointCloudSoA(PointCloudSoA& pointCloud, IExecutor& executor)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (!updateCamLookUpTable(map, getPointCloudImageType()))
+  {
+    pointCloud.resize(0u);
+    return;
+  }
+  pointCloud.resize(map.size());
+
+  const PixelValidator validator = getPixelValidator(map);
+  parallelForRows(executor, map.size(), [this, &validator, &pointCloud](size_t begin, size_t end) {
+    generatePointCloudSoARange(validator, pointCloud, begin, end);
+  });
+}
+
+void VisionaryData::generatePointCloudSoARange(const PixelValidator& validator,
+                                               PointCloudSoA&        pointCloud,
+                                               size_t                begin,
+                                               size_t                end) const
+{
+  const auto f2rc = static_cast<float>(m_cameraParams.f2rc / 1000.f); // PointCloud should be in [m] and not in [mm]
+
+  const float pixelSizeZ = m_scaleZ;
+
+  const uint16_t* pMap  = validator.pDistance;
+  const float*    pDirX = m_preCalcCamInfoSoA.x.data();
+  const float*    pDirY = m_preCalcCamInfoSoA.y.data();
+  const float*    pDirZ = m_preCalcCamInfoSoA.z.data();
+  float*          pX    = pointCloud.x.data();
+  float*          pY    = pointCloud.y.data();
+  float*          pZ    = pointCloud.z.data();
+
+  //-----------------------------------------------
+  // Branch free loop over contiguous planes so the compiler can vectorize it:
+  // invalid pixels get a NaN distance, which propagates into all coordinates.
+  for (size_t i = begin; i < end; ++i)
+  {
+    const bool  isValid  = validator.isValid(i);
+    const float distance = isValid ? static_cast<float>(pMap[i]) * pixelSizeZ : bad_point;
+
+    pX[i] = pDirX[i] * distance;
+    pY[i] = pDirY[i] * distance;
+    pZ[i] = pDirZ[i] * distance - f2rc;
+  }
+}
+
+void VisionaryData::generateCompactPointCloud(CompactPointCloud& pointCloud)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (!updateCamLookUpTable(map, getPointCloudImageType()))
+  {
+    resizeCompactMask(pointCloud, 0u);
+    accumulateCompactOffsets(pointCloud);
+    return;
+  }
+  resizeCompactMask(pointCloud, map.size());
+
+  const size_t numWords = pointCloud.validMask.size();
+  generateCompactMaskRange(getPixelValidator(map), map.size(), pointCloud, 0u, numWords);
+  accumulateCompactOffsets(pointCloud);
+  generateCompactPointRange(map.data(), map.size(), pointCloud, 0u, numWords);
+}
+
+void VisionaryData::generateCompactPointCloud(CompactPointCloud& pointCloud, IExecutor& executor)
+{
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (!updateCamLookUpTable(map, getPointCloudImageType()))
+  {
+    resizeCompactMask(pointCloud, 0u);
+    accumulateCompactOffsets(pointCloud);
+    return;
+  }
+  resizeCompactMask(pointCloud, map.size());
+
+  // The work is split at mask word boundaries, so no two threads write to the same word or point.
+  const PixelValidator validator = getPixelValidator(map);
+  const uint16_t*      pMap      = map.data();
+  const size_t         numPixels = map.size();
+  executor.parallelFor(pointCloud.validMask.size(), [&validator, numPixels, &pointCloud](size_t begin, size_t end) {
+    generateCompactMaskRange(validator, numPixels, pointCloud, begin, end);
+  });
+  accumulateCompactOffsets(pointCloud);
+  executor.parallelFor(pointCloud.validMask.size(), [this, pMap, numPixels, &pointCloud](size_t begin, size_t end) {
+    generateCompactPointRange(pMap, numPixels, pointCloud, begin, end);
+  });
+}
+
+void VisionaryData::resizeCompactMask(CompactPointCloud& pointCloud, size_t numPixels)
+{
+  const size_t numWords = (numPixels + kPixelsPerMaskWord - 1u) / kPixelsPerMaskWord;
+  pointCloud.validMask.resize(numWords);
+  pointCloud.maskOffsets.resize(numWords);
+}
+
+void VisionaryData::generateCompactMaskRange(const PixelValidator& validator,
+                                             size_t                numPixels,
+                                             CompactPointCloud&    pointCloud,
+                                             size_t                wordBegin,
+                                             size_t                wordEnd)
+{
+  for (size_t word = wordBegin; word < wordEnd; ++word)
+  {
+    const size_t pixelBegin = word * kPixelsPerMaskWord;
+    const size_t numBits    = std::min(kPixelsPerMaskWord, numPixels - pixelBegin);
+
+    uint64_t bits = 0u;
+    for (size_t bit = 0u; bit < numBits; ++bit)
+    {
+      bits |= static_cast<uint64_t>(validator.isValid(pixelBegin + bit)) << bit;
+    }
+    pointCloud.validMask[word]   = bits;
+    pointCloud.maskOffsets[word] = static_cast<uint32_t>(CompactPointCloud::countBits(bits));
+  }
+}
+
+void VisionaryData::accumulateCompactOffsets(CompactPointCloud& pointCloud)
+{
+  uint32_t numPoints = 0u;
+  for (auto& offset : pointCloud.maskOffsets)
+  {
+    const uint32_t numWordPoints = offset;
+    offset                       = numPoints;
+    numPoints += numWordPoints;
+  }
+  pointCloud.points.resize(numPoints);
+  pointCloud.pixelIndices.resize(numPoints);
+}
+
+void VisionaryData::generateCompactPointRange(const uint16_t*    pMap,
+                                              size_t             numPixels,
+                                              CompactPointCloud& pointCloud,
+                                              size_t             wordBegin,
+                                              size_t             wordEnd) const
+{
+  const auto f2rc = static_cast<float>(m_cameraParams.f2rc / 1000.f); // PointCloud should be in [m] and not in [mm]
+
+  const float pixelSizeZ = m_scaleZ;
+
+  const PointXYZ* pUndistorted = m_preCalcCamInfo.data();
+  for (size_t word = wordBegin; word < wordEnd; ++word)
+  {
+    const size_t pixelBegin = word * kPixelsPerMaskWord;
+    const size_t pixelEnd   = std::min(pixelBegin + kPixelsPerMaskWord, numPixels);
+    uint64_t     bits       = pointCloud.validMask[word];
+    size_t       pointIndex = pointCloud.maskOffsets[word];
+
+    // left-pack the valid pixels of the word
+    for (size_t i = pixelBegin; i < pixelEnd; ++i, bits >>= 1u)
+    {
+      if ((bits & 1u) != 0u)
+      {
+        const float distance = static_cast<float>(pMap[i]) * pixelSizeZ;
+
+        PointXYZ& point = pointCloud.points[pointIndex];
+        point.x         = pUndistorted[i].x * distance;
+        point.y         = pUndistorted[i].y * distance;
+        point.z         = pUndistorted[i].z * distance - f2rc;
+
+        pointCloud.pixelIndices[pointIndex] = static_cast<uint32_t>(i);
+        ++pointIndex;
+      }
     }
-    *itPC = point;
   }
-  return;
+}
+
+void VisionaryData::generateQuantizedPointCloud(std::vector<QuantizedPointXYZ16>& pointCloud, float scale)
+{
+  generateQuantizedPointCloudImpl(pointCloud, scale);
+}
+
+void VisionaryData::generateQuantizedPointCloud(std::vector<QuantizedPointXYZ32>& pointCloud, float scale)
+{
+  generateQuantizedPointCloudImpl(pointCloud, scale);
+}
+
+template <typename T>
+void VisionaryData::generateQuantizedPointCloudImpl(std::vector<QuantizedPointXYZ<T>>& pointCloud, float scale)
+{
+  assert(scale > 0.0f);
+  const std::vector<uint16_t>& map = getPointCloudMap();
+  if (!updateCamLookUpTable(map, getPointCloudImageType()))
+  {
+    pointCloud.resize(0u);
+    return;
+  }
+  pointCloud.resize(map.size());
+
+  // The look-up-table is in [m], so the scale is applied to the distance to get the coordinates in units.
+  const double f2rc       = m_cameraParams.f2rc / 1000. / scale;
+  const double pixelSizeZ = static_cast<double>(m_scaleZ) / scale;
+
+  const PixelValidator validator    = getPixelValidator(map);
+  const PointXYZ*      pUndistorted = m_preCalcCamInfo.data();
+  for (size_t i = 0; i < map.size(); ++i)
+  {
+    QuantizedPointXYZ<T>& point = pointCloud[i];
+    if (!validator.isValid(i))
+    {
+      point.x = QuantizedPointXYZ<T>::invalid();
+      point.y = QuantizedPointXYZ<T>::invalid();
+      point.z = QuantizedPointXYZ<T>::invalid();
+    }
+    else
+    {
+      const double distance = static_cast<double>(map[i]) * pixelSizeZ;
+      point.x               = quantize<T>(pUndistorted[i].x * distance);
+      point.y               = quantize<T>(pUndistorted[i].y * distance);
+      point.z               = quantize<T>(pUndistorted[i].z * distance - f2rc);
+    }
+  }
+}
+
+void VisionaryData::transformQuantizedPointCloud(std::vector<QuantizedPointXYZ16>& pointCloud, float scale) const
+{
+  transformQuantizedPointCloudImpl(pointCloud, scale);
+}
+
+void VisionaryData::transformQuantizedPointCloud(std::vector<QuantizedPointXYZ32>& pointCloud, float scale) const
+{
+  transformQuantizedPointCloudImpl(pointCloud, scale);
+}
+
+template <typename T>
+void VisionaryData::transformQuantizedPointCloudImpl(std::vector<QuantizedPointXYZ<T>>& pointCloud, float scale) const
+{
+  assert(scale > 0.0f);
+  const double* m = m_cameraParams.cam2worldMatrix;
+
+  // turn cam 2 world translations from [mm] to units
+  const double tx = m[3] / 1000. / scale;
+  const double ty = m[7] / 1000. / scale;
+  const double tz = m[11] / 1000. / scale;
+
+  for (auto& it : pointCloud)
+  {
+    if (!it.isValid())
+    {
+      continue;
+    }
+    const double x = it.x;
+    const double y = it.y;
+    const double z = it.z;
+
+    it.x = quantize<T>(x * m[0] + y * m[1] + z * m[2] + tx);
+    it.y = quantize<T>(x * m[4] + y * m[5] + z * m[6] + ty);
+    it.z = quantize<T>(x * m[8] + y * m[9] + z * m[10] + tz);
+  }
 }
 
 void VisionaryData::transformPointCloud(std::vector<PointXYZ>& pointCloud) const
+{
+  transformPointCloudRange(pointCloud.data(), pointCloud.data() + pointCloud.size());
+}
+
+void VisionaryData::transformPointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor) const
+{
+  PointXYZ* pPointCloud = pointCloud.data();
+  executor.parallelFor(pointCloud.size(), [this, pPointCloud](size_t begin, size_t end) {
+    transformPointCloudRange(pPointCloud + begin, pPointCloud + end);
+  });
+}
+
+void VisionaryData::transformPointCloudRange(PointXYZ* pBegin, PointXYZ* pEnd) const
 {
   // turn cam 2 world translations from [m] to [mm]
   const double tx = m_cameraParams.cam2worldMatrix[3] / 1000.;
   const double ty = m_cameraParams.cam2worldMatrix[7] / 1000.;
   const double tz = m_cameraParams.cam2worldMatrix[11] / 1000.;
 
-  for (auto& it : pointCloud)
+  for (PointXYZ* it = pBegin; it != pEnd; ++it)
   {
-    const double x = it.x;
-    const double y = it.y;
-    const double z = it.z;
+    const double x = it->x;
+    const double y = it->y;
+    const double z = it->z;
 
-    it.x = static_cast<float>(x * m_cameraParams.cam2worldMatrix[0] + y * m_cameraParams.cam2worldMatrix[1]
-                              + z * m_cameraParams.cam2worldMatrix[2] + tx);
-    it.y = static_cast<float>(x * m_cameraParams.cam2worldMatrix[4] + y * m_cameraParams.cam2worldMatrix[5]
-                              + z * m_cameraParams.cam2worldMatrix[6] + ty);
-    it.z = static_cast<float>(x * m_cameraParams.cam2worldMatrix[8] + y * m_cameraParams.cam2worldMatrix[9]
-                              + z * m_cameraParams.cam2worldMatrix[10] + tz);
+    it->x = static_cast<float>(x * m_cameraParams.cam2worldMatrix[0] + y * m_cameraParams.cam2worldMatrix[1]
+                               + z * m_cameraParams.cam2worldMatrix[2] + tx);
+    it->y = static_cast<float>(x * m_cameraParams.cam2worldMatrix[4] + y * m_cameraParams.cam2worldMatrix[5]
+                               + z * m_cameraParams.cam2worldMatrix[6] + ty);
+    it->z = static_cast<float>(x * m_cameraParams.cam2worldMatrix[8] + y * m_cameraParams.cam2worldMatrix[9]
+                               + z * m_cameraParams.cam2worldMatrix[10] + tz);
   }
 }
 
+std::vector<uint16_t>& VisionaryData::getPointCloudSourceMap()
+{
+  return getMutablePointCloudMap();
+}
+
+void VisionaryData::setPointCloudValidityPolicy(const PointCloudValidityPolicy& policy)
+{
+  m_validityPolicy = policy;
+}
+
+const PointCloudValidityPolicy& VisionaryData::getPointCloudValidityPolicy() const
+{
+  return m_validityPolicy;
+}
+
+const std::vector<uint16_t>& VisionaryData::getPointCloudMap() const
+{
+  static const std::vector<uint16_t> emptyMap;
+  return emptyMap;
+}
+
+std::vector<uint16_t>& VisionaryData::getMutablePointCloudMap()
+{
+  // changes of the caller are discarded, the map stays empty
+  m_emptyPointCloudMap.clear();
+  return m_emptyPointCloudMap;
+}
+
+VisionaryData::ImageType VisionaryData::getPointCloudImageType() const
+{
+  return UNKNOWN;
+}
+
+const std::vector<uint16_t>& VisionaryData::getPointCloudConfidenceMap() const
+{
+  static const std::vector<uint16_t> emptyMap;
+  return emptyMap;
+}
+
+const std::vector<uint16_t>& VisionaryData::getPointCloudStateMap() const
+{
+  static const std::vector<uint16_t> emptyMap;
+  return emptyMap;
+}
+
+const std::vector<uint16_t>& VisionaryData::getPointCloudIntensityMap() const
+{
+  static const std::vector<uint16_t> emptyMap;
+  return emptyMap;
+}
+
+const std::vector<uint32_t>& VisionaryData::getPointCloudRGBAMap() const
+{
+  static const std::vector<uint32_t> emptyMap;
+  return emptyMap;
+}
+
+VisionaryData::PixelValidator VisionaryData::getPixelValidator(const std::vector<uint16_t>& map) const
+{
+  PixelValidator validator{};
+  validator.pDistance = map.data();
+
+  // Turn the distance range from [m] into map values, so the check is a plain integer comparison.
+  // 0 and 0xFFFF are never valid.
+  validator.minDistance = 1u;
+  validator.maxDistance = 0xFFFEu;
+  if (m_scaleZ > 0.0f)
+  {
+    const double minValue = std::ceil(static_cast<double>(m_validityPolicy.minDistance) * 1000. / m_scaleZ);
+    const double maxValue = std::floor(static_cast<double>(m_validityPolicy.maxDistance) * 1000. / m_scaleZ);
+    validator.minDistance = std::max(validator.minDistance, castClamped<uint16_t>(minValue));
+    validator.maxDistance = std::min(validator.maxDistance, castClamped<uint16_t>(maxValue));
+  }
+
+  const std::vector<uint16_t>& confidenceMap = getPointCloudConfidenceMap();
+  if (m_validityPolicy.minConfidence != 0u && confidenceMap.size() == map.size())
+  {
+    validator.pConfidence   = confidenceMap.data();
+    validator.minConfidence = m_validityPolicy.minConfidence;
+  }
+
+  const std::vector<uint16_t>& stateMap = getPointCloudStateMap();
+  if (m_validityPolicy.invalidStateMask != 0u && stateMap.size() == map.size())
+  {
+    validator.pState           = stateMap.data();
+    validator.invalidStateMask = m_validityPolicy.invalidStateMask;
+  }
+
+  return validator;
+}
+
 int VisionaryData::getHeight() const
 {
-  return m_cameraParams.height;
+  return m_roi.height;
 }
 
 int VisionaryData::getWidth() const
 {
-  return m_cameraParams.width;
+  return m_roi.width;
+}
+
+void VisionaryData::setRegionOfInterest(const RegionOfInterest& roi)
+{
+  m_requestedRoi = roi;
+  // the maps of a received frame keep their region until the next frame is parsed
+  if (getPointCloudMap().empty())
+  {
+    updateRegionOfInterest();
+  }
+}
+
+const RegionOfInterest& VisionaryData::getRegionOfInterest() const
+{
+  return m_roi;
+}
+
+void VisionaryData::updateRegionOfInterest()
+{
+  RegionOfInterest roi{};
+  roi.left   = std::min(std::max(m_requestedRoi.left, 0), m_cameraParams.width);
+  roi.top    = std::min(std::max(m_requestedRoi.top, 0), m_cameraParams.height);
+  roi.width  = m_cameraParams.width - roi.left;
+  roi.height = m_cameraParams.height - roi.top;
+  if (m_requestedRoi.width > 0)
+  {
+    roi.width = std::min(roi.width, m_requestedRoi.width);
+  }
+  if (m_requestedRoi.height > 0)
+  {
+    roi.height = std::min(roi.height, m_requestedRoi.height);
+  }
+
+  if (roi.left != m_roi.left || roi.top != m_roi.top || roi.width != m_roi.width || roi.height != m_roi.height)
+  {
+    // the look-up-tables are only valid for the previous region
+    m_roi                = roi;
+    m_preCalcCamInfoType = UNKNOWN;
+  }
 }
 
 uint32_t VisionaryData::getFrameNum() const
@@ -205,6 +1057,11 @@ uint32_t VisionaryData::getFrameNum() const
   return m_frameNum;
 }
 
+uint32_t VisionaryData::getChangeCounter() const
+{
+  return static_cast<uint32_t>(m_changeCounter);
+}
+
 uint64_t VisionaryData::getTimestamp() const
 {
   return m_blobTimestamp;
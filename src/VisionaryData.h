@@ -7,10 +7,16 @@
 
 #include <cstddef> // for size_t
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
+#include "CompactPointCloud.h"
+#include "IExecutor.h"
+#include "PointCloudSoA.h"
+#include "PointLayout.h"
 #include "PointXYZ.h"
+#include "QuantizedPointXYZ.h"
 
 namespace visionary {
 
@@ -31,6 +37,33 @@ struct CameraParameters
   double f2rc;
 };
 
+// Rectangular region of an image in pixels
+struct RegionOfInterest
+{
+  /// Column of the left border
+  int left;
+  /// Row of the top border
+  int top;
+  /// Width in pixels, 0 selects the full image width
+  int width;
+  /// Height in pixels, 0 selects the full image height
+  int height;
+};
+
+// Rules for invalidating points during point cloud generation.
+// Distance values of 0 and 0xFFFF always mark invalid pixels.
+struct PointCloudValidityPolicy
+{
+  /// Minimum valid value of the distance map in meters
+  float minDistance;
+  /// Maximum valid value of the distance map in meters
+  float maxDistance;
+  /// Minimum valid confidence (Visionary-T and Visionary-S confidence map), 0 disables the check
+  std::uint16_t minConfidence;
+  /// Bits of the state map marking a pixel as invalid (Visionary-T Mini), 0 disables the check
+  std::uint16_t invalidStateMask;
+};
+
 struct DataSetsActive
 {
   bool hasDataSetDepthMap;
@@ -46,6 +79,25 @@ struct PointXYZC
   float c;
 };
 
+// Copy a map of a data handler into a buffer of the caller, so it outlives the parsing of the next frame.
+// IN  map         - Map returned by one of the getters, e.g. getIntensityMap()
+// OUT pBuffer     - Buffer receiving the map
+// IN  capacity    - Number of values fitting into the buffer
+// Returns the number of values written, 0 if the map doesn't fit into the buffer.
+template <typename T>
+std::size_t copyMap(const std::vector<T>& map, T* pBuffer, std::size_t capacity)
+{
+  if (map.size() > capacity)
+  {
+    return 0u;
+  }
+  if (!map.empty())
+  {
+    std::memcpy(pBuffer, map.data(), map.size() * sizeof(T));
+  }
+  return map.size();
+}
+
 class VisionaryData
 {
 public:
@@ -58,17 +110,191 @@ public:
   // Calculate and return the Point Cloud in the camera perspective. Units are in meters.
   virtual void generatePointCloud(std::vector<PointXYZ>& pointCloud) = 0;
 
+  // Calculate and return the Point Cloud in the camera perspective. Units are in meters.
+  // The image is split into bands of rows which are calculated in parallel by the executor (e.g. a ThreadPool).
+  // No memory is allocated if pointCloud already has the size of the image.
+  // The default implementation calls the sequential generatePointCloud for data handlers which don't override it.
+  virtual void generatePointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor);
+
   // Transform the XYZ point cloud with the Cam2World matrix got from device
   // IN/OUT pointCloud  - Reference to the point cloud to be transformed. Contains the transformed point cloud
   // afterwards.
   void transformPointCloud(std::vector<PointXYZ>& pointCloud) const;
 
+  // Transform the XYZ point cloud with the Cam2World matrix got from device using the executor for parallelization
+  // IN/OUT pointCloud  - Reference to the point cloud to be transformed. Contains the transformed point cloud
+  // afterwards.
+  // IN     executor    - Executor processing the ranges of the point cloud
+  void transformPointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor) const;
+
+  // Calculate and return the Point Cloud in the world coordinate system. Units are in meters.
+  // Gives the same result as generatePointCloud followed by transformPointCloud, but in a single pass:
+  // the rotation of the Cam2World matrix is folded into the look-up-table, which is updated on changes of the
+  // metadata only.
+  void generateWorldPointCloud(std::vector<PointXYZ>& pointCloud);
+
+  // Calculate and return the Point Cloud in the world coordinate system in bands of rows processed by the executor.
+  void generateWorldPointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor);
+
+  // Calculate the Point Cloud in the camera perspective into a buffer of the caller, e.g. shared memory or a slot of a
+  // ring buffer. Units are in meters.
+  // OUT pPoints     - Buffer receiving the point cloud
+  // IN  capacity    - Number of points fitting into the buffer
+  // Returns the number of points written, 0 if the point cloud doesn't fit into the buffer.
+  std::size_t generatePointCloudInto(PointXYZ* pPoints, std::size_t capacity);
+
+  // Calculate the Point Cloud in the camera perspective into a buffer of the caller in bands of rows processed by the
+  // executor. Returns the number of points written, 0 if the point cloud doesn't fit into the buffer.
+  std::size_t generatePointCloudInto(PointXYZ* pPoints, std::size_t capacity, IExecutor& executor);
+
+  // Calculate the Point Cloud in the world coordinate system into a buffer of the caller. Units are in meters.
+  // Returns the number of points written, 0 if the point cloud doesn't fit into the buffer.
+  std::size_t generateWorldPointCloudInto(PointXYZ* pPoints, std::size_t capacity);
+
+  // Calculate the Point Cloud in the world coordinate system into a buffer of the caller in bands of rows processed by
+  // the executor. Returns the number of points written, 0 if the point cloud doesn't fit into the buffer.
+  std::size_t generateWorldPointCloudInto(PointXYZ* pPoints, std::size_t capacity, IExecutor& executor);
+
+  // Calculate the Point Cloud into a buffer of the caller with a user defined point layout, e.g. XYZ plus intensity,
+  // padded 16 byte points or the fields of a PointCloud2 message, in a single pass. Units are in meters.
+  // IN  layout           - Fields and stride of the points
+  // OUT pBuffer          - Buffer receiving the points
+  // IN  capacity         - Number of points fitting into the buffer
+  // IN  worldCoordinates - True for the world coordinate system, false for the camera perspective
+  // Returns the number of points written, 0 if the point cloud doesn't fit into the buffer.
+  std::size_t generateLayoutPointCloud(const PointLayout& layout,
+                                       void*              pBuffer,
+                                       std::size_t        capacity,
+                                       bool               worldCoordinates = false);
+
+  // Calculate the Point Cloud into a buffer with a user defined point layout in bands of rows processed by the
+  // executor. Returns the number of points written, 0 if the point cloud doesn't fit into the buffer.
+  std::size_t generateLayoutPointCloud(const PointLayout& layout,
+                                       void*              pBuffer,
+                                       std::size_t        capacity,
+                                       IExecutor&         executor,
+                                       bool               worldCoordinates = false);
+
+  // Calculate the Point Cloud into a buffer of points of the user defined type TPoint. The layout is fixed at compile
+  // time: setPoint(TPoint& out, const PointXYZ& point, std::size_t pixelIndex) fills each point, with point in meters
+  // and NaN for invalid points. The pixel index gives access to the maps, e.g. getIntensityMap()[pixelIndex].
+  // Returns the number of points written, 0 if the point cloud doesn't fit into the buffer.
+  template <class TPoint, class TFunction>
+  std::size_t generateCustomPointCloud(TPoint*          pPoints,
+                                       std::size_t      capacity,
+                                       const TFunction& setPoint,
+                                       bool             worldCoordinates = false)
+  {
+    return generateCustomPointCloudImpl(pPoints, capacity, setPoint, worldCoordinates, nullptr);
+  }
+
+  // Calculate the Point Cloud into a buffer of points of the user defined type TPoint in bands of rows processed by
+  // the executor. setPoint is called concurrently for different points.
+  template <class TPoint, class TFunction>
+  std::size_t generateCustomPointCloud(TPoint*          pPoints,
+                                       std::size_t      capacity,
+                                       const TFunction& setPoint,
+                                       IExecutor&       executor,
+                                       bool             worldCoordinates = false)
+  {
+    return generateCustomPointCloudImpl(pPoints, capacity, setPoint, worldCoordinates, &executor);
+  }
+
+  // Decides whether a pixel gives a valid point, set up from the validity policy for the current maps
+  struct PixelValidator
+  {
+    const std::uint16_t* pDistance;
+    // nullptr if the confidence is not checked
+    const std::uint16_t* pConfidence;
+    // nullptr if the state is not checked
+    const std::uint16_t* pState;
+    std::uint16_t        minDistance;
+    std::uint16_t        maxDistance;
+    std::uint16_t        minConfidence;
+    std::uint16_t        invalidStateMask;
+
+    bool isValid(std::size_t i) const
+    {
+      bool valid = (pDistance[i] >= minDistance) && (pDistance[i] <= maxDistance);
+      if (pConfidence != nullptr)
+      {
+        valid = valid && (pConfidence[i] >= minConfidence);
+      }
+      if (pState != nullptr)
+      {
+        valid = valid && ((pState[i] & invalidStateMask) == 0u);
+      }
+      return valid;
+    }
+  };
+
+  // Update the look-up-tables of the world point cloud for the current frame and set up the validator of its pixels.
+  // Must be called before generateWorldPoints. It is not thread-safe.
+  // Returns false if the current frame gives no points, e.g. because it was rejected after the region of interest
+  // changed. generateWorldPoints must not be called then.
+  bool prepareWorldPoints(PixelValidator& validator);
+
+  // Calculate the points [begin, end) of the world point cloud into pPoints[0, end - begin). Units are in meters.
+  // validator must come from prepareWorldPoints for the current frame. Different ranges can be calculated
+  // concurrently, e.g. to write the point clouds of several sensors into one buffer.
+  void generateWorldPoints(const PixelValidator& validator,
+                           std::size_t           begin,
+                           std::size_t           end,
+                           PointXYZ*             pPoints) const;
+
+  // Returns the number of points of the point cloud, i.e. the number of pixels of the distance map
+  std::size_t getPointCloudSize() const;
+
+  // Calculate and return the Point Cloud in the camera perspective in structure-of-arrays layout. Units are in meters.
+  // Invalid points are NaN in all planes.
+  void generatePointCloudSoA(PointCloudSoA& pointCloud);
+
+  // Calculate and return the Point Cloud in the camera perspective in structure-of-arrays layout in bands of rows
+  // processed by the executor.
+  void generatePointCloudSoA(PointCloudSoA& pointCloud, IExecutor& executor);
+
+  // Calculate and return the Point Cloud in the camera perspective containing only the valid points. Units are in
+  // meters. The pixel index of each point and a bit mask of the valid pixels are returned as well.
+  void generateCompactPointCloud(CompactPointCloud& pointCloud);
+
+  // Calculate and return the compact Point Cloud in the camera perspective using the executor for parallelization.
+  void generateCompactPointCloud(CompactPointCloud& pointCloud, IExecutor& executor);
+
+  // Calculate and return the Point Cloud in the camera perspective with fixed point coordinates.
+  // Coordinates outside the range of the type are clamped, invalid points are set to QuantizedPointXYZ::invalid().
+  // OUT pointCloud  - Reference to pass back the point cloud. Will be resized and only contain new point cloud.
+  // IN  scale       - Size of one coordinate unit in meters, e.g. 0.001 for millimeters
+  void generateQuantizedPointCloud(std::vector<QuantizedPointXYZ16>& pointCloud, float scale);
+  void generateQuantizedPointCloud(std::vector<QuantizedPointXYZ32>& pointCloud, float scale);
+
+  // Transform the fixed point point cloud with the Cam2World matrix got from device
+  // IN/OUT pointCloud  - Reference to the point cloud to be transformed. Contains the transformed point cloud
+  // afterwards.
+  // IN     scale       - Size of one coordinate unit in meters, as used for generation
+  void transformQuantizedPointCloud(std::vector<QuantizedPointXYZ16>& pointCloud, float scale) const;
+  void transformQuantizedPointCloud(std::vector<QuantizedPointXYZ32>& pointCloud, float scale) const;
+
+  // Returns the size of the image data, i.e. the size of the region of interest
   int getHeight() const;
   int getWidth() const;
 
+  // Restrict the image data to a region of interest.
+  // Only the pixels inside the region are copied from the received frames, so all maps, getWidth()/getHeight() and
+  // the point clouds are of the size of the region. The region is clipped to the image size of the metadata. It takes
+  // effect immediately if no frame has been received yet, else with the next received frame. The camera parameters
+  // keep referring to the full image. If that frame is rejected, the maps keep their previous size and the point
+  // cloud generators give no points until a frame is accepted.
+  void setRegionOfInterest(const RegionOfInterest& roi);
+
+  // Returns the region of interest of the current image data
+  const RegionOfInterest& getRegionOfInterest() const;
+
   // Returns the Byte length compared to data types
   std::uint32_t getFrameNum() const;
 
+  // Returns the change counter of the metadata. It changes if the camera parameters or the image layout change.
+  std::uint32_t getChangeCounter() const;
+
   // Returns the timestamp in device format
   // Bits of the devices timestamp: 5 unused - 12 Year - 4 Month - 5 Day - 11 Timezone - 5 Hour - 6 Minute - 6 Seconds -
   // 10 Milliseconds
@@ -77,6 +303,18 @@ public:
   // Returns the timestamp in milliseconds (UTC)
   std::uint64_t getTimestampMS() const;
 
+  // Set the rules for invalidating points. They are applied by all point cloud generators in the same pass as the
+  // point calculation. By default only the distance values 0 and 0xFFFF are invalid.
+  void setPointCloudValidityPolicy(const PointCloudValidityPolicy& policy);
+
+  // Returns the rules for invalidating points
+  const PointCloudValidityPolicy& getPointCloudValidityPolicy() const;
+
+  // Returns the distance map the point clouds are calculated from (z map of Visionary-S, distance map of Visionary-T
+  // and Visionary-T Mini) for in place processing, e.g. with a DepthMapFilter. The changes are used by all point
+  // cloud calculations until the next frame is parsed.
+  std::vector<std::uint16_t>& getPointCloudSourceMap();
+
   // Returns a reference to the camera parameter struct
   const CameraParameters& getCameraParameters() const;
 
@@ -100,6 +338,66 @@ protected:
     RADIAL
   };
 
+  // Returns the distance map the point cloud is calculated from (empty if not available, so the generic point cloud
+  // generators give no points)
+  virtual const std::vector<std::uint16_t>& getPointCloudMap() const;
+
+  // Returns the same map as getPointCloudMap for in place processing (an empty map owned by the base class if not
+  // available)
+  virtual std::vector<std::uint16_t>& getMutablePointCloudMap();
+
+  // Returns the image type of the distance map the point cloud is calculated from (UNKNOWN if not available)
+  virtual ImageType getPointCloudImageType() const;
+
+  // Returns the map the minimum confidence of the validity policy is checked against (empty if not available)
+  virtual const std::vector<std::uint16_t>& getPointCloudConfidenceMap() const;
+
+  // Returns the map the invalid state mask of the validity policy is checked against (empty if not available)
+  virtual const std::vector<std::uint16_t>& getPointCloudStateMap() const;
+
+  // Returns the intensity map written into FIELD_INTENSITY of layout point clouds (empty if not available)
+  virtual const std::vector<std::uint16_t>& getPointCloudIntensityMap() const;
+
+  // Returns the RGBA map written into FIELD_RGBA of layout point clouds (empty if not available)
+  virtual const std::vector<std::uint32_t>& getPointCloudRGBAMap() const;
+
+  // Returns the validator of the current validity policy for the distance map
+  PixelValidator getPixelValidator(const std::vector<std::uint16_t>& map) const;
+
+  // Clip the requested region of interest to the image size and activate it.
+  // Must be called at the end of parseXML, and before the image planes of a received frame are copied with
+  // copyImagePlane once the size of the frame has been checked.
+  void updateRegionOfInterest();
+
+  // Copy the region of interest of an image plane of the received frame into the map
+  // IN  pPlane      - Start of the full image plane in the received frame
+  // IN  byteDepth   - Byte depth of the pixels in the frame
+  // OUT map         - Map which is resized to the region of interest and receives the pixels
+  template <typename T>
+  void copyImagePlane(const std::uint8_t* pPlane, std::size_t byteDepth, std::vector<T>& map) const
+  {
+    const auto fullWidth = static_cast<std::size_t>(m_cameraParams.width);
+    const auto width     = static_cast<std::size_t>(m_roi.width);
+    const auto height    = static_cast<std::size_t>(m_roi.height);
+    const auto left      = static_cast<std::size_t>(m_roi.left);
+    const auto top       = static_cast<std::size_t>(m_roi.top);
+
+    map.resize(width * height);
+    if (width == fullWidth)
+    {
+      // the rows are contiguous
+      std::memcpy(map.data(), pPlane + top * fullWidth * byteDepth, width * height * byteDepth);
+    }
+    else
+    {
+      for (std::size_t row = 0u; row < height; ++row)
+      {
+        std::memcpy(
+          map.data() + row * width, pPlane + ((top + row) * fullWidth + left) * byteDepth, width * byteDepth);
+      }
+    }
+  }
+
   // Returns the Byte length compared to data type given as String
   std::size_t getItemLength(const std::string& dataType) const;
 
@@ -107,6 +405,11 @@ protected:
   // which is needed for point cloud calculation.
   void preCalcCamInfo(const ImageType& type);
 
+  // Update the lookup table for lens distortion correction to the image type if needed.
+  // Returns false if it doesn't fit the map, e.g. when a frame was rejected after the region of interest changed.
+  // No points must be calculated from the map in that case.
+  bool updateCamLookUpTable(const std::vector<std::uint16_t>& map, const ImageType& imgType);
+
   // Calculate and return the Point Cloud in the camera perspective. Units are in meters.
   // IN  map         - Image to be transformed
   // IN  imgType     - Type of the image (needed for correct transformation)
@@ -115,10 +418,28 @@ protected:
                           const ImageType&                  imgType,
                           std::vector<PointXYZ>&            pointCloud);
 
+  // Calculate and return the Point Cloud in the camera perspective in bands of rows processed by the executor.
+  // IN  map         - Image to be transformed
+  // IN  imgType     - Type of the image (needed for correct transformation)
+  // OUT pointCloud  - Reference to pass back the point cloud. Will be resized and only contain new point cloud.
+  // IN  executor    - Executor processing the bands of rows
+  void generatePointCloud(const std::vector<std::uint16_t>& map,
+                          const ImageType&                  imgType,
+                          std::vector<PointXYZ>&            pointCloud,
+                          IExecutor&                        executor);
+
   //-----------------------------------------------
   // Camera parameters to be read from XML Metadata part
   CameraParameters m_cameraParams{};
 
+  /// Rules for invalidating points
+  PointCloudValidityPolicy m_validityPolicy;
+
+  /// Region of interest requested by the user
+  RegionOfInterest m_requestedRoi{};
+  /// Region of interest of the current image data
+  RegionOfInterest m_roi{};
+
   /// Factor to convert unit of distance image to mm
   float m_scaleZ;
 
@@ -139,8 +460,153 @@ protected:
   ImageType m_preCalcCamInfoType;
   // The look-up-tables containing pre-calculations
   std::vector<PointXYZ> m_preCalcCamInfo;
+  // The same look-up-table in structure-of-arrays layout
+  PointCloudSoA m_preCalcCamInfoSoA;
+
+  // True if the look-up-table for world coordinates matches m_preCalcCamInfo and the Cam2World matrix.
+  bool m_preCalcWorldInfoValid;
+  // Look-up-table of the directions of m_preCalcCamInfo rotated into the world coordinate system
+  std::vector<PointXYZ> m_preCalcWorldInfo;
+  // Offset of each world point: Cam2World translation and focal to ray cross correction in [m]
+  PointXYZ m_preCalcWorldOffset;
 
 private:
+  // Number of points calculated at once by the generators of user defined layouts
+  static constexpr std::size_t kPointChunkSize = 256u;
+
+  // Returned by getMutablePointCloudMap of data handlers without a distance map
+  std::vector<std::uint16_t> m_emptyPointCloudMap;
+
+  // Update the look-up-tables for the camera perspective or the world coordinate system and set up the validator of
+  // the distance map. Returns false if the look-up-tables don't fit the map.
+  bool preparePointChunks(bool worldCoordinates, PixelValidator& validator);
+
+  // Calculate the points [begin, end) into pChunk[0, end - begin). The look-up-tables must be up to date.
+  void generatePointChunk(const PixelValidator& validator,
+                          bool                  worldCoordinates,
+                          PointXYZ*             pChunk,
+                          std::size_t           begin,
+                          std::size_t           end) const;
+
+  // Implementation of generateLayoutPointCloud
+  std::size_t generateLayoutPointCloudImpl(const PointLayout& layout,
+                                           void*              pBuffer,
+                                           std::size_t        capacity,
+                                           bool               worldCoordinates,
+                                           IExecutor*         pExecutor);
+
+  // Write the points [begin, end) with the layout into the buffer
+  void generateLayoutRange(const PointLayout&    layout,
+                           const PixelValidator& validator,
+                           bool                  worldCoordinates,
+                           std::uint8_t*         pBuffer,
+                           std::size_t           begin,
+                           std::size_t           end) const;
+
+  // Implementation of generateCustomPointCloud
+  template <class TPoint, class TFunction>
+  std::size_t generateCustomPointCloudImpl(TPoint*          pPoints,
+                                           std::size_t      capacity,
+                                           const TFunction& setPoint,
+                                           bool             worldCoordinates,
+                                           IExecutor*       pExecutor)
+  {
+    const std::size_t numPoints = getPointCloudMap().size();
+    PixelValidator    validator{};
+    if (numPoints > capacity || !preparePointChunks(worldCoordinates, validator))
+    {
+      return 0u;
+    }
+
+    const auto generateRange = [this, &validator, worldCoordinates, pPoints, &setPoint](std::size_t begin,
+                                                                                        std::size_t end) {
+      PointXYZ chunk[kPointChunkSize];
+      for (std::size_t chunkBegin = begin; chunkBegin < end; chunkBegin += kPointChunkSize)
+      {
+        const std::size_t chunkEnd = (end - chunkBegin > kPointChunkSize) ? chunkBegin + kPointChunkSize : end;
+        generatePointChunk(validator, worldCoordinates, chunk, chunkBegin, chunkEnd);
+        for (std::size_t i = chunkBegin; i < chunkEnd; ++i)
+        {
+          setPoint(pPoints[i], chunk[i - chunkBegin], i);
+        }
+      }
+    };
+    if (pExecutor == nullptr)
+    {
+      generateRange(0u, numPoints);
+    }
+    else
+    {
+      pExecutor->parallelFor(numPoints, generateRange);
+    }
+    return numPoints;
+  }
+
+  // Calculate the points [begin, end) of the point cloud into pPointCloud[0, end - begin).
+  // The look-up-table must be up to date.
+  void generatePointCloudRange(const PixelValidator& validator,
+                               PointXYZ*             pPointCloud,
+                               std::size_t           begin,
+                               std::size_t           end) const;
+
+  // Split the points [0, numPoints) into bands of rows and call function(begin, end) on the executor for each band
+  template <class TFunction>
+  void parallelForRows(IExecutor& executor, std::size_t numPoints, const TFunction& function) const;
+
+  // Calculate the points [begin, end) of the point cloud in structure-of-arrays layout.
+  // The look-up-table must be up to date.
+  void generatePointCloudSoARange(const PixelValidator& validator,
+                                  PointCloudSoA&        pointCloud,
+                                  std::size_t           begin,
+                                  std::size_t           end) const;
+
+  // Prepare the compact point cloud for numPixels pixels and resize the mask
+  static void resizeCompactMask(CompactPointCloud& pointCloud, std::size_t numPixels);
+
+  // Calculate the words [wordBegin, wordEnd) of the validity mask and store the number of valid points of each word
+  // in maskOffsets
+  static void generateCompactMaskRange(const PixelValidator& validator,
+                                       std::size_t           numPixels,
+                                       CompactPointCloud&    pointCloud,
+                                       std::size_t           wordBegin,
+                                       std::size_t           wordEnd);
+
+  // Turn the number of valid points per mask word into offsets and resize the points
+  static void accumulateCompactOffsets(CompactPointCloud& pointCloud);
+
+  // Calculate the points of the mask words [wordBegin, wordEnd). The mask, the offsets and the look-up-table must be
+  // up to date.
+  void generateCompactPointRange(const std::uint16_t* pMap,
+                                 std::size_t          numPixels,
+                                 CompactPointCloud&   pointCloud,
+                                 std::size_t          wordBegin,
+                                 std::size_t          wordEnd) const;
+
+  // Implementation of generateQuantizedPointCloud for the coordinate type T
+  template <typename T>
+  void generateQuantizedPointCloudImpl(std::vector<QuantizedPointXYZ<T>>& pointCloud, float scale);
+
+  // Implementation of transformQuantizedPointCloud for the coordinate type T
+  template <typename T>
+  void transformQuantizedPointCloudImpl(std::vector<QuantizedPointXYZ<T>>& pointCloud, float scale) const;
+
+  // Calculate the look-up-table for world coordinates
+  void preCalcWorldInfo();
+
+  // Update all look-up-tables needed for world point clouds from the current metadata.
+  // Returns false if they don't fit the map, see updateCamLookUpTable.
+  bool updateWorldLookUpTables(const std::vector<std::uint16_t>& map);
+
+  // Calculate the points [begin, end) of the world point cloud into pPoints[0, end - begin).
+  // The look-up-tables must be up to date.
+  void generateWorldPointCloudRange(const PixelValidator& validator,
+                                    PointXYZ*             pPoints,
+                                    std::size_t           begin,
+                                    std::size_t           end) const;
+
+  // Transform the points [pBegin, pEnd) with the Cam2World matrix
+  void transformPointCloudRange(PointXYZ* pBegin, PointXYZ* pEnd) const;
+
   // Bitmasks to calculate the timestamp in milliseconds
   // Bits of the devices timestamp: 5 unused - 12 Year - 4 Month - 5 Day - 11 Timezone - 5 Hour - 6 Minute - 6 Seconds -
   // 10 Milliseconds
@@ -5,6 +5,8 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <limits>
 
 #include "VisionaryEndian.h"
 #include "VisionarySData.h"
@@ -101,6 +103,8 @@ bool VisionarySData::parseXML(const std::string& xmlString, uint32_t changeCount
   const auto distanceDecimalExponent = dataStreamTree.get<int>("Z.<xmlattr>.decimalexponent", 0);
   m_scaleZ                           = powf(10.0f, static_cast<float>(distanceDecimalExponent));
 
+  updateRegionOfInterest();
+
   return true;
 }
 
@@ -179,16 +183,15 @@ bool VisionarySData::parseBinaryData(std::vector<uint8_t>::iterator itBuf, size_
     return false;
   }
   remainingSize -= imageSetSize;
-  m_zMap.resize(numPixel);
-  memcpy((m_zMap).data(), &*itBuf, numBytesZ);
+  // the new region of interest is applied only to a frame whose size has been checked
+  updateRegionOfInterest();
+  copyImagePlane(&*itBuf, m_zByteDepth, m_zMap);
   std::advance(itBuf, numBytesZ);
 
-  m_rgbaMap.resize(numPixel);
-  memcpy((m_rgbaMap).data(), &*itBuf, numBytesRGBA);
+  copyImagePlane(&*itBuf, m_rgbaByteDepth, m_rgbaMap);
   std::advance(itBuf, numBytesRGBA);
 
-  m_confidenceMap.resize(numPixel);
-  memcpy((m_confidenceMap).data(), &*itBuf, numBytesConfidence);
+  copyImagePlane(&*itBuf, m_confidenceByteDepth, m_confidenceMap);
   std::advance(itBuf, numBytesConfidence);
 
   const auto footerSize = (4u + 4u); // CRC(32bit) + LengthCopy(32bit)
@@ -220,6 +223,78 @@ void VisionarySData::generatePointCloud(std::vector<PointXYZ>& pointCloud)
   return VisionaryData::generatePointCloud(m_zMap, VisionaryData::PLANAR, pointCloud);
 }
 
+void VisionarySData::generatePointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor)
+{
+  return VisionaryData::generatePointCloud(m_zMap, VisionaryData::PLANAR, pointCloud, executor);
+}
+
+void VisionarySData::generateColoredPointCloud(AlignedVector<PointXYZRGB>& pointCloud, bool removeInvalid)
+{
+  // Calculate disortion data from XML metadata once.
+  if (!updateCamLookUpTable(m_zMap, VisionaryData::PLANAR))
+  {
+    pointCloud.clear();
+    return;
+  }
+
+  const auto  f2rc       = static_cast<float>(m_cameraParams.f2rc / 1000.f); // PointCloud should be in [m]
+  const float pixelSizeZ = m_scaleZ;
+  const float invalid    = std::numeric_limits<float>::quiet_NaN();
+  const bool  hasColors  = m_rgbaMap.size() == m_zMap.size();
+
+  const PixelValidator validator    = getPixelValidator(m_zMap);
+  const PointXYZ*      pUndistorted = m_preCalcCamInfo.data();
+  pointCloud.resize(m_zMap.size());
+  PointXYZRGB* pPointCloud = pointCloud.data();
+
+  // Each point is written to the next free position; it is kept by advancing the position, so invalid points are
+  // removed without branches.
+  size_t numPoints = 0u;
+  for (size_t i = 0u; i < m_zMap.size(); ++i)
+  {
+    const bool  isValid  = validator.isValid(i);
+    const float distance = isValid ? static_cast<float>(m_zMap[i]) * pixelSizeZ : invalid;
+
+    PointXYZRGB point{};
+    point.x = pUndistorted[i].x * distance;
+    point.y = pUndistorted[i].y * distance;
+    point.z = pUndistorted[i].z * distance - f2rc;
+    if (hasColors)
+    {
+      // the bytes of the RGBA map are in the order R, G, B, A
+      std::memcpy(&point.r, &m_rgbaMap[i], 4u);
+    }
+    pPointCloud[numPoints] = point;
+    numPoints += (isValid || !removeInvalid) ? 1u : 0u;
+  }
+  pointCloud.resize(numPoints);
+}
+
+const std::vector<uint16_t>& VisionarySData::getPointCloudMap() const
+{
+  return m_zMap;
+}
+
+std::vector<uint16_t>& VisionarySData::getMutablePointCloudMap()
+{
+  return m_zMap;
+}
+
+VisionaryData::ImageType VisionarySData::getPointCloudImageType() const
+{
+  return VisionaryData::PLANAR;
+}
+
+const std::vector<uint16_t>& VisionarySData::getPointCloudConfidenceMap() const
+{
+  return m_confidenceMap;
+}
+
+const std::vector<uint32_t>& VisionarySData::getPointCloudRGBAMap() const
+{
+  return m_rgbaMap;
+}
+
 const std::vector<uint16_t>& VisionarySData::getZMap() const
 {
   return m_zMap;
@@ -12,6 +12,9 @@
 #include <string>
 #include <vector>
 
+#include "AlignedAllocator.h"
+#include "PointXYZRGB.h"
+
 namespace visionary {
 
 class VisionarySData : public VisionaryData
@@ -34,6 +37,16 @@ public:
   // Calculate and return the Point Cloud in the camera perspective. Units are in meters.
   void generatePointCloud(std::vector<PointXYZ>& pointCloud) override;
 
+  // Calculate and return the Point Cloud in the camera perspective using the executor for parallelization.
+  void generatePointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor) override;
+
+  // Calculate and return the colored Point Cloud in the camera perspective in a single pass over the Z map and the
+  // RGBA map. Units are in meters.
+  // OUT pointCloud     - Reference to pass back the point cloud. Will be resized and only contain new point cloud.
+  // IN  removeInvalid  - If true only the valid points are returned in image order, otherwise the point cloud is
+  //                      organized and invalid points are NaN with the color of their pixel.
+  void generateColoredPointCloud(AlignedVector<PointXYZRGB>& pointCloud, bool removeInvalid = false);
+
 protected:
   //-----------------------------------------------
   // functions for parsing received blob
@@ -47,6 +60,12 @@ protected:
   // Returns true when parsing was successful.
   bool parseBinaryData(std::vector<uint8_t>::iterator itBuf, std::size_t size) override;
 
+  const std::vector<std::uint16_t>& getPointCloudMap() const override;
+  std::vector<std::uint16_t>&       getMutablePointCloudMap() override;
+  ImageType                         getPointCloudImageType() const override;
+  const std::vector<std::uint16_t>& getPointCloudConfidenceMap() const override;
+  const std::vector<std::uint32_t>& getPointCloudRGBAMap() const override;
+
 private:
   /// Byte depth of images
   std::size_t m_zByteDepth, m_rgbaByteDepth, m_confidenceByteDepth;
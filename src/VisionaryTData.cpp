@@ -5,6 +5,8 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <limits>
 
 #include "VisionaryEndian.h"
 #include "VisionaryTData.h"
@@ -39,6 +41,20 @@ static const boost::property_tree::ptree& empty_ptree()
   return t;
 }
 
+namespace {
+
+const float bad_point = std::numeric_limits<float>::quiet_NaN();
+
+// Bit pattern of a float, used to detect changes without comparing floats for equality
+std::uint32_t floatBits(float value)
+{
+  std::uint32_t bits = 0u;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+} // namespace
+
 VisionaryTData::VisionaryTData()
   : VisionaryData()
   , m_dataSetsActive()
@@ -49,6 +65,9 @@ VisionaryTData::VisionaryTData()
   , m_angularResolution(0)
   , m_numPolarValues(0)
   , m_numCartesianValues(0)
+  , m_polarLutStartAngleBits(0u)
+  , m_polarLutResolutionBits(0u)
+  , m_polarLutValid(false)
 {
 }
 
@@ -152,6 +171,8 @@ bool VisionaryTData::parseXML(const std::string& xmlString, uint32_t changeCount
     assert(sizeof(float) == 4);
   }
 
+  updateRegionOfInterest();
+
   return true;
 }
 
@@ -234,16 +255,15 @@ bool VisionaryTData::parseBinaryData(std::vector<uint8_t>::iterator itBuf, size_
       return false;
     }
     remainingSize -= imageSetSize;
-    m_distanceMap.resize(numPixel);
-    memcpy((m_distanceMap).data(), &*itBuf, numBytesDistance);
+    // the new region of interest is applied only to a frame whose size has been checked
+    updateRegionOfInterest();
+    copyImagePlane(&*itBuf, m_distanceByteDepth, m_distanceMap);
     std::advance(itBuf, numBytesDistance);
 
-    m_intensityMap.resize(numPixel);
-    memcpy((m_intensityMap).data(), &*itBuf, numBytesIntensity);
+    copyImagePlane(&*itBuf, m_intensityByteDepth, m_intensityMap);
     std::advance(itBuf, numBytesIntensity);
 
-    m_confidenceMap.resize(numPixel);
-    memcpy((m_confidenceMap).data(), &*itBuf, numBytesConfidence);
+    copyImagePlane(&*itBuf, m_confidenceByteDepth, m_confidenceMap);
     std::advance(itBuf, numBytesConfidence);
 
     const auto footerSize = (4u + 4u); // CRC(32bit) + LengthCopy(32bit)
@@ -395,6 +415,115 @@ void VisionaryTData::generatePointCloud(std::vector<PointXYZ>& pointCloud)
   return VisionaryData::generatePointCloud(m_distanceMap, VisionaryData::RADIAL, pointCloud);
 }
 
+void VisionaryTData::generatePointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor)
+{
+  return VisionaryData::generatePointCloud(m_distanceMap, VisionaryData::RADIAL, pointCloud, executor);
+}
+
+void VisionaryTData::generatePolarPointCloud(std::vector<PointXYZ>& pointCloud, float minConfidence)
+{
+  generatePolarPointCloudImpl(
+    pointCloud, minConfidence, PointXYZ{1.0f, 0.0f, 0.0f}, PointXYZ{0.0f, 0.0f, 1.0f}, PointXYZ{0.0f, 0.0f, 0.0f});
+}
+
+void VisionaryTData::generateWorldPolarPointCloud(std::vector<PointXYZ>& pointCloud, float minConfidence)
+{
+  // the sin part runs along the rotated x axis, the cos part along the rotated z axis.
+  // Translations are turned from [mm] to [m].
+  const double*  m = m_cameraParams.cam2worldMatrix;
+  const PointXYZ sinAxis{static_cast<float>(m[0]), static_cast<float>(m[4]), static_cast<float>(m[8])};
+  const PointXYZ cosAxis{static_cast<float>(m[2]), static_cast<float>(m[6]), static_cast<float>(m[10])};
+  const PointXYZ offset{
+    static_cast<float>(m[3] / 1000.), static_cast<float>(m[7] / 1000.), static_cast<float>(m[11] / 1000.)};
+  generatePolarPointCloudImpl(pointCloud, minConfidence, sinAxis, cosAxis, offset);
+}
+
+void VisionaryTData::updatePolarLookUpTables()
+{
+  const std::size_t   numValues      = m_polarDistanceData.size();
+  const std::uint32_t startAngleBits = floatBits(m_angleFirstScanPoint);
+  const std::uint32_t resolutionBits = floatBits(m_angularResolution);
+  if (m_polarLutValid && m_polarSin.size() == numValues && m_polarLutStartAngleBits == startAngleBits
+      && m_polarLutResolutionBits == resolutionBits)
+  {
+    return;
+  }
+
+  const double degToRad = std::acos(-1.0) / 180.0;
+  m_polarSin.resize(numValues);
+  m_polarCos.resize(numValues);
+  for (std::size_t i = 0u; i < numValues; ++i)
+  {
+    const double angle =
+      (static_cast<double>(m_angleFirstScanPoint) + static_cast<double>(i) * m_angularResolution) * degToRad;
+    m_polarSin[i] = static_cast<float>(std::sin(angle));
+    m_polarCos[i] = static_cast<float>(std::cos(angle));
+  }
+  m_polarLutStartAngleBits = startAngleBits;
+  m_polarLutResolutionBits = resolutionBits;
+  m_polarLutValid          = true;
+}
+
+void VisionaryTData::generatePolarPointCloudImpl(std::vector<PointXYZ>& pointCloud,
+                                                 float                  minConfidence,
+                                                 const PointXYZ&        sinAxis,
+                                                 const PointXYZ&        cosAxis,
+                                                 const PointXYZ&        offset)
+{
+  updatePolarLookUpTables();
+
+  const std::size_t numValues = m_polarDistanceData.size();
+  pointCloud.resize(numValues);
+
+  // without confidence data or gating every value with a positive distance is valid
+  const bool   useConfidence = (minConfidence > 0.0f) && (m_polarConfidenceData.size() == numValues);
+  const float* pDistance     = m_polarDistanceData.data();
+  const float* pConfidence   = m_polarConfidenceData.data();
+  const float* pSin          = m_polarSin.data();
+  const float* pCos          = m_polarCos.data();
+  PointXYZ*    pPointCloud   = pointCloud.data();
+
+  //-----------------------------------------------
+  // Branch free loop so the compiler can vectorize it: invalid values get a NaN scale, which propagates to all
+  // coordinates
+  for (std::size_t i = 0u; i < numValues; ++i)
+  {
+    const bool  isValid = (pDistance[i] > 0.0f) && (!useConfidence || pConfidence[i] >= minConfidence);
+    const float scale   = isValid ? pDistance[i] / 1000.0f : bad_point;
+    const float s       = pSin[i] * scale;
+    const float c       = pCos[i] * scale;
+
+    pPointCloud[i].x = sinAxis.x * s + cosAxis.x * c + offset.x;
+    pPointCloud[i].y = sinAxis.y * s + cosAxis.y * c + offset.y;
+    pPointCloud[i].z = sinAxis.z * s + cosAxis.z * c + offset.z;
+  }
+}
+
+const std::vector<uint16_t>& VisionaryTData::getPointCloudMap() const
+{
+  return m_distanceMap;
+}
+
+std::vector<uint16_t>& VisionaryTData::getMutablePointCloudMap()
+{
+  return m_distanceMap;
+}
+
+VisionaryData::ImageType VisionaryTData::getPointCloudImageType() const
+{
+  return VisionaryData::RADIAL;
+}
+
+const std::vector<uint16_t>& VisionaryTData::getPointCloudConfidenceMap() const
+{
+  return m_confidenceMap;
+}
+
+const std::vector<uint16_t>& VisionaryTData::getPointCloudIntensityMap() const
+{
+  return m_intensityMap;
+}
+
 const std::vector<uint16_t>& VisionaryTData::getDistanceMap() const
 {
   return m_distanceMap;
@@ -48,6 +48,19 @@ public:
   // Calculate and return the Point Cloud in the camera perspective. Units are in meters.
   void generatePointCloud(std::vector<PointXYZ>& pointCloud) override;
 
+  // Calculate and return the Point Cloud in the camera perspective using the executor for parallelization.
+  void generatePointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor) override;
+
+  // Calculate and return the points of the polar scan in the camera perspective. Units are in meters.
+  // The scan lies in the x-z plane of the camera: angle 0 is the optical axis (z) and positive angles turn towards x.
+  // The angles of the scan are in degrees and the distances in millimeters.
+  // There is one point per scan value. Values with a distance <= 0 or a confidence below minConfidence are invalid
+  // points (NaN). The sin/cos tables are cached as long as start angle, resolution and number of values don't change.
+  void generatePolarPointCloud(std::vector<PointXYZ>& pointCloud, float minConfidence = 0.0f);
+
+  // Same result as generatePolarPointCloud followed by transformPointCloud, but in a single pass.
+  void generateWorldPolarPointCloud(std::vector<PointXYZ>& pointCloud, float minConfidence = 0.0f);
+
 protected:
   using ByteBuffer = std::vector<std::uint8_t>;
 
@@ -64,7 +77,23 @@ protected:
   // Returns true when parsing was successful.
   bool parseBinaryData(ByteBuffer::iterator itBuf, std::size_t size) override;
 
+  const std::vector<std::uint16_t>& getPointCloudMap() const override;
+  std::vector<std::uint16_t>&       getMutablePointCloudMap() override;
+  ImageType                         getPointCloudImageType() const override;
+  const std::vector<std::uint16_t>& getPointCloudConfidenceMap() const override;
+  const std::vector<std::uint16_t>& getPointCloudIntensityMap() const override;
+
 private:
+  // Recalculate the sin/cos tables of the polar scan if its geometry changed
+  void updatePolarLookUpTables();
+
+  // Points of the polar scan: direction (sin, cos) of the scan plane mapped to sinAxis * sin + cosAxis * cos + offset
+  void generatePolarPointCloudImpl(std::vector<PointXYZ>& pointCloud,
+                                   float                  minConfidence,
+                                   const PointXYZ&        sinAxis,
+                                   const PointXYZ&        cosAxis,
+                                   const PointXYZ&        offset);
+
   // Indicator for the received data sets
   DataSetsActive m_dataSetsActive;
 
@@ -87,6 +116,13 @@ private:
   std::vector<float>         m_polarDistanceData;
   std::vector<float>         m_polarConfidenceData;
   std::vector<PointXYZC>     m_cartesianData;
+
+  // Cached sin/cos tables of the polar scan and the geometry they were calculated for
+  std::vector<float> m_polarSin;
+  std::vector<float> m_polarCos;
+  std::uint32_t      m_polarLutStartAngleBits;
+  std::uint32_t      m_polarLutResolutionBits;
+  bool               m_polarLutValid;
 };
 
 } // namespace visionary
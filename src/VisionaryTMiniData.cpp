@@ -122,6 +122,8 @@ bool VisionaryTMiniData::parseXML(const std::string& xmlString, uint32_t changeC
     m_scaleZ = DISTANCE_MAP_UNIT;
   }
 
+  updateRegionOfInterest();
+
   return true;
 }
 
@@ -204,10 +206,11 @@ bool VisionaryTMiniData::parseBinaryData(std::vector<uint8_t>::iterator itBuf, s
       return false;
     }
     remainingSize -= imageSetSize;
+    // the new region of interest is applied only to a frame whose size has been checked
+    updateRegionOfInterest();
     if (numBytesDistance != 0)
     {
-      m_distanceMap.resize(numPixel);
-      memcpy((m_distanceMap).data(), &*itBuf, numBytesDistance);
+      copyImagePlane(&*itBuf, m_distanceByteDepth, m_distanceMap);
       std::advance(itBuf, numBytesDistance);
     }
     else
@@ -216,8 +219,7 @@ bool VisionaryTMiniData::parseBinaryData(std::vector<uint8_t>::iterator itBuf, s
     }
     if (numBytesIntensity != 0)
     {
-      m_intensityMap.resize(numPixel);
-      memcpy((m_intensityMap).data(), &*itBuf, numBytesIntensity);
+      copyImagePlane(&*itBuf, m_intensityByteDepth, m_intensityMap);
       std::advance(itBuf, numBytesIntensity);
     }
     else
@@ -226,8 +228,7 @@ bool VisionaryTMiniData::parseBinaryData(std::vector<uint8_t>::iterator itBuf, s
     }
     if (numBytesState != 0)
     {
-      m_stateMap.resize(numPixel);
-      memcpy((m_stateMap).data(), &*itBuf, numBytesState);
+      copyImagePlane(&*itBuf, m_stateByteDepth, m_stateMap);
       std::advance(itBuf, numBytesState);
     }
     else
@@ -272,6 +273,36 @@ void VisionaryTMiniData::generatePointCloud(std::vector<PointXYZ>& pointCloud)
   return VisionaryData::generatePointCloud(m_distanceMap, VisionaryData::RADIAL, pointCloud);
 }
 
+void VisionaryTMiniData::generatePointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor)
+{
+  return VisionaryData::generatePointCloud(m_distanceMap, VisionaryData::RADIAL, pointCloud, executor);
+}
+
+const std::vector<uint16_t>& VisionaryTMiniData::getPointCloudMap() const
+{
+  return m_distanceMap;
+}
+
+std::vector<uint16_t>& VisionaryTMiniData::getMutablePointCloudMap()
+{
+  return m_distanceMap;
+}
+
+VisionaryData::ImageType VisionaryTMiniData::getPointCloudImageType() const
+{
+  return VisionaryData::RADIAL;
+}
+
+const std::vector<uint16_t>& VisionaryTMiniData::getPointCloudStateMap() const
+{
+  return m_stateMap;
+}
+
+const std::vector<uint16_t>& VisionaryTMiniData::getPointCloudIntensityMap() const
+{
+  return m_intensityMap;
+}
+
 const std::vector<uint16_t>& VisionaryTMiniData::getDistanceMap() const
 {
   return m_distanceMap;
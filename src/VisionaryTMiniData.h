@@ -36,6 +36,9 @@ public:
   // Calculate and return the Point Cloud in the camera perspective. Units are in meters.
   void generatePointCloud(std::vector<PointXYZ>& pointCloud) override;
 
+  // Calculate and return the Point Cloud in the camera perspective using the executor for parallelization.
+  void generatePointCloud(std::vector<PointXYZ>& pointCloud, IExecutor& executor) override;
+
   // factor to convert Radial distance map from fixed point to floating point
   static const float DISTANCE_MAP_UNIT;
 
@@ -53,6 +56,12 @@ protected:
   // Returns true when parsing was successful.
   bool parseBinaryData(std::vector<uint8_t>::iterator itBuf, std::size_t size) override;
 
+  const std::vector<std::uint16_t>& getPointCloudMap() const override;
+  std::vector<std::uint16_t>&       getMutablePointCloudMap() override;
+  ImageType                         getPointCloudImageType() const override;
+  const std::vector<std::uint16_t>& getPointCloudStateMap() const override;
+  const std::vector<std::uint16_t>& getPointCloudIntensityMap() const override;
+
 private:
   // Indicator for the received data sets
   DataSetsActive m_dataSetsActive;
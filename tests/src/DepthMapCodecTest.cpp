@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cstdint>
+#include <vector>
+
+#include "DepthMapCodec.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+const int kWidth  = 176;
+const int kHeight = 37;
+
+// depth map with smooth surfaces, noise, runs of invalid pixels and the extreme values
+std::vector<std::uint16_t> createDepthMap()
+{
+  std::vector<std::uint16_t> map(static_cast<std::size_t>(kWidth * kHeight));
+  std::uint32_t              noise = 12345u;
+  for (std::size_t i = 0u; i < map.size(); ++i)
+  {
+    const std::size_t row = i / kWidth;
+    const std::size_t col = i % kWidth;
+    noise                 = noise * 1103515245u + 12345u;
+    map[i]                = static_cast<std::uint16_t>(2000u + 10u * row + 3u * col + ((noise >> 16u) & 0x7u));
+    if ((col >= 20u && col < 50u) || (row == 5u) || ((noise >> 20u) & 0x1Fu) == 0u)
+    {
+      map[i] = 0u;
+    }
+  }
+  map[7u * kWidth + 60u] = 0xFFFFu;
+  map[7u * kWidth + 61u] = 1u;
+  map[7u * kWidth + 62u] = 0xFFFFu;
+  return map;
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(DepthMapCodecTest, RoundTripIsLossless)
+{
+  const std::vector<std::uint16_t> map = createDepthMap();
+
+  DepthMapCodec             codec;
+  std::vector<std::uint8_t> encoded;
+  codec.encode(map, kWidth, kHeight, encoded);
+  EXPECT_LT(encoded.size(), map.size() * sizeof(std::uint16_t) / 2u);
+
+  std::vector<std::uint16_t> decoded;
+  int                        width  = 0;
+  int                        height = 0;
+  ASSERT_TRUE(codec.decode(encoded, decoded, width, height));
+  EXPECT_EQ(kWidth, width);
+  EXPECT_EQ(kHeight, height);
+  EXPECT_EQ(map, decoded);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(DepthMapCodecTest, ParallelMatchesSequential)
+{
+  const std::vector<std::uint16_t> map = createDepthMap();
+
+  DepthMapCodec             codec;
+  std::vector<std::uint8_t> encoded;
+  codec.encode(map, kWidth, kHeight, encoded);
+
+  ThreadPool                pool(3u);
+  std::vector<std::uint8_t> encodedParallel;
+  codec.encode(map, kWidth, kHeight, encodedParallel, pool);
+  EXPECT_EQ(encoded, encodedParallel);
+
+  std::vector<std::uint16_t> decoded;
+  int                        width  = 0;
+  int                        height = 0;
+  ASSERT_TRUE(codec.decode(encodedParallel, decoded, width, height, pool));
+  EXPECT_EQ(map, decoded);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(DepthMapCodecTest, EmptyAndInvalidMaps)
+{
+  DepthMapCodec              codec;
+  std::vector<std::uint8_t>  encoded;
+  std::vector<std::uint16_t> decoded;
+  int                        width  = -1;
+  int                        height = -1;
+
+  codec.encode(std::vector<std::uint16_t>(), 0, 0, encoded);
+  ASSERT_TRUE(codec.decode(encoded, decoded, width, height));
+  EXPECT_EQ(0, width);
+  EXPECT_EQ(0, height);
+  EXPECT_TRUE(decoded.empty());
+
+  const std::vector<std::uint16_t> invalid(static_cast<std::size_t>(kWidth * kHeight), 0u);
+  codec.encode(invalid, kWidth, kHeight, encoded);
+  EXPECT_LT(encoded.size(), 200u);
+  ASSERT_TRUE(codec.decode(encoded, decoded, width, height));
+  EXPECT_EQ(invalid, decoded);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(DepthMapCodecTest, MalformedDataIsRejected)
+{
+  DepthMapCodec             codec;
+  std::vector<std::uint8_t> encoded;
+  codec.encode(createDepthMap(), kWidth, kHeight, encoded);
+
+  std::vector<std::uint16_t> decoded;
+  int                        width  = 0;
+  int                        height = 0;
+
+  std::vector<std::uint8_t> truncated(encoded.begin(), encoded.end() - 1);
+  EXPECT_FALSE(codec.decode(truncated, decoded, width, height));
+
+  std::vector<std::uint8_t> wrongMagic = encoded;
+  wrongMagic[0]                        = 'X';
+  EXPECT_FALSE(codec.decode(wrongMagic, decoded, width, height));
+
+  std::vector<std::uint8_t> wrongWidth = encoded;
+  wrongWidth[4]                        = static_cast<std::uint8_t>(wrongWidth[4] + 1u);
+  EXPECT_FALSE(codec.decode(wrongWidth, decoded, width, height));
+
+  EXPECT_FALSE(codec.decode(std::vector<std::uint8_t>(3u, 0u), decoded, width, height));
+
+  // crafted headers with huge dimensions and a single empty band must not allocate the map
+  const std::uint8_t hugeHeaders[][20] = {
+    {'V', 'D', 'C', '1', 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0x7F, 0, 0, 0, 0},
+    {'V', 'D', 'C', '1', 0x00, 0x00, 0x00, 0x10, 0x01, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0, 0, 0, 0},
+    // a plausible size, but the band is too short for its rows
+    {'V', 'D', 'C', '1', 0x10, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0, 0, 0, 0}};
+  width  = 7;
+  height = 9;
+  decoded.assign(5u, 1u);
+  for (const auto& header : hugeHeaders)
+  {
+    EXPECT_FALSE(codec.decode(std::vector<std::uint8_t>(header, header + 20), decoded, width, height));
+  }
+  EXPECT_EQ(7, width);
+  EXPECT_EQ(9, height);
+  EXPECT_EQ(std::vector<std::uint16_t>(5u, 1u), decoded);
+}
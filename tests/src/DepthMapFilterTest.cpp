@@ -0,0 +1,158 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "DepthMapFilter.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+const int kWidth  = 70; // more than one chunk of a row
+const int kHeight = 23;
+
+// noisy ramp with some invalid pixels
+std::vector<std::uint16_t> createMap()
+{
+  std::vector<std::uint16_t> map(static_cast<std::size_t>(kWidth * kHeight));
+  std::srand(42u);
+  for (std::size_t i = 0u; i < map.size(); ++i)
+  {
+    if (i % 23u == 7u)
+    {
+      map[i] = 0u;
+    }
+    else if (i % 31u == 2u)
+    {
+      map[i] = 0xFFFFu;
+    }
+    else
+    {
+      map[i] = static_cast<std::uint16_t>(3000u + 10u * (i % kWidth) + static_cast<unsigned>(std::rand() % 200));
+    }
+  }
+  return map;
+}
+
+std::uint16_t at(const std::vector<std::uint16_t>& map, int x, int y)
+{
+  x = std::min(std::max(x, 0), kWidth - 1);
+  y = std::min(std::max(y, 0), kHeight - 1);
+  return map[static_cast<std::size_t>(y * kWidth + x)];
+}
+
+bool isInvalid(std::uint16_t value)
+{
+  return value == 0u || value == 0xFFFFu;
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(DepthMapFilterTest, MedianMatchesReference)
+{
+  for (int kernelSize : {3, 5})
+  {
+    const std::vector<std::uint16_t> input = createMap();
+    const int                        r     = kernelSize / 2;
+
+    std::vector<std::uint16_t> expected(input.size());
+    for (int y = 0; y < kHeight; ++y)
+    {
+      for (int x = 0; x < kWidth; ++x)
+      {
+        std::vector<std::uint16_t> window;
+        for (int dy = -r; dy <= r; ++dy)
+        {
+          for (int dx = -r; dx <= r; ++dx)
+          {
+            window.push_back(at(input, x + dx, y + dy));
+          }
+        }
+        const auto middle = window.begin() + static_cast<std::ptrdiff_t>(window.size() / 2u);
+        std::nth_element(window.begin(), middle, window.end());
+        const std::uint16_t center                         = at(input, x, y);
+        expected[static_cast<std::size_t>(y * kWidth + x)] = isInvalid(center) ? center : *middle;
+      }
+    }
+
+    DepthMapFilter             filter;
+    std::vector<std::uint16_t> map = input;
+    filter.median(map, kWidth, kHeight, kernelSize);
+    EXPECT_EQ(expected, map) << "kernel size " << kernelSize;
+
+    ThreadPool pool(4u);
+    map = input;
+    filter.median(map, kWidth, kHeight, kernelSize, pool);
+    EXPECT_EQ(expected, map) << "kernel size " << kernelSize;
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(DepthMapFilterTest, RemovesFlyingPixelsOnly)
+{
+  // foreground at 1000, background at 5000 and a column of flying pixels in between
+  std::vector<std::uint16_t> map(static_cast<std::size_t>(kWidth * kHeight));
+  for (std::size_t i = 0u; i < map.size(); ++i)
+  {
+    const int x = static_cast<int>(i % kWidth);
+    map[i]      = x < 30 ? 1000u : (x == 30 ? 3000u : 5000u);
+  }
+  map[5u * kWidth + 10u] = 0u;
+
+  const std::vector<std::uint16_t> input = map;
+  DepthMapFilter                   filter;
+  ThreadPool                       pool(3u);
+  filter.removeFlyingPixels(map, kWidth, kHeight, FlyingPixelFilterParameters{100u, 0.05f}, pool);
+  for (std::size_t i = 0u; i < map.size(); ++i)
+  {
+    const bool isFlying = (i % kWidth) == 30u;
+    EXPECT_EQ(isFlying ? 0u : input[i], map[i]) << "index " << i;
+  }
+
+  // a jump below the threshold is kept
+  map = input;
+  filter.removeFlyingPixels(map, kWidth, kHeight, FlyingPixelFilterParameters{2000u, 0.0f});
+  EXPECT_EQ(input, map);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(DepthMapFilterTest, BilateralKeepsEdgesAndInvalidPixels)
+{
+  // two planes with noise, the range gate separates them
+  std::vector<std::uint16_t> map(static_cast<std::size_t>(kWidth * kHeight));
+  std::srand(7u);
+  for (std::size_t i = 0u; i < map.size(); ++i)
+  {
+    const unsigned base = (i % kWidth) < 35u ? 2000u : 8000u;
+    map[i]              = static_cast<std::uint16_t>(base + static_cast<unsigned>(std::rand() % 21));
+  }
+  map[100] = 0u;
+  map[200] = 0xFFFFu;
+
+  const std::vector<std::uint16_t> input = map;
+  DepthMapFilter                   filter;
+  filter.bilateral(map, kWidth, kHeight, BilateralFilterParameters{5, 1.5f, 10.0f, 50u});
+
+  std::vector<std::uint16_t> parallelMap = input;
+  ThreadPool                 pool(4u);
+  filter.bilateral(parallelMap, kWidth, kHeight, BilateralFilterParameters{5, 1.5f, 10.0f, 50u}, pool);
+  EXPECT_EQ(map, parallelMap);
+
+  EXPECT_EQ(0u, map[100]);
+  EXPECT_EQ(0xFFFFu, map[200]);
+  for (std::size_t i = 0u; i < map.size(); ++i)
+  {
+    if (!isInvalid(input[i]))
+    {
+      const unsigned base = (i % kWidth) < 35u ? 2000u : 8000u;
+      EXPECT_GE(map[i], base);
+      EXPECT_LE(map[i], base + 20u);
+    }
+  }
+}
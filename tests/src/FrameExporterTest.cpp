@@ -0,0 +1,213 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "FrameExporter.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+// File name unique to the running test, so tests running in parallel processes don't share files
+std::string testFilename(const std::string& suffix)
+{
+  const ::testing::TestInfo* pInfo = ::testing::UnitTest::GetInstance()->current_test_info();
+  return std::string(pInfo->test_suite_name()) + "_" + pInfo->name() + suffix;
+}
+
+std::vector<uint8_t> readFile(const std::string& filename)
+{
+  std::ifstream file(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+  return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+// Blocks the completion callback of the first frame until it is opened
+class Gate
+{
+public:
+  void enterAndWait()
+  {
+    std::unique_lock<std::mutex> guard(m_mutex);
+    m_isEntered = true;
+    m_cv.notify_all();
+    m_cv.wait(guard, [this] { return m_isOpen; });
+  }
+
+  void waitUntilEntered()
+  {
+    std::unique_lock<std::mutex> guard(m_mutex);
+    m_cv.wait(guard, [this] { return m_isEntered; });
+  }
+
+  void open()
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_isOpen = true;
+    m_cv.notify_all();
+  }
+
+private:
+  std::mutex              m_mutex;
+  std::condition_variable m_cv;
+  bool                    m_isEntered = false;
+  bool                    m_isOpen    = false;
+};
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(FrameExporterTest, WritesQueuedFrames)
+{
+  std::mutex  callbackMutex;
+  std::size_t numSucceeded = 0u;
+  {
+    FrameExporter exporter(4u, 2u, EXPORT_BLOCK, [&](const ExportFrame&, bool success) {
+      std::lock_guard<std::mutex> guard(callbackMutex);
+      numSucceeded += success ? 1u : 0u;
+    });
+
+    for (int i = 0; i < 6; ++i)
+    {
+      ExportFrame frame;
+      exporter.acquireFrame(frame);
+      frame.filename = testFilename(std::to_string(i) + ".raw");
+      frame.format   = EXPORT_RAW;
+      frame.rawData.assign(1000u, static_cast<uint8_t>(i));
+      EXPECT_TRUE(exporter.push(std::move(frame)));
+    }
+
+    ExportFrame plyFrame;
+    exporter.acquireFrame(plyFrame);
+    plyFrame.filename = testFilename(".ply");
+    plyFrame.points   = {{1.f, 2.f, 3.f}, {4.f, 5.f, 6.f}};
+    EXPECT_TRUE(exporter.push(std::move(plyFrame)));
+
+    exporter.waitUntilIdle();
+    const ExportStatistics statistics = exporter.getStatistics();
+    EXPECT_EQ(7u, statistics.numQueued);
+    EXPECT_EQ(7u, statistics.numWritten);
+    EXPECT_EQ(0u, statistics.numFailed);
+    EXPECT_EQ(0u, statistics.numDropped);
+  }
+  EXPECT_EQ(7u, numSucceeded);
+
+  for (int i = 0; i < 6; ++i)
+  {
+    const std::string filename = testFilename(std::to_string(i) + ".raw");
+    EXPECT_EQ(std::vector<uint8_t>(1000u, static_cast<uint8_t>(i)), readFile(filename));
+    std::remove(filename.c_str());
+  }
+  const std::vector<uint8_t> ply = readFile(testFilename(".ply"));
+  ASSERT_LT(4u, ply.size());
+  EXPECT_EQ(std::string("ply\n"), std::string(ply.begin(), ply.begin() + 4));
+  std::remove(testFilename(".ply").c_str());
+}
+
+//---------------------------------------------------------------------------------------
+TEST(FrameExporterTest, DropsFramesWhenFull)
+{
+  for (ExportOverflowPolicy policy : {EXPORT_DROP_NEWEST, EXPORT_DROP_OLDEST})
+  {
+    Gate                     gate;
+    std::vector<std::string> written;
+    FrameExporter            exporter(2u, 1u, policy, [&](const ExportFrame& frame, bool) {
+      written.push_back(frame.filename);
+      if (written.size() == 1u)
+      {
+        gate.enterAndWait();
+      }
+    });
+
+    // the first frame blocks the only worker, the next two fill the queue
+    std::vector<bool> accepted;
+    for (int i = 0; i < 5; ++i)
+    {
+      ExportFrame frame;
+      frame.filename = testFilename(std::to_string(i) + ".raw");
+      frame.format   = EXPORT_RAW;
+      accepted.push_back(exporter.push(std::move(frame)));
+      if (i == 0)
+      {
+        gate.waitUntilEntered();
+      }
+    }
+    gate.open();
+    exporter.waitUntilIdle();
+
+    const ExportStatistics statistics = exporter.getStatistics();
+    EXPECT_EQ(2u, statistics.numDropped);
+    EXPECT_EQ(3u, statistics.numWritten);
+    EXPECT_EQ(2u, statistics.maxQueueSize);
+    ASSERT_EQ(3u, written.size());
+    if (policy == EXPORT_DROP_NEWEST)
+    {
+      EXPECT_EQ((std::vector<bool>{true, true, true, false, false}), accepted);
+      EXPECT_EQ(testFilename("2.raw"), written[2]);
+    }
+    else
+    {
+      EXPECT_EQ((std::vector<bool>{true, true, true, true, true}), accepted);
+      EXPECT_EQ(testFilename("3.raw"), written[1]);
+      EXPECT_EQ(testFilename("4.raw"), written[2]);
+    }
+    for (int i = 0; i < 5; ++i)
+    {
+      std::remove(testFilename(std::to_string(i) + ".raw").c_str());
+    }
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(FrameExporterTest, ReportsFailedFrames)
+{
+  bool reportedFailure = false;
+  {
+    FrameExporter exporter(1u, 1u, EXPORT_BLOCK, [&](const ExportFrame&, bool success) { reportedFailure = !success; });
+    ExportFrame   frame;
+    frame.filename = "no_such_directory/frame.raw";
+    frame.format   = EXPORT_RAW;
+    exporter.push(std::move(frame));
+    exporter.waitUntilIdle();
+    EXPECT_EQ(1u, exporter.getStatistics().numFailed);
+  }
+  EXPECT_TRUE(reportedFailure);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(FrameExporterTest, ThrowingCallbackCountsAsFailed)
+{
+  const std::string filename  = testFilename(".raw");
+  std::size_t       numCalled = 0u;
+  {
+    FrameExporter exporter(2u, 1u, EXPORT_BLOCK, [&](const ExportFrame&, bool) {
+      ++numCalled;
+      throw std::runtime_error("callback failed");
+    });
+    for (int i = 0; i < 3; ++i)
+    {
+      ExportFrame frame;
+      exporter.acquireFrame(frame);
+      frame.filename = filename;
+      frame.format   = EXPORT_RAW;
+      frame.rawData  = {1u, 2u, 3u};
+      exporter.push(std::move(frame));
+    }
+    exporter.waitUntilIdle();
+
+    // the worker keeps running after each exception
+    const ExportStatistics statistics = exporter.getStatistics();
+    EXPECT_EQ(3u, statistics.numFailed);
+    EXPECT_EQ(0u, statistics.numWritten);
+  }
+  EXPECT_EQ(3u, numCalled);
+  std::remove(filename.c_str());
+}
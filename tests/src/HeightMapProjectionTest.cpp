@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "HeightMapProjection.h"
+#include "MockVisionaryData.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+void expectSameHeightMap(const HeightMap& expected, const HeightMap& actual)
+{
+  ASSERT_EQ(expected.count.size(), actual.count.size());
+  for (std::size_t i = 0u; i < expected.count.size(); ++i)
+  {
+    EXPECT_EQ(expected.count[i], actual.count[i]) << "cell " << i;
+    if (expected.count[i] == 0u)
+    {
+      EXPECT_TRUE(std::isnan(actual.minHeight[i]) && std::isnan(actual.maxHeight[i])) << "cell " << i;
+    }
+    else
+    {
+      EXPECT_FLOAT_EQ(expected.minHeight[i], actual.minHeight[i]) << "cell " << i;
+      EXPECT_FLOAT_EQ(expected.maxHeight[i], actual.maxHeight[i]) << "cell " << i;
+    }
+  }
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(HeightMapProjectionTest, ProjectionMatchesWorldPointCloud)
+{
+  visionary_test::MockVisionaryData data(64, 48);
+  const HeightMapParameters         parameters{-2.0f, -1.5f, 0.25f, 16, 12, 1.0f, 4.0f};
+
+  // bin the world point cloud by hand
+  std::vector<PointXYZ> pointCloud;
+  data.generateWorldPointCloud(pointCloud);
+  HeightMap expected{16, 12, std::vector<float>(16u * 12u), std::vector<float>(16u * 12u), {}};
+  expected.count.assign(16u * 12u, 0u);
+  for (const PointXYZ& point : pointCloud)
+  {
+    const float cellX = std::floor((point.x + 2.0f) / 0.25f);
+    const float cellY = std::floor((point.y + 1.5f) / 0.25f);
+    if (std::isnan(point.z) || cellX < 0.0f || cellX >= 16.0f || cellY < 0.0f || cellY >= 12.0f || point.z < 1.0f
+        || point.z > 4.0f)
+    {
+      continue;
+    }
+    const auto cell = static_cast<std::size_t>(cellY * 16.0f + cellX);
+    if (expected.count[cell] == 0u)
+    {
+      expected.minHeight[cell] = point.z;
+      expected.maxHeight[cell] = point.z;
+    }
+    expected.minHeight[cell] = std::min(expected.minHeight[cell], point.z);
+    expected.maxHeight[cell] = std::max(expected.maxHeight[cell], point.z);
+    ++expected.count[cell];
+  }
+
+  HeightMapProjection projection(parameters);
+  HeightMap           heightMap;
+  projection.project(data, heightMap);
+  EXPECT_EQ(16, heightMap.numCellsX);
+  EXPECT_EQ(12, heightMap.numCellsY);
+  expectSameHeightMap(expected, heightMap);
+
+  ThreadPool pool(3u);
+  HeightMap  parallelHeightMap;
+  projection.project(data, parallelHeightMap, pool);
+  expectSameHeightMap(expected, parallelHeightMap);
+
+  std::vector<std::uint8_t> occupancy;
+  HeightMapProjection::getOccupancyGrid(heightMap, 3u, occupancy);
+  ASSERT_EQ(expected.count.size(), occupancy.size());
+  std::size_t numOccupied = 0u;
+  for (std::size_t i = 0u; i < occupancy.size(); ++i)
+  {
+    EXPECT_EQ(expected.count[i] >= 3u ? 1u : 0u, occupancy[i]) << "cell " << i;
+    numOccupied += occupancy[i];
+  }
+  EXPECT_GT(numOccupied, 0u);
+}
@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "ImageUndistortion.h"
+#include "MockVisionaryData.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+const int kWidth  = 64;
+const int kHeight = 48;
+
+// image whose pixels hold 100 * (column + 1) or 100 * (row + 1)
+std::vector<std::uint16_t> createRamp(bool alongRows)
+{
+  std::vector<std::uint16_t> image(static_cast<std::size_t>(kWidth * kHeight));
+  for (std::size_t i = 0u; i < image.size(); ++i)
+  {
+    const std::size_t coordinate = alongRows ? i / kWidth : i % kWidth;
+    image[i]                     = static_cast<std::uint16_t>(100u * (coordinate + 1u));
+  }
+  return image;
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(ImageUndistortionTest, NoDistortionGivesSameImage)
+{
+  visionary_test::MockVisionaryData data(kWidth, kHeight);
+  data.cameraParameters().k1 = 0.0;
+  data.cameraParameters().k2 = 0.0;
+
+  std::vector<std::uint32_t> rgba(static_cast<std::size_t>(kWidth * kHeight));
+  for (std::size_t i = 0u; i < rgba.size(); ++i)
+  {
+    rgba[i] = static_cast<std::uint32_t>(i * 2654435761u);
+  }
+  const std::vector<std::uint16_t> image = createRamp(false);
+
+  for (UndistortionInterpolation interpolation : {UNDISTORT_NEAREST, UNDISTORT_BILINEAR})
+  {
+    ImageUndistortion          undistortion(interpolation);
+    std::vector<std::uint16_t> undistorted;
+    undistortion.undistort(data, image, undistorted);
+    EXPECT_EQ(image, undistorted);
+
+    ThreadPool                 pool(3u);
+    std::vector<std::uint32_t> undistortedRgba;
+    undistortion.undistort(data, rgba, undistortedRgba, pool);
+    EXPECT_EQ(rgba, undistortedRgba);
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(ImageUndistortionTest, BilinearSourceMatchesDistortionModel)
+{
+  visionary_test::MockVisionaryData data(kWidth, kHeight);
+  const CameraParameters&           camera = data.getCameraParameters();
+  // ignored like in the point cloud calculation
+  data.cameraParameters().k3 = 0.5;
+  data.cameraParameters().p1 = 0.01;
+  data.cameraParameters().p2 = -0.02;
+
+  // the interpolated ramps give the position of the source pixel of each undistorted pixel
+  ImageUndistortion          undistortion(UNDISTORT_BILINEAR);
+  ThreadPool                 pool(3u);
+  std::vector<std::uint16_t> columns;
+  std::vector<std::uint16_t> rows;
+  undistortion.undistort(data, createRamp(false), columns, pool);
+  undistortion.undistort(data, createRamp(true), rows);
+
+  std::size_t numOutside = 0u;
+  for (int row = 0; row < kHeight; ++row)
+  {
+    for (int col = 0; col < kWidth; ++col)
+    {
+      const auto i = static_cast<std::size_t>(row * kWidth + col);
+      if (columns[i] == 0u)
+      {
+        EXPECT_EQ(0u, rows[i]);
+        ++numOutside;
+        continue;
+      }
+      const double sourceX = columns[i] / 100.0 - 1.0;
+      const double sourceY = rows[i] / 100.0 - 1.0;
+      if (sourceX <= 0.0 || sourceY <= 0.0 || sourceX >= kWidth - 1.0 || sourceY >= kHeight - 1.0)
+      {
+        continue; // sources within half a pixel outside of the image are clamped to the border
+      }
+
+      // correcting the source position as in the point cloud calculation gives the undistorted pixel
+      const double xp = (camera.cx - sourceX) / camera.fx;
+      const double yp = (camera.cy - sourceY) / camera.fy;
+      const double r2 = xp * xp + yp * yp;
+      const double k  = 1.0 + camera.k1 * r2 + camera.k2 * r2 * r2;
+      EXPECT_NEAR(col, camera.cx - xp * k * camera.fx, 0.05) << "pixel " << col << ", " << row;
+      EXPECT_NEAR(row, camera.cy - yp * k * camera.fy, 0.05) << "pixel " << col << ", " << row;
+    }
+  }
+  EXPECT_LT(numOutside, columns.size() / 4u);
+}
@@ -0,0 +1,133 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <VisionaryData.h>
+
+namespace visionary_test {
+
+// Data handler with synthetic camera parameters and a deterministic distance map.
+// Used to test the point cloud calculations without parsing a blob.
+class MockVisionaryData : public visionary::VisionaryData
+{
+public:
+  MockVisionaryData(int width, int height, bool isPlanar = false) : m_imageType(isPlanar ? PLANAR : RADIAL)
+  {
+    m_cameraParams.width  = width;
+    m_cameraParams.height = height;
+    m_cameraParams.fx     = -0.7 * width;
+    m_cameraParams.fy     = -0.7 * width;
+    m_cameraParams.cx     = 0.5 * (width - 1);
+    m_cameraParams.cy     = 0.5 * (height - 1);
+    m_cameraParams.k1     = -0.076050;
+    m_cameraParams.k2     = 0.217518;
+    m_cameraParams.f2rc   = 12.5;
+
+    // rotation of 90 degree around z and a translation in [mm]
+    const double cam2world[16] = {0., -1., 0., 100., 1., 0., 0., -50., 0., 0., 1., 1000., 0., 0., 0., 1.};
+    std::copy(cam2world, cam2world + 16, m_cameraParams.cam2worldMatrix);
+
+    m_scaleZ        = 0.25f;
+    m_changeCounter = 1u;
+
+    // distance ramp with some invalid pixels
+    m_fullDistanceMap.resize(static_cast<std::size_t>(width * height));
+    for (std::size_t i = 0u; i < m_fullDistanceMap.size(); ++i)
+    {
+      if (i % 17u == 3u)
+      {
+        m_fullDistanceMap[i] = 0u;
+      }
+      else if (i % 29u == 5u)
+      {
+        m_fullDistanceMap[i] = 0xFFFFu;
+      }
+      else
+      {
+        m_fullDistanceMap[i] = static_cast<std::uint16_t>(2000u + (i * 7u) % 20000u);
+      }
+    }
+    receiveFrame();
+  }
+
+  // Copy the full distance map like a received frame, applying the region of interest
+  void receiveFrame()
+  {
+    updateRegionOfInterest();
+    copyImagePlane(
+      reinterpret_cast<const std::uint8_t*>(m_fullDistanceMap.data()), sizeof(std::uint16_t), m_distanceMap);
+  }
+
+  std::vector<std::uint16_t>& distanceMap()
+  {
+    return m_distanceMap;
+  }
+
+  std::vector<std::uint16_t>& confidenceMap()
+  {
+    return m_confidenceMap;
+  }
+
+  visionary::CameraParameters& cameraParameters()
+  {
+    return m_cameraParams;
+  }
+
+  void generatePointCloud(std::vector<visionary::PointXYZ>& pointCloud) override
+  {
+    VisionaryData::generatePointCloud(m_distanceMap, m_imageType, pointCloud);
+  }
+
+  void generatePointCloud(std::vector<visionary::PointXYZ>& pointCloud, visionary::IExecutor& executor) override
+  {
+    VisionaryData::generatePointCloud(m_distanceMap, m_imageType, pointCloud, executor);
+  }
+
+protected:
+  bool parseXML(const std::string&, std::uint32_t) override
+  {
+    return true;
+  }
+
+  bool parseBinaryData(std::vector<std::uint8_t>::iterator, std::size_t) override
+  {
+    return true;
+  }
+
+  const std::vector<std::uint16_t>& getPointCloudMap() const override
+  {
+    return m_distanceMap;
+  }
+
+  std::vector<std::uint16_t>& getMutablePointCloudMap() override
+  {
+    return m_distanceMap;
+  }
+
+  ImageType getPointCloudImageType() const override
+  {
+    return m_imageType;
+  }
+
+  const std::vector<std::uint16_t>& getPointCloudConfidenceMap() const override
+  {
+    return m_confidenceMap;
+  }
+
+private:
+  ImageType                  m_imageType;
+  std::vector<std::uint16_t> m_fullDistanceMap;
+  std::vector<std::uint16_t> m_distanceMap;
+  std::vector<std::uint16_t> m_confidenceMap;
+};
+
+} // namespace visionary_test
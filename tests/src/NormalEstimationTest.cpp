@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "NormalEstimation.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+const int kWidth  = 40;
+const int kHeight = 30;
+
+// tilted plane z = 1 + 0.2 x with a step of 0.5 m in the right half
+std::vector<PointXYZ> createPlanes()
+{
+  std::vector<PointXYZ> pointCloud;
+  for (int row = 0; row < kHeight; ++row)
+  {
+    for (int col = 0; col < kWidth; ++col)
+    {
+      const float x = 0.01f * static_cast<float>(col - kWidth / 2);
+      const float y = 0.01f * static_cast<float>(row - kHeight / 2);
+      const float z = 1.0f + 0.2f * x + (col >= kWidth / 2 ? 0.5f : 0.0f);
+      pointCloud.push_back(PointXYZ{x, y, z});
+    }
+  }
+  // isolated invalid points, each point keeps a valid neighbor in each direction
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  for (std::size_t i = 0u; i < pointCloud.size(); ++i)
+  {
+    if ((i / kWidth) % 7u == 3u && (i % kWidth) % 5u == 2u)
+    {
+      pointCloud[i] = PointXYZ{nan, nan, nan};
+    }
+  }
+  return pointCloud;
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(NormalEstimationTest, NormalsOfPlanesAcrossDiscontinuity)
+{
+  const std::vector<PointXYZ> pointCloud = createPlanes();
+
+  // the normal of the planes pointing to the camera at the origin
+  const float length   = std::sqrt(0.2f * 0.2f + 1.0f);
+  const float expectNx = 0.2f / length;
+  const float expectNz = -1.0f / length;
+
+  for (int smoothingSize : {0, 2})
+  {
+    const NormalEstimationParameters parameters{1, smoothingSize, 0.05f, PointXYZ{0.0f, 0.0f, 0.0f}};
+    NormalEstimation                 estimation(parameters);
+    std::vector<PointNormal>         normals;
+    estimation.compute(pointCloud, kWidth, kHeight, normals);
+    ASSERT_EQ(pointCloud.size(), normals.size());
+
+    for (std::size_t i = 0u; i < pointCloud.size(); ++i)
+    {
+      if (std::isnan(pointCloud[i].z))
+      {
+        EXPECT_TRUE(std::isnan(normals[i].nz)) << "index " << i;
+        continue;
+      }
+      EXPECT_NEAR(expectNx, normals[i].nx, 1e-3f) << "index " << i << " smoothing " << smoothingSize;
+      EXPECT_NEAR(0.0f, normals[i].ny, 1e-3f) << "index " << i << " smoothing " << smoothingSize;
+      EXPECT_NEAR(expectNz, normals[i].nz, 1e-3f) << "index " << i << " smoothing " << smoothingSize;
+    }
+
+    ThreadPool               pool(4u);
+    std::vector<PointNormal> parallelNormals;
+    estimation.compute(pointCloud, kWidth, kHeight, parallelNormals, pool);
+    ASSERT_EQ(normals.size(), parallelNormals.size());
+    EXPECT_EQ(0, std::memcmp(normals.data(), parallelNormals.data(), normals.size() * sizeof(PointNormal)));
+  }
+}
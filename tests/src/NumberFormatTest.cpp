@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "NumberFormat.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+std::string formatFloatString(float value)
+{
+  char  buffer[kMaxFloatChars];
+  char* pEnd = formatFloat(value, buffer);
+  return std::string(buffer, pEnd);
+}
+
+std::string formatIntegerString(std::int64_t value)
+{
+  char  buffer[kMaxIntegerChars];
+  char* pEnd = formatInteger(value, buffer);
+  return std::string(buffer, pEnd);
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(NumberFormatTest, FloatNotation)
+{
+  EXPECT_EQ("0", formatFloatString(0.f));
+  EXPECT_EQ("-0", formatFloatString(-0.f));
+  EXPECT_EQ("3", formatFloatString(3.f));
+  EXPECT_EQ("1500", formatFloatString(1500.f));
+  EXPECT_EQ("-2.25", formatFloatString(-2.25f));
+  EXPECT_EQ("12.5", formatFloatString(12.5f));
+  EXPECT_EQ("0.1", formatFloatString(0.1f));
+  EXPECT_EQ("0.0001", formatFloatString(1e-4f));
+  EXPECT_EQ("123456790", formatFloatString(123456789.f));
+  EXPECT_EQ("1e+09", formatFloatString(1e9f));
+  EXPECT_EQ("1e-05", formatFloatString(1e-5f));
+  EXPECT_EQ("-1.5e-07", formatFloatString(-1.5e-7f));
+  EXPECT_EQ("3.4028235e+38", formatFloatString(std::numeric_limits<float>::max()));
+  EXPECT_EQ("1e-45", formatFloatString(std::numeric_limits<float>::denorm_min()));
+  EXPECT_EQ("nan", formatFloatString(std::numeric_limits<float>::quiet_NaN()));
+  EXPECT_EQ("inf", formatFloatString(std::numeric_limits<float>::infinity()));
+  EXPECT_EQ("-inf", formatFloatString(-std::numeric_limits<float>::infinity()));
+}
+
+//---------------------------------------------------------------------------------------
+TEST(NumberFormatTest, FloatRoundTrip)
+{
+  // values spread over the whole range including subnormals
+  std::uint32_t bits = 1u;
+  for (int i = 0; i < 200000; ++i)
+  {
+    bits = bits * 1664525u + 1013904223u;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (std::isnan(value) || std::isinf(value))
+    {
+      continue;
+    }
+    const std::string text = formatFloatString(value);
+    ASSERT_LE(text.size(), kMaxFloatChars);
+    const float parsed = std::strtof(text.c_str(), nullptr);
+    ASSERT_EQ(0, std::memcmp(&value, &parsed, sizeof(value))) << text;
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(NumberFormatTest, Integers)
+{
+  EXPECT_EQ("0", formatIntegerString(0));
+  EXPECT_EQ("7", formatIntegerString(7));
+  EXPECT_EQ("-10", formatIntegerString(-10));
+  EXPECT_EQ("255", formatIntegerString(255));
+  EXPECT_EQ("-32768", formatIntegerString(-32768));
+  EXPECT_EQ("9223372036854775807", formatIntegerString(std::numeric_limits<std::int64_t>::max()));
+  EXPECT_EQ("-9223372036854775808", formatIntegerString(std::numeric_limits<std::int64_t>::min()));
+
+  char  buffer[kMaxIntegerChars];
+  char* pEnd = formatUnsigned(std::numeric_limits<std::uint64_t>::max(), buffer);
+  EXPECT_EQ("18446744073709551615", std::string(buffer, pEnd));
+}
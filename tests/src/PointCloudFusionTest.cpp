@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "MockVisionaryData.h"
+#include "PointCloudFusion.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudFusionTest, FusesWorldPointCloudsWithExtrinsics)
+{
+  visionary_test::MockVisionaryData first(64, 48);
+  visionary_test::MockVisionaryData second(37, 11, true);
+  visionary_test::MockVisionaryData third(20, 10);
+
+  // the second sensor is moved by 2 m along y and turned by 180 degrees around z
+  std::vector<FusionSensor> sensors(3u);
+  sensors[0]                 = FusionSensor{&first, false, {}};
+  sensors[1]                 = FusionSensor{&second, true, {}};
+  const double extrinsic[16] = {-1., 0., 0., 0., 0., -1., 0., 2000., 0., 0., 1., 0., 0., 0., 0., 1.};
+  std::memcpy(sensors[1].extrinsic, extrinsic, sizeof(extrinsic));
+  sensors[2] = FusionSensor{&third, false, {}};
+
+  std::vector<PointXYZ> pointCloud;
+  PointCloudFusion      fusion;
+  fusion.fuse(sensors, pointCloud);
+  const std::vector<std::size_t>& offsets = fusion.getOffsets();
+  ASSERT_EQ(4u, offsets.size());
+  EXPECT_EQ(64u * 48u, offsets[1]);
+  EXPECT_EQ(64u * 48u + 37u * 11u, offsets[2]);
+  ASSERT_EQ(offsets[3], pointCloud.size());
+
+  for (std::size_t sensor = 0u; sensor < sensors.size(); ++sensor)
+  {
+    std::vector<PointXYZ> expected;
+    sensors[sensor].pData->generateWorldPointCloud(expected);
+    ASSERT_EQ(offsets[sensor + 1u] - offsets[sensor], expected.size());
+    for (std::size_t i = 0u; i < expected.size(); ++i)
+    {
+      const PointXYZ& point = pointCloud[offsets[sensor] + i];
+      if (std::isnan(expected[i].z))
+      {
+        EXPECT_TRUE(std::isnan(point.x) && std::isnan(point.y) && std::isnan(point.z));
+      }
+      else if (sensor == 1u)
+      {
+        EXPECT_NEAR(-expected[i].x, point.x, 1e-5f);
+        EXPECT_NEAR(2.0f - expected[i].y, point.y, 1e-5f);
+        EXPECT_NEAR(expected[i].z, point.z, 1e-5f);
+      }
+      else
+      {
+        EXPECT_EQ(0, std::memcmp(&expected[i], &point, sizeof(PointXYZ))) << "index " << i;
+      }
+    }
+  }
+
+  // parallel into a buffer of the caller
+  ThreadPool            pool(3u);
+  std::vector<PointXYZ> buffer(pointCloud.size() + 10u);
+  EXPECT_EQ(pointCloud.size(), fusion.fuse(sensors, buffer.data(), buffer.size(), pool));
+  EXPECT_EQ(0, std::memcmp(pointCloud.data(), buffer.data(), pointCloud.size() * sizeof(PointXYZ)));
+
+  // a buffer which is too small is not written
+  EXPECT_EQ(0u, fusion.fuse(sensors, buffer.data(), pointCloud.size() - 1u));
+}
@@ -0,0 +1,336 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "LzfCompression.h"
+#include "PointCloudPcdWriter.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+// File name unique to the running test, so tests running in parallel processes don't share files
+std::string testFilename()
+{
+  const ::testing::TestInfo* pInfo = ::testing::UnitTest::GetInstance()->current_test_info();
+  return std::string(pInfo->test_suite_name()) + "_" + pInfo->name() + ".pcd";
+}
+const int         kWidth    = 300;
+const int         kHeight   = 250;
+
+// organized cloud of a tilted plane with some invalid points
+std::vector<PointXYZ> createPoints()
+{
+  const float           nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<PointXYZ> points(static_cast<size_t>(kWidth * kHeight));
+  for (size_t i = 0u; i < points.size(); ++i)
+  {
+    const float x = 0.01f * static_cast<float>(i % kWidth);
+    const float y = 0.01f * static_cast<float>(i / kWidth);
+    points[i]     = (i % 7u == 3u) ? PointXYZ{nan, nan, nan} : PointXYZ{x, y, 2.f + 0.5f * x};
+  }
+  return points;
+}
+
+// Read the file of the test and split it into the header including the DATA line and the data part
+void readFile(std::string& header, std::vector<uint8_t>& data)
+{
+  const std::string    filename = testFilename();
+  std::ifstream        file(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+  std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  std::remove(filename.c_str());
+
+  const std::string text(content.begin(), content.end());
+  const size_t      dataLine = text.find("DATA ");
+  ASSERT_NE(std::string::npos, dataLine);
+  const size_t dataBegin = text.find('\n', dataLine) + 1u;
+  header                 = text.substr(0u, dataBegin);
+  data.assign(content.begin() + static_cast<std::ptrdiff_t>(dataBegin), content.end());
+}
+
+std::vector<uint8_t> readFileContent(const char* filename)
+{
+  std::ifstream file(filename, std::ios_base::in | std::ios_base::binary);
+  return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+float readFloat(const uint8_t* pData)
+{
+  float value = 0.f;
+  std::memcpy(&value, pData, sizeof(value));
+  return value;
+}
+
+void expectSamePoint(const PointXYZ& expected, const uint8_t* pX, const uint8_t* pY, const uint8_t* pZ)
+{
+  if (std::isnan(expected.z))
+  {
+    EXPECT_TRUE(std::isnan(readFloat(pZ)));
+    return;
+  }
+  EXPECT_FLOAT_EQ(expected.x, readFloat(pX));
+  EXPECT_FLOAT_EQ(expected.y, readFloat(pY));
+  EXPECT_FLOAT_EQ(expected.z, readFloat(pZ));
+}
+// fixed point cloud at 1 mm scale with the same invalid points as createPoints()
+template <typename T>
+std::vector<QuantizedPointXYZ<T>> createQuantizedPoints()
+{
+  const T                           invalid = QuantizedPointXYZ<T>::invalid();
+  std::vector<QuantizedPointXYZ<T>> points(static_cast<size_t>(kWidth * kHeight));
+  for (size_t i = 0u; i < points.size(); ++i)
+  {
+    const T x = static_cast<T>(10 * static_cast<int>(i % kWidth) - 1500);
+    const T y = static_cast<T>(10 * static_cast<int>(i / kWidth));
+    points[i] = (i % 7u == 3u) ? QuantizedPointXYZ<T>{invalid, invalid, invalid}
+                               : QuantizedPointXYZ<T>{x, y, static_cast<T>(2000 + x / 2)};
+  }
+  return points;
+}
+
+template <typename T>
+T readInteger(const uint8_t* pData)
+{
+  T value = 0;
+  std::memcpy(&value, pData, sizeof(value));
+  return value;
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPcdWriterTest, LzfRoundTrip)
+{
+  std::vector<uint8_t> input(100000u);
+  for (size_t i = 0u; i < input.size(); ++i)
+  {
+    // repetitive parts, long runs and noise
+    const size_t noise = i * 2654435761u >> 13u;
+    input[i]           = static_cast<uint8_t>((i < 30000u) ? i % 13u : (i < 60000u) ? 7u : noise);
+  }
+
+  std::vector<uint8_t> compressed;
+  lzfCompress(input.data(), input.size(), compressed);
+  EXPECT_LT(compressed.size(), input.size());
+
+  std::vector<uint8_t> output(input.size());
+  ASSERT_TRUE(lzfDecompress(compressed.data(), compressed.size(), output.data(), output.size()));
+  EXPECT_EQ(input, output);
+
+  EXPECT_FALSE(lzfDecompress(compressed.data(), compressed.size() - 1u, output.data(), output.size()));
+  EXPECT_FALSE(lzfDecompress(compressed.data(), compressed.size(), output.data(), output.size() - 1u));
+
+  lzfCompress(input.data(), 2u, compressed);
+  ASSERT_TRUE(lzfDecompress(compressed.data(), compressed.size(), output.data(), 2u));
+  EXPECT_EQ(input[1], output[1]);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPcdWriterTest, OrganizedBinaryWithColors)
+{
+  const std::string filename = testFilename();
+  const std::vector<PointXYZ> points = createPoints();
+  std::vector<uint32_t>       rgbaMap(points.size());
+  for (size_t i = 0u; i < rgbaMap.size(); ++i)
+  {
+    const uint8_t rgba[4] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8u), 0x55u, 0xFFu};
+    std::memcpy(&rgbaMap[i], rgba, sizeof(rgba));
+  }
+  ASSERT_TRUE(PointCloudPcdWriter::WriteFormatPCD(filename.c_str(), points, rgbaMap, PCD_BINARY, kWidth));
+
+  std::string          header;
+  std::vector<uint8_t> data;
+  readFile(header, data);
+  EXPECT_NE(std::string::npos, header.find("FIELDS x y z rgb\nSIZE 4 4 4 4\nTYPE F F F U\nCOUNT 1 1 1 1\n"));
+  EXPECT_NE(std::string::npos, header.find("WIDTH 300\nHEIGHT 250\n"));
+  EXPECT_NE(std::string::npos, header.find("POINTS 75000\nDATA binary\n"));
+
+  ASSERT_EQ(points.size() * 16u, data.size());
+  for (size_t i = 0u; i < points.size(); i += 101u)
+  {
+    const uint8_t* pRecord = data.data() + i * 16u;
+    expectSamePoint(points[i], pRecord, pRecord + 4u, pRecord + 8u);
+    uint32_t rgb = 0u;
+    std::memcpy(&rgb, pRecord + 12u, sizeof(rgb));
+    EXPECT_EQ(((i & 0xFFu) << 16u) | (((i >> 8u) & 0xFFu) << 8u) | 0x55u, rgb);
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPcdWriterTest, UnorganizedCompressedWithIntensities)
+{
+  const std::string filename = testFilename();
+  const std::vector<PointXYZ> points = createPoints();
+  std::vector<uint16_t>       intensityMap(points.size());
+  for (size_t i = 0u; i < intensityMap.size(); ++i)
+  {
+    intensityMap[i] = static_cast<uint16_t>(i);
+  }
+  ASSERT_TRUE(PointCloudPcdWriter::WriteFormatPCD(filename.c_str(), points, intensityMap, PCD_BINARY_COMPRESSED));
+
+  std::vector<size_t> validIndices;
+  for (size_t i = 0u; i < points.size(); ++i)
+  {
+    if (!std::isnan(points[i].z))
+    {
+      validIndices.push_back(i);
+    }
+  }
+  const size_t numPoints = validIndices.size();
+
+  std::string          header;
+  std::vector<uint8_t> data;
+  readFile(header, data);
+  EXPECT_NE(std::string::npos, header.find("FIELDS x y z intensity\nSIZE 4 4 4 4\nTYPE F F F F\n"));
+  EXPECT_NE(std::string::npos, header.find("WIDTH " + std::to_string(numPoints) + "\nHEIGHT 1\n"));
+  EXPECT_NE(std::string::npos, header.find("DATA binary_compressed\n"));
+
+  ASSERT_LE(8u, data.size());
+  uint32_t sizes[2];
+  std::memcpy(sizes, data.data(), sizeof(sizes));
+  ASSERT_EQ(data.size() - 8u, sizes[0]);
+  ASSERT_EQ(numPoints * 16u, sizes[1]);
+  EXPECT_LT(sizes[0], sizes[1]);
+
+  std::vector<uint8_t> fields(sizes[1]);
+  ASSERT_TRUE(lzfDecompress(data.data() + 8u, sizes[0], fields.data(), fields.size()));
+  for (size_t k = 0u; k < numPoints; k += 97u)
+  {
+    const size_t   i       = validIndices[k];
+    const uint8_t* pFields = fields.data() + k * 4u;
+    expectSamePoint(points[i], pFields, pFields + numPoints * 4u, pFields + numPoints * 8u);
+    EXPECT_FLOAT_EQ(static_cast<float>(intensityMap[i]) / 65535.f, readFloat(pFields + numPoints * 12u));
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPcdWriterTest, InvalidShapesFail)
+{
+  const std::string filename = testFilename();
+  const std::vector<PointXYZ> points = createPoints();
+  EXPECT_FALSE(PointCloudPcdWriter::WriteFormatPCD(filename.c_str(), points, PCD_BINARY, kWidth + 1));
+  EXPECT_FALSE(PointCloudPcdWriter::WriteFormatPCD(filename.c_str(), points, std::vector<uint16_t>(3u), PCD_BINARY));
+  EXPECT_FALSE(PointCloudPcdWriter::WriteFormatPCD("no_such_directory/points.pcd", points, PCD_BINARY));
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPcdWriterTest, ParallelEncodingMatchesSequential)
+{
+  const std::string filename = testFilename();
+  const std::vector<PointXYZ> points = createPoints();
+  std::vector<uint32_t>       rgbaMap(points.size());
+  for (size_t i = 0u; i < rgbaMap.size(); ++i)
+  {
+    rgbaMap[i] = static_cast<uint32_t>(i * 2654435761u);
+  }
+
+  ThreadPool        pool(4u);
+  const char* const parallelFilename = "PointCloudPcdWriterTestParallel.pcd";
+  for (const PcdEncoding encoding : {PCD_BINARY, PCD_BINARY_COMPRESSED})
+  {
+    for (const int organizedWidth : {kWidth, 0})
+    {
+      ASSERT_TRUE(PointCloudPcdWriter::WriteFormatPCD(filename.c_str(), points, rgbaMap, encoding, organizedWidth));
+      ASSERT_TRUE(
+        PointCloudPcdWriter::WriteFormatPCD(parallelFilename, points, rgbaMap, encoding, organizedWidth, pool));
+      EXPECT_EQ(readFileContent(filename.c_str()), readFileContent(parallelFilename))
+        << encoding << " " << organizedWidth;
+    }
+  }
+  std::remove(filename.c_str());
+  std::remove(parallelFilename);
+
+  EXPECT_FALSE(PointCloudPcdWriter::WriteFormatPCD(filename.c_str(), points, PCD_BINARY, kWidth + 1, pool));
+  EXPECT_FALSE(PointCloudPcdWriter::WriteFormatPCD("no_such_directory/points.pcd", points, PCD_BINARY, 0, pool));
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPcdWriterTest, OrganizedBinaryQuantized16)
+{
+  const std::string                      filename = testFilename();
+  const std::vector<QuantizedPointXYZ16> points   = createQuantizedPoints<int16_t>();
+  ASSERT_TRUE(PointCloudPcdWriter::WriteFormatPCD(filename.c_str(), points, 0.001f, PCD_BINARY, kWidth));
+
+  std::string          header;
+  std::vector<uint8_t> data;
+  readFile(header, data);
+  EXPECT_NE(std::string::npos, header.find("# scale 0.001\n"));
+  EXPECT_NE(std::string::npos, header.find("FIELDS x y z\nSIZE 2 2 2\nTYPE I I I\nCOUNT 1 1 1\n"));
+  EXPECT_NE(std::string::npos, header.find("WIDTH 300\nHEIGHT 250\n"));
+  EXPECT_NE(std::string::npos, header.find("POINTS 75000\nDATA binary\n"));
+
+  // invalid points of an organized cloud keep their invalid marker value
+  ASSERT_EQ(points.size() * 6u, data.size());
+  for (size_t i = 0u; i < points.size(); i += 101u)
+  {
+    const uint8_t* pRecord = data.data() + i * 6u;
+    EXPECT_EQ(points[i].x, readInteger<int16_t>(pRecord));
+    EXPECT_EQ(points[i].y, readInteger<int16_t>(pRecord + 2u));
+    EXPECT_EQ(points[i].z, readInteger<int16_t>(pRecord + 4u));
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPcdWriterTest, UnorganizedQuantized32)
+{
+  const std::string                      filename = testFilename();
+  const std::vector<QuantizedPointXYZ32> points   = createQuantizedPoints<int32_t>();
+  std::vector<size_t>                    validIndices;
+  for (size_t i = 0u; i < points.size(); ++i)
+  {
+    if (points[i].isValid())
+    {
+      validIndices.push_back(i);
+    }
+  }
+  const size_t numPoints = validIndices.size();
+
+  ASSERT_TRUE(PointCloudPcdWriter::WriteFormatPCD(filename.c_str(), points, 0.0005f, PCD_BINARY));
+  std::string          header;
+  std::vector<uint8_t> data;
+  readFile(header, data);
+  EXPECT_NE(std::string::npos, header.find("# scale 0.0005\n"));
+  EXPECT_NE(std::string::npos, header.find("FIELDS x y z\nSIZE 4 4 4\nTYPE I I I\n"));
+  EXPECT_NE(std::string::npos, header.find("WIDTH " + std::to_string(numPoints) + "\nHEIGHT 1\n"));
+  ASSERT_EQ(numPoints * 12u, data.size());
+  for (size_t k = 0u; k < numPoints; k += 97u)
+  {
+    const size_t   i       = validIndices[k];
+    const uint8_t* pRecord = data.data() + k * 12u;
+    EXPECT_EQ(points[i].x, readInteger<int32_t>(pRecord));
+    EXPECT_EQ(points[i].y, readInteger<int32_t>(pRecord + 4u));
+    EXPECT_EQ(points[i].z, readInteger<int32_t>(pRecord + 8u));
+  }
+
+  ASSERT_TRUE(PointCloudPcdWriter::WriteFormatPCD(filename.c_str(), points, 0.0005f, PCD_BINARY_COMPRESSED));
+  readFile(header, data);
+  EXPECT_NE(std::string::npos, header.find("DATA binary_compressed\n"));
+  ASSERT_LE(8u, data.size());
+  uint32_t sizes[2];
+  std::memcpy(sizes, data.data(), sizeof(sizes));
+  ASSERT_EQ(data.size() - 8u, sizes[0]);
+  ASSERT_EQ(numPoints * 12u, sizes[1]);
+
+  std::vector<uint8_t> fields(sizes[1]);
+  ASSERT_TRUE(lzfDecompress(data.data() + 8u, sizes[0], fields.data(), fields.size()));
+  for (size_t k = 0u; k < numPoints; k += 97u)
+  {
+    const size_t   i       = validIndices[k];
+    const uint8_t* pFields = fields.data() + k * 4u;
+    EXPECT_EQ(points[i].x, readInteger<int32_t>(pFields));
+    EXPECT_EQ(points[i].y, readInteger<int32_t>(pFields + numPoints * 4u));
+    EXPECT_EQ(points[i].z, readInteger<int32_t>(pFields + numPoints * 8u));
+  }
+
+  EXPECT_FALSE(PointCloudPcdWriter::WriteFormatPCD(filename.c_str(), points, 0.0005f, PCD_BINARY, kWidth + 1));
+}
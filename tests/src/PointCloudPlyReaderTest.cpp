@@ -0,0 +1,203 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "PointCloudPlyReader.h"
+#include "PointCloudPlyWriter.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+// File name unique to the running test, so tests running in parallel processes don't share files
+std::string testFilename()
+{
+  const ::testing::TestInfo* pInfo = ::testing::UnitTest::GetInstance()->current_test_info();
+  return std::string(pInfo->test_suite_name()) + "_" + pInfo->name() + ".ply";
+}
+const size_t kNumPoints = 1000u;
+
+std::vector<PointXYZ> createPoints()
+{
+  const float           nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<PointXYZ> points(kNumPoints);
+  for (size_t i = 0u; i < points.size(); ++i)
+  {
+    const float value = static_cast<float>(i) * 0.001234567f - 0.5f;
+    points[i]         = (i % 11u == 4u) ? PointXYZ{nan, nan, nan} : PointXYZ{value, -2.f * value, 1.f / (2.f + value)};
+  }
+  return points;
+}
+
+std::vector<uint32_t> createColors()
+{
+  std::vector<uint32_t> rgbaMap(kNumPoints);
+  for (size_t i = 0u; i < rgbaMap.size(); ++i)
+  {
+    const uint8_t rgba[4] = {
+      static_cast<uint8_t>(i), static_cast<uint8_t>(3u * i), static_cast<uint8_t>(7u * i), 0xFFu};
+    std::memcpy(&rgbaMap[i], rgba, sizeof(rgba));
+  }
+  return rgbaMap;
+}
+
+std::vector<uint16_t> createIntensities()
+{
+  std::vector<uint16_t> intensityMap(kNumPoints);
+  for (size_t i = 0u; i < intensityMap.size(); ++i)
+  {
+    intensityMap[i] = static_cast<uint16_t>(i * 65u);
+  }
+  return intensityMap;
+}
+
+void expectSamePoints(const std::vector<PointXYZ>& expected, const PointXYZ* pActual)
+{
+  for (size_t i = 0u; i < expected.size(); ++i)
+  {
+    if (std::isnan(expected[i].z))
+    {
+      EXPECT_TRUE(std::isnan(pActual[i].z));
+      continue;
+    }
+    EXPECT_FLOAT_EQ(expected[i].x, pActual[i].x);
+    EXPECT_FLOAT_EQ(expected[i].y, pActual[i].y);
+    EXPECT_FLOAT_EQ(expected[i].z, pActual[i].z);
+  }
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyReaderTest, BinaryRoundTrip)
+{
+  const std::string filename = testFilename();
+  const std::vector<PointXYZ> points       = createPoints();
+  const std::vector<uint32_t> rgbaMap      = createColors();
+  const std::vector<uint16_t> intensityMap = createIntensities();
+  ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), points, rgbaMap, intensityMap, true));
+
+  PointCloudPlyReader reader;
+  ASSERT_TRUE(reader.open(filename.c_str()));
+  ASSERT_EQ(kNumPoints, reader.getNumPoints());
+  EXPECT_FALSE(reader.isZeroCopy());
+  expectSamePoints(points, reader.getPoints());
+
+  std::vector<uint32_t> readColors;
+  std::vector<uint16_t> readIntensities;
+  ASSERT_TRUE(reader.readColors(readColors));
+  ASSERT_TRUE(reader.readIntensities(readIntensities));
+  EXPECT_EQ(rgbaMap, readColors);
+  EXPECT_EQ(intensityMap, readIntensities);
+
+  reader.close();
+  std::remove(filename.c_str());
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyReaderTest, AsciiRoundTrip)
+{
+  const std::string filename = testFilename();
+  const std::vector<PointXYZ> points       = createPoints();
+  const std::vector<uint32_t> rgbaMap      = createColors();
+  const std::vector<uint16_t> intensityMap = createIntensities();
+  ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), points, rgbaMap, intensityMap, false));
+
+  PointCloudPlyReader reader;
+  ASSERT_TRUE(reader.open(filename.c_str()));
+  std::remove(filename.c_str());
+  ASSERT_EQ(kNumPoints, reader.getNumPoints());
+  EXPECT_TRUE(reader.hasColors());
+  EXPECT_TRUE(reader.hasIntensities());
+
+  // the ASCII output has the shortest digits which read back to the same floats
+  expectSamePoints(points, reader.getPoints());
+
+  std::vector<uint32_t> readColors;
+  std::vector<uint16_t> readIntensities;
+  ASSERT_TRUE(reader.readColors(readColors));
+  ASSERT_TRUE(reader.readIntensities(readIntensities));
+  EXPECT_EQ(rgbaMap, readColors);
+  EXPECT_EQ(intensityMap, readIntensities);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyReaderTest, AlignedBinaryPointsAreZeroCopy)
+{
+  const std::string filename = testFilename();
+  const std::vector<PointXYZ> points = createPoints();
+  std::string                 header = "ply\nformat binary_little_endian 1.0\nelement vertex ";
+  header += std::to_string(points.size()) + "\nproperty float x\nproperty float y\nproperty float z\ncomment";
+  // pad the header, so the vertices are 4 byte aligned
+  header.append((4u - (header.size() + 12u) % 4u) % 4u, ' ');
+  header += "\nend_header\n";
+  ASSERT_EQ(0u, header.size() % 4u);
+  {
+    std::ofstream file(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+    file << header;
+    file.write(reinterpret_cast<const char*>(points.data()), static_cast<std::streamsize>(points.size() * 12u));
+  }
+
+  PointCloudPlyReader reader;
+  ASSERT_TRUE(reader.open(filename.c_str()));
+  EXPECT_TRUE(reader.isZeroCopy());
+  EXPECT_FALSE(reader.hasColors());
+  ASSERT_EQ(kNumPoints, reader.getNumPoints());
+  expectSamePoints(points, reader.getPoints());
+  reader.close();
+  std::remove(filename.c_str());
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyReaderTest, WrittenBinaryPointsAreZeroCopy)
+{
+  const std::string filename = testFilename();
+  const std::vector<PointXYZ> points = createPoints();
+  ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), points, true));
+
+  PointCloudPlyReader reader;
+  ASSERT_TRUE(reader.open(filename.c_str()));
+  EXPECT_TRUE(reader.isZeroCopy());
+  ASSERT_EQ(kNumPoints, reader.getNumPoints());
+  expectSamePoints(points, reader.getPoints());
+  reader.close();
+  std::remove(filename.c_str());
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyReaderTest, MalformedFilesFail)
+{
+  const std::string filename = testFilename();
+  PointCloudPlyReader reader;
+  EXPECT_FALSE(reader.open("no_such_file.ply"));
+
+  const char* const contents[] = {
+    "not a ply file\n",
+    "ply\nformat binary_big_endian 1.0\nelement vertex 1\nproperty float x\nproperty float y\nproperty float z\n"
+    "end_header\n123456789012",
+    "ply\nformat binary_little_endian 1.0\nelement vertex 2\nproperty float x\nproperty float y\nproperty float z\n"
+    "end_header\n123456789012",
+    "ply\nformat ascii 1.0\nelement vertex 2\nproperty float x\nproperty float y\nend_header\n1 2\n3 4\n",
+    "ply\nformat ascii 1.0\nelement vertex 2\nproperty float x\nproperty float y\nproperty float z\nend_header\n"
+    "1 2 3\n4 five 6\n",
+    "ply\nformat ascii 1.0\nelement face 1\nproperty list uchar int vertex_indices\nend_header\n"};
+  for (const char* content : contents)
+  {
+    {
+      std::ofstream file(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+      file << content;
+    }
+    EXPECT_FALSE(reader.open(filename.c_str())) << content;
+    EXPECT_EQ(0u, reader.getNumPoints());
+    EXPECT_EQ(nullptr, reader.getPoints());
+  }
+  std::remove(filename.c_str());
+}
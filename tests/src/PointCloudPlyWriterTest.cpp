@@ -0,0 +1,268 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "PointCloudPlyWriter.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+// File name unique to the running test, so tests running in parallel processes don't share files
+std::string testFilename()
+{
+  const ::testing::TestInfo* pInfo = ::testing::UnitTest::GetInstance()->current_test_info();
+  return std::string(pInfo->test_suite_name()) + "_" + pInfo->name() + ".ply";
+}
+
+std::vector<PointXYZ> createPoints()
+{
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  return {{1.5f, -2.25f, 3.f}, {nan, nan, nan}, {0.125f, 0.5f, -0.75f}, {nan, nan, nan}};
+}
+
+std::string readFile(const char* filename)
+{
+  std::ifstream     file(filename, std::ios_base::in | std::ios_base::binary);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+// Split the file into the header including "end_header\n" and the data part
+void splitFile(const std::string& content, std::string& header, std::string& data)
+{
+  const std::string endHeader = "end_header\n";
+  const size_t      pos       = content.find(endHeader);
+  ASSERT_NE(std::string::npos, pos);
+  header = content.substr(0u, pos + endHeader.size());
+  data   = content.substr(pos + endHeader.size());
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyWriterTest, AsciiSkipCountsValidPoints)
+{
+  const std::string filename = testFilename();
+  const std::vector<uint32_t> rgbaMap = {0x00030201u, 0u, 0x00060504u, 0u};
+  ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), createPoints(), rgbaMap, false, INVALID_SKIP));
+
+  std::string header;
+  std::string data;
+  splitFile(readFile(filename.c_str()), header, data);
+  std::remove(filename.c_str());
+
+  EXPECT_EQ("ply\nformat ascii 1.0\nelement vertex 2\nproperty float x\nproperty float y\nproperty float z\n"
+            "property uchar red\nproperty uchar green\nproperty uchar blue\nend_header\n",
+            header);
+  EXPECT_EQ("1.5 -2.25 3 1 2 3\n0.125 0.5 -0.75 4 5 6\n", data);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyWriterTest, AsciiInvalidAsZero)
+{
+  const std::string filename = testFilename();
+  ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), createPoints(), false, INVALID_AS_ZERO));
+
+  std::string header;
+  std::string data;
+  splitFile(readFile(filename.c_str()), header, data);
+  std::remove(filename.c_str());
+
+  EXPECT_NE(std::string::npos, header.find("element vertex 4\n"));
+  EXPECT_EQ("1.5 -2.25 3\n0.0 0.0 0.0\n0.125 0.5 -0.75\n0.0 0.0 0.0\n", data);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyWriterTest, BinaryWithIntensities)
+{
+  const std::string filename = testFilename();
+  const std::vector<uint16_t> intensityMap = {65535u, 0u, 0u, 0u};
+  ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), createPoints(), intensityMap, true, INVALID_SKIP));
+
+  std::string header;
+  std::string data;
+  splitFile(readFile(filename.c_str()), header, data);
+  std::remove(filename.c_str());
+
+  EXPECT_NE(std::string::npos, header.find("format binary_little_endian 1.0\nelement vertex 2\n"));
+  ASSERT_EQ(2u * 4u * sizeof(float), data.size());
+  float values[8];
+  std::memcpy(values, data.data(), sizeof(values));
+  const float expected[8] = {1.5f, -2.25f, 3.f, 1.f, 0.125f, 0.5f, -0.75f, 0.f};
+  for (size_t i = 0u; i < 8u; ++i)
+  {
+    EXPECT_FLOAT_EQ(expected[i], values[i]);
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyWriterTest, UnwritableFileFails)
+{
+  EXPECT_FALSE(PointCloudPlyWriter::WriteFormatPLY("no_such_directory/points.ply", createPoints(), true));
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyWriterTest, BinaryRecordsOverSeveralChunks)
+{
+  const std::string filename = testFilename();
+  // more points than fit into one chunk of the binary encoder
+  const size_t          numPoints    = 70000u;
+  const PointXYZ        invalidPoint = createPoints()[1];
+  std::vector<PointXYZ> points(numPoints);
+  std::vector<uint32_t> rgbaMap(numPoints);
+  for (size_t i = 0u; i < numPoints; ++i)
+  {
+    const float value = static_cast<float>(i);
+    points[i]         = (i % 3u == 1u) ? invalidPoint : PointXYZ{value, -value, 0.5f * value};
+    rgbaMap[i]        = static_cast<uint32_t>(i * 2654435761u);
+  }
+  ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), points, rgbaMap, true, INVALID_AS_ZERO));
+
+  std::string header;
+  std::string data;
+  splitFile(readFile(filename.c_str()), header, data);
+  std::remove(filename.c_str());
+
+  EXPECT_NE(std::string::npos, header.find("element vertex 70000\n"));
+  const size_t recordSize = 3u * sizeof(float) + 3u;
+  ASSERT_EQ(numPoints * recordSize, data.size());
+  for (size_t i = 0u; i < numPoints; i += 997u)
+  {
+    const bool isValid = i % 3u != 1u;
+    float      coordinates[3];
+    std::memcpy(coordinates, data.data() + i * recordSize, sizeof(coordinates));
+    EXPECT_FLOAT_EQ(isValid ? static_cast<float>(i) : 0.f, coordinates[0]);
+    EXPECT_FLOAT_EQ(isValid ? -static_cast<float>(i) : 0.f, coordinates[1]);
+    EXPECT_FLOAT_EQ(isValid ? 0.5f * static_cast<float>(i) : 0.f, coordinates[2]);
+    EXPECT_EQ(0, std::memcmp(data.data() + i * recordSize + sizeof(coordinates), &rgbaMap[i], 3u));
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyWriterTest, ParallelEncodingMatchesSequential)
+{
+  const std::string filename = testFilename();
+  // several binary chunks and several batches of ASCII chunks
+  const size_t          numPoints    = 150000u;
+  const PointXYZ        invalidPoint = createPoints()[1];
+  std::vector<PointXYZ> points(numPoints);
+  std::vector<uint32_t> rgbaMap(numPoints);
+  std::vector<uint16_t> intensityMap(numPoints);
+  for (size_t i = 0u; i < numPoints; ++i)
+  {
+    const float value = 0.01f * static_cast<float>(i);
+    points[i]         = (i % 5u == 2u) ? invalidPoint : PointXYZ{value, -value, 1.f / (1.f + value)};
+    rgbaMap[i]        = static_cast<uint32_t>(i * 2654435761u);
+    intensityMap[i]   = static_cast<uint16_t>(i);
+  }
+
+  ThreadPool                     pool(4u);
+  const char* const              parallelFilename = "PointCloudPlyWriterTestParallel.ply";
+  const std::vector<uint32_t>    noColors;
+  const InvalidPointPresentation presentations[] = {INVALID_AS_NAN, INVALID_AS_ZERO, INVALID_SKIP};
+  for (const bool useBinary : {true, false})
+  {
+    for (const InvalidPointPresentation presentation : presentations)
+    {
+      ASSERT_TRUE(
+        PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), points, rgbaMap, intensityMap, useBinary, presentation));
+      ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(
+        parallelFilename, points, rgbaMap, intensityMap, useBinary, presentation, pool));
+      EXPECT_EQ(readFile(filename.c_str()), readFile(parallelFilename)) << useBinary << " " << presentation;
+
+      ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), points, intensityMap, useBinary, presentation));
+      ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(
+        parallelFilename, points, noColors, intensityMap, useBinary, presentation, pool));
+      EXPECT_EQ(readFile(filename.c_str()), readFile(parallelFilename)) << useBinary << " " << presentation;
+    }
+  }
+  std::remove(filename.c_str());
+  std::remove(parallelFilename);
+
+  EXPECT_FALSE(PointCloudPlyWriter::WriteFormatPLY(
+    "no_such_directory/points.ply", points, rgbaMap, intensityMap, true, INVALID_AS_NAN, pool));
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyWriterTest, AsciiQuantizedPresentations)
+{
+  const std::string                      filename = testFilename();
+  const int16_t                          invalid  = QuantizedPointXYZ16::invalid();
+  const std::vector<QuantizedPointXYZ16> points   = {{1, -2, 3}, {invalid, invalid, invalid}, {400, 5, -32767}};
+
+  std::string header;
+  std::string data;
+  ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), points, 0.001f, false, INVALID_SKIP));
+  splitFile(readFile(filename.c_str()), header, data);
+  EXPECT_EQ("ply\nformat ascii 1.0\ncomment scale 0.001\nelement vertex 2\nproperty short x\nproperty short y\n"
+            "property short z\nend_header\n",
+            header);
+  EXPECT_EQ("1 -2 3\n400 5 -32767\n", data);
+
+  ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), points, 0.001f, false, INVALID_AS_ZERO));
+  splitFile(readFile(filename.c_str()), header, data);
+  EXPECT_EQ("1 -2 3\n0 0 0\n400 5 -32767\n", data);
+
+  // INVALID_AS_NAN keeps the invalid marker value
+  ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), points, 0.001f, false));
+  splitFile(readFile(filename.c_str()), header, data);
+  std::remove(filename.c_str());
+  EXPECT_EQ("1 -2 3\n-32768 -32768 -32768\n400 5 -32767\n", data);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(PointCloudPlyWriterTest, BinaryQuantizedOverSeveralChunks)
+{
+  const std::string filename = testFilename();
+  // more points than fit into one chunk of the binary encoder
+  const size_t                     numPoints = 70000u;
+  const int32_t                    invalid   = QuantizedPointXYZ32::invalid();
+  std::vector<QuantizedPointXYZ32> points(numPoints);
+  for (size_t i = 0u; i < numPoints; ++i)
+  {
+    const int32_t value = static_cast<int32_t>(i) * 1000;
+    points[i] = (i % 3u == 1u) ? QuantizedPointXYZ32{invalid, invalid, invalid} : QuantizedPointXYZ32{value, -value, 7};
+  }
+
+  for (const InvalidPointPresentation presentation : {INVALID_SKIP, INVALID_AS_ZERO})
+  {
+    ASSERT_TRUE(PointCloudPlyWriter::WriteFormatPLY(filename.c_str(), points, 0.0001f, true, presentation));
+    std::string header;
+    std::string data;
+    splitFile(readFile(filename.c_str()), header, data);
+    EXPECT_NE(std::string::npos, header.find("comment scale 0.0001\n"));
+    EXPECT_NE(std::string::npos, header.find("property int x\nproperty int y\nproperty int z\n"));
+
+    const size_t recordSize  = 3u * sizeof(int32_t);
+    size_t       recordIndex = 0u;
+    for (size_t i = 0u; i < numPoints; ++i)
+    {
+      const bool isValid = i % 3u != 1u;
+      if (!isValid && presentation == INVALID_SKIP)
+      {
+        continue;
+      }
+      ASSERT_LE((recordIndex + 1u) * recordSize, data.size());
+      int32_t coordinates[3];
+      std::memcpy(coordinates, data.data() + recordIndex * recordSize, sizeof(coordinates));
+      EXPECT_EQ(isValid ? points[i].x : 0, coordinates[0]);
+      EXPECT_EQ(isValid ? points[i].y : 0, coordinates[1]);
+      EXPECT_EQ(isValid ? points[i].z : 0, coordinates[2]);
+      ++recordIndex;
+    }
+    EXPECT_EQ(recordIndex * recordSize, data.size());
+    EXPECT_NE(std::string::npos, header.find("element vertex " + std::to_string(recordIndex) + "\n"));
+  }
+  std::remove(filename.c_str());
+}
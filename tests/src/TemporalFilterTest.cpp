@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cstdint>
+#include <vector>
+
+#include "MockVisionaryData.h"
+#include "TemporalFilter.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+const std::size_t kNumPixels = 1000u;
+
+// frame with the value in all pixels except for one invalid pixel
+std::vector<std::uint16_t> createMap(std::uint16_t value)
+{
+  std::vector<std::uint16_t> map(kNumPixels, value);
+  map[10] = 0u;
+  return map;
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(TemporalFilterTest, WindowedAverageWithMotionReset)
+{
+  TemporalFilter             filter(TemporalFilterParameters{TEMPORAL_WINDOWED, 4u, 0.0f, 100u});
+  ThreadPool                 pool(3u);
+  std::vector<std::uint16_t> map;
+
+  // values 1000, 1010, 1020, 1030, 1040: the window keeps the last 4
+  for (std::uint16_t frame = 0u; frame < 5u; ++frame)
+  {
+    map = createMap(static_cast<std::uint16_t>(1000u + 10u * frame));
+    filter.apply(map, std::vector<std::uint16_t>(), 1u, pool);
+  }
+  EXPECT_EQ(4u, filter.getNumFrames());
+  EXPECT_EQ(1025u, map[0]);
+  EXPECT_EQ(1025u, map[kNumPixels - 1u]);
+  EXPECT_EQ(0u, map[10]);
+
+  // a jump beyond the motion threshold discards the history of the pixel
+  map    = createMap(1040u);
+  map[5] = 3000u;
+  filter.apply(map, std::vector<std::uint16_t>(), 1u, pool);
+  EXPECT_EQ(1033u, map[0]);
+  EXPECT_EQ(3000u, map[5]);
+
+  // a new change counter starts a new history
+  map = createMap(2000u);
+  filter.apply(map, std::vector<std::uint16_t>(), 2u);
+  EXPECT_EQ(1u, filter.getNumFrames());
+  EXPECT_EQ(2000u, map[0]);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(TemporalFilterTest, ExponentialAverageWeightedByConfidence)
+{
+  TemporalFilter filter(TemporalFilterParameters{TEMPORAL_EXPONENTIAL, 0u, 0.5f, 0u});
+
+  std::vector<std::uint16_t> map = createMap(1000u);
+  filter.apply(map, std::vector<std::uint16_t>(), 7u);
+  EXPECT_EQ(1000u, map[0]);
+
+  // equal weights: the weight of the first frame has decayed to 0.5
+  map = createMap(1100u);
+  filter.apply(map, std::vector<std::uint16_t>(), 7u);
+  EXPECT_EQ(1067u, map[0]);
+  EXPECT_EQ(0u, map[10]);
+
+  // a value with zero confidence is replaced by the average without changing it
+  std::vector<std::uint16_t> confidence(kNumPixels, 0u);
+  map = createMap(5000u);
+  filter.apply(map, confidence, 7u);
+  EXPECT_EQ(1067u, map[0]);
+  map = createMap(1050u);
+  confidence.assign(kNumPixels, 1u);
+  filter.apply(map, confidence, 7u);
+  EXPECT_EQ(1055u, map[0]);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(TemporalFilterTest, DataHandlerRegionOfInterestResetsHistory)
+{
+  TemporalFilter                    filter(TemporalFilterParameters{TEMPORAL_WINDOWED, 4u, 0.0f, 0u});
+  ThreadPool                        pool(3u);
+  visionary_test::MockVisionaryData data(64, 48);
+  data.setRegionOfInterest(RegionOfInterest{0, 0, 32, 16});
+
+  for (int frame = 0; frame < 2; ++frame)
+  {
+    data.receiveFrame();
+    filter.apply(data, std::vector<std::uint16_t>(), pool);
+  }
+  EXPECT_EQ(2u, filter.getNumFrames());
+
+  // the same size at another offset shows other pixels
+  data.setRegionOfInterest(RegionOfInterest{8, 4, 32, 16});
+  data.receiveFrame();
+  const std::vector<std::uint16_t> received = data.distanceMap();
+  filter.apply(data, std::vector<std::uint16_t>());
+  EXPECT_EQ(1u, filter.getNumFrames());
+  EXPECT_EQ(received, data.distanceMap());
+}
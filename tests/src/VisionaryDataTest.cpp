@@ -0,0 +1,557 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "MockVisionaryData.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+// compares bitwise, so NaN points must be NaN in both clouds
+void expectSamePoints(const std::vector<PointXYZ>& expected, const std::vector<PointXYZ>& actual)
+{
+  ASSERT_EQ(expected.size(), actual.size());
+  EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(PointXYZ)));
+}
+
+void expectNearPoints(const std::vector<PointXYZ>& expected, const std::vector<PointXYZ>& actual, float tolerance)
+{
+  ASSERT_EQ(expected.size(), actual.size());
+  for (std::size_t i = 0u; i < expected.size(); ++i)
+  {
+    if (std::isnan(expected[i].z))
+    {
+      EXPECT_TRUE(std::isnan(actual[i].x) && std::isnan(actual[i].y) && std::isnan(actual[i].z)) << "index " << i;
+    }
+    else
+    {
+      EXPECT_NEAR(expected[i].x, actual[i].x, tolerance) << "index " << i;
+      EXPECT_NEAR(expected[i].y, actual[i].y, tolerance) << "index " << i;
+      EXPECT_NEAR(expected[i].z, actual[i].z, tolerance) << "index " << i;
+    }
+  }
+}
+
+// Data handler implementing only the functions every handler had to implement before the generic generators
+class MinimalVisionaryData : public VisionaryData
+{
+public:
+  void generatePointCloud(std::vector<PointXYZ>& pointCloud) override
+  {
+    pointCloud.assign(3u, PointXYZ{1.f, 2.f, 3.f});
+  }
+  using VisionaryData::generatePointCloud;
+
+  bool parseXML(const std::string&, std::uint32_t) override
+  {
+    return true;
+  }
+
+  bool parseBinaryData(std::vector<uint8_t>::iterator, std::size_t) override
+  {
+    return true;
+  }
+};
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(ThreadPoolTest, ProcessesEachIndexOnce)
+{
+  for (std::size_t numThreads = 1u; numThreads <= 8u; ++numThreads)
+  {
+    ThreadPool pool(numThreads);
+    EXPECT_EQ(numThreads, pool.getConcurrency());
+
+    for (std::size_t count : {0u, 1u, 3u, 1000u})
+    {
+      std::vector<std::atomic<int>> hits(count);
+      for (auto& hit : hits)
+      {
+        hit = 0;
+      }
+      pool.parallelFor(count, [&hits](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          ++hits[i];
+        }
+      });
+      for (const auto& hit : hits)
+      {
+        EXPECT_EQ(1, hit);
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(ThreadPoolTest, RethrowsExceptionOfRange)
+{
+  ThreadPool pool(4u);
+
+  // throw in the range of a worker thread and of the calling thread
+  for (std::size_t throwingIndex : {0u, 99u})
+  {
+    std::atomic<std::size_t> numProcessed(0u);
+    EXPECT_THROW(pool.parallelFor(100u,
+                                  [&](std::size_t begin, std::size_t end) {
+                                    numProcessed += end - begin;
+                                    if (begin <= throwingIndex && throwingIndex < end)
+                                    {
+                                      throw std::runtime_error("range failed");
+                                    }
+                                  }),
+                 std::runtime_error);
+    // the other ranges are finished before the exception reaches the caller
+    EXPECT_EQ(100u, numProcessed.load());
+  }
+
+  // the pool is still usable
+  std::atomic<std::size_t> numProcessed(0u);
+  pool.parallelFor(100u, [&](std::size_t begin, std::size_t end) { numProcessed += end - begin; });
+  EXPECT_EQ(100u, numProcessed.load());
+}
+
+//---------------------------------------------------------------------------------------
+TEST(ThreadPoolTest, NestedParallelForRunsInline)
+{
+  ThreadPool pool(4u);
+
+  // every range of the outer loop runs a nested loop on the same pool, on the worker threads and the calling thread
+  std::atomic<std::size_t> numProcessed(0u);
+  pool.parallelFor(8u, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      pool.parallelFor(100u, [&](std::size_t nestedBegin, std::size_t nestedEnd) {
+        numProcessed += nestedEnd - nestedBegin;
+      });
+    }
+  });
+  EXPECT_EQ(800u, numProcessed.load());
+
+  // a throwing nested range still leaves the pool usable
+  EXPECT_THROW(pool.parallelFor(4u,
+                                [&](std::size_t, std::size_t) {
+                                  pool.parallelFor(2u, [](std::size_t, std::size_t) {
+                                    throw std::runtime_error("nested range failed");
+                                  });
+                                }),
+               std::runtime_error);
+  numProcessed = 0u;
+  pool.parallelFor(100u, [&](std::size_t begin, std::size_t end) { numProcessed += end - begin; });
+  EXPECT_EQ(100u, numProcessed.load());
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, ParallelPointCloudMatchesSequential)
+{
+  for (bool isPlanar : {false, true})
+  {
+    visionary_test::MockVisionaryData data(64, 48, isPlanar);
+
+    std::vector<PointXYZ> expected;
+    data.generatePointCloud(expected);
+    ASSERT_EQ(64u * 48u, expected.size());
+    EXPECT_TRUE(std::isnan(expected[3].z));
+    EXPECT_FALSE(std::isnan(expected[4].z));
+
+    for (std::size_t numThreads = 1u; numThreads <= 8u; ++numThreads)
+    {
+      ThreadPool            pool(numThreads);
+      std::vector<PointXYZ> pointCloud;
+      data.generatePointCloud(pointCloud, pool);
+      expectSamePoints(expected, pointCloud);
+    }
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, ParallelTransformMatchesSequential)
+{
+  visionary_test::MockVisionaryData data(64, 48);
+
+  std::vector<PointXYZ> expected;
+  data.generatePointCloud(expected);
+  data.transformPointCloud(expected);
+
+  ThreadPool            pool(4u);
+  std::vector<PointXYZ> pointCloud;
+  data.generatePointCloud(pointCloud, pool);
+  data.transformPointCloud(pointCloud, pool);
+  expectSamePoints(expected, pointCloud);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, WorldPointCloudMatchesTransformedPointCloud)
+{
+  for (bool isPlanar : {false, true})
+  {
+    visionary_test::MockVisionaryData data(64, 48, isPlanar);
+
+    std::vector<PointXYZ> expected;
+    data.generatePointCloud(expected);
+    data.transformPointCloud(expected);
+
+    std::vector<PointXYZ> worldPointCloud;
+    data.generateWorldPointCloud(worldPointCloud);
+    expectNearPoints(expected, worldPointCloud, 1e-5f);
+
+    ThreadPool            pool(3u);
+    std::vector<PointXYZ> parallelPointCloud;
+    data.generateWorldPointCloud(parallelPointCloud, pool);
+    expectSamePoints(worldPointCloud, parallelPointCloud);
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, PointCloudSoAMatchesPointCloud)
+{
+  visionary_test::MockVisionaryData data(64, 48);
+
+  std::vector<PointXYZ> expected;
+  data.generatePointCloud(expected);
+
+  PointCloudSoA pointCloud;
+  data.generatePointCloudSoA(pointCloud);
+  ASSERT_EQ(expected.size(), pointCloud.size());
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(pointCloud.x.data()) % 64u);
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(pointCloud.y.data()) % 64u);
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(pointCloud.z.data()) % 64u);
+
+  std::vector<PointXYZ> interleaved(pointCloud.size());
+  for (std::size_t i = 0u; i < pointCloud.size(); ++i)
+  {
+    interleaved[i] = PointXYZ{pointCloud.x[i], pointCloud.y[i], pointCloud.z[i]};
+  }
+  expectSamePoints(expected, interleaved);
+
+  ThreadPool    pool(4u);
+  PointCloudSoA parallelPointCloud;
+  data.generatePointCloudSoA(parallelPointCloud, pool);
+  ASSERT_EQ(pointCloud.size(), parallelPointCloud.size());
+  EXPECT_EQ(0, std::memcmp(pointCloud.z.data(), parallelPointCloud.z.data(), pointCloud.size() * sizeof(float)));
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, CompactPointCloudContainsValidPoints)
+{
+  // width * height is no multiple of the mask word size
+  visionary_test::MockVisionaryData data(37, 11);
+
+  std::vector<PointXYZ> expected;
+  data.generatePointCloud(expected);
+
+  CompactPointCloud pointCloud;
+  data.generateCompactPointCloud(pointCloud);
+  ASSERT_EQ(pointCloud.size(), pointCloud.pixelIndices.size());
+  ASSERT_EQ((expected.size() + 63u) / 64u, pointCloud.validMask.size());
+
+  std::size_t numValid = 0u;
+  for (std::size_t i = 0u; i < expected.size(); ++i)
+  {
+    const bool isValid = !std::isnan(expected[i].z);
+    ASSERT_EQ(isValid, pointCloud.isValid(i)) << "index " << i;
+    if (isValid)
+    {
+      const std::size_t pointIndex = pointCloud.getPointIndex(i);
+      ASSERT_EQ(numValid, pointIndex);
+      EXPECT_EQ(i, pointCloud.pixelIndices[pointIndex]);
+      EXPECT_EQ(0, std::memcmp(&expected[i], &pointCloud.points[pointIndex], sizeof(PointXYZ)));
+      ++numValid;
+    }
+  }
+  EXPECT_EQ(numValid, pointCloud.size());
+
+  ThreadPool        pool(5u);
+  CompactPointCloud parallelPointCloud;
+  data.generateCompactPointCloud(parallelPointCloud, pool);
+  EXPECT_EQ(pointCloud.pixelIndices, parallelPointCloud.pixelIndices);
+  EXPECT_EQ(pointCloud.validMask, parallelPointCloud.validMask);
+  expectSamePoints(pointCloud.points, parallelPointCloud.points);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, QuantizedPointCloudMatchesPointCloud)
+{
+  visionary_test::MockVisionaryData data(64, 48);
+  const float                       scale = 0.00025f;
+
+  std::vector<PointXYZ> expected;
+  data.generatePointCloud(expected);
+  data.transformPointCloud(expected);
+
+  std::vector<QuantizedPointXYZ16> pointCloud16;
+  data.generateQuantizedPointCloud(pointCloud16, scale);
+  data.transformQuantizedPointCloud(pointCloud16, scale);
+  std::vector<QuantizedPointXYZ32> pointCloud32;
+  data.generateQuantizedPointCloud(pointCloud32, scale);
+  data.transformQuantizedPointCloud(pointCloud32, scale);
+  ASSERT_EQ(expected.size(), pointCloud16.size());
+  ASSERT_EQ(expected.size(), pointCloud32.size());
+
+  for (std::size_t i = 0u; i < expected.size(); ++i)
+  {
+    EXPECT_EQ(!std::isnan(expected[i].z), pointCloud32[i].isValid());
+    if (pointCloud32[i].isValid())
+    {
+      // two roundings, each up to half a unit
+      EXPECT_NEAR(expected[i].x, static_cast<float>(pointCloud32[i].x) * scale, scale);
+      EXPECT_NEAR(expected[i].y, static_cast<float>(pointCloud32[i].y) * scale, scale);
+      EXPECT_NEAR(expected[i].z, static_cast<float>(pointCloud32[i].z) * scale, scale);
+
+      // 16 bit covers 8 m at this scale, larger values are clamped
+      EXPECT_TRUE(pointCloud16[i].isValid());
+      EXPECT_EQ(std::max(-32767, std::min(32767, pointCloud32[i].z)), pointCloud16[i].z);
+    }
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, RegionOfInterestCropsPointCloud)
+{
+  const int                         fullWidth = 64;
+  visionary_test::MockVisionaryData data(fullWidth, 48);
+
+  std::vector<PointXYZ> fullPointCloud;
+  data.generatePointCloud(fullPointCloud);
+  EXPECT_EQ(fullWidth, data.getWidth());
+
+  // the region is clipped at the right border
+  data.setRegionOfInterest(RegionOfInterest{50, 10, 20, 8});
+  EXPECT_EQ(fullWidth, data.getWidth()); // takes effect with the next frame
+  data.receiveFrame();
+  ASSERT_EQ(14, data.getWidth());
+  ASSERT_EQ(8, data.getHeight());
+
+  std::vector<PointXYZ> pointCloud;
+  data.generatePointCloud(pointCloud);
+  ASSERT_EQ(14u * 8u, pointCloud.size());
+  for (std::size_t row = 0u; row < 8u; ++row)
+  {
+    EXPECT_EQ(0,
+              std::memcmp(&fullPointCloud[(row + 10u) * fullWidth + 50u],
+                          &pointCloud[row * 14u],
+                          14u * sizeof(PointXYZ)));
+  }
+
+  ThreadPool            pool(3u);
+  std::vector<PointXYZ> worldPointCloud;
+  data.generateWorldPointCloud(worldPointCloud, pool);
+  EXPECT_EQ(pointCloud.size(), worldPointCloud.size());
+
+  // back to the full image
+  data.setRegionOfInterest(RegionOfInterest{0, 0, 0, 0});
+  data.receiveFrame();
+  data.generatePointCloud(pointCloud);
+  expectSamePoints(fullPointCloud, pointCloud);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, ValidityPolicyInvalidatesPoints)
+{
+  visionary_test::MockVisionaryData data(64, 48);
+
+  std::vector<PointXYZ> unfiltered;
+  data.generatePointCloud(unfiltered);
+
+  std::vector<std::uint16_t>& confidence = data.confidenceMap();
+  confidence.resize(data.distanceMap().size());
+  for (std::size_t i = 0u; i < confidence.size(); ++i)
+  {
+    confidence[i] = static_cast<std::uint16_t>((i * 13u) % 100u);
+  }
+
+  // 1 m .. 4 m at a scale of 0.25 mm
+  PointCloudValidityPolicy policy = data.getPointCloudValidityPolicy();
+  policy.minDistance              = 1.0f;
+  policy.maxDistance              = 4.0f;
+  policy.minConfidence            = 50u;
+  data.setPointCloudValidityPolicy(policy);
+
+  std::vector<PointXYZ> pointCloud;
+  data.generatePointCloud(pointCloud);
+  ASSERT_EQ(unfiltered.size(), pointCloud.size());
+
+  std::size_t numValid = 0u;
+  for (std::size_t i = 0u; i < pointCloud.size(); ++i)
+  {
+    const std::uint16_t distance = data.distanceMap()[i];
+    const bool          expectValid =
+      !std::isnan(unfiltered[i].z) && distance >= 4000u && distance <= 16000u && confidence[i] >= 50u;
+    ASSERT_EQ(expectValid, !std::isnan(pointCloud[i].z)) << "index " << i;
+    if (expectValid)
+    {
+      EXPECT_EQ(0, std::memcmp(&unfiltered[i], &pointCloud[i], sizeof(PointXYZ)));
+      ++numValid;
+    }
+  }
+  EXPECT_GT(numValid, 0u);
+
+  // all generators apply the same policy
+  ThreadPool            pool(3u);
+  std::vector<PointXYZ> parallelPointCloud;
+  data.generatePointCloud(parallelPointCloud, pool);
+  expectSamePoints(pointCloud, parallelPointCloud);
+
+  PointCloudSoA soaPointCloud;
+  data.generatePointCloudSoA(soaPointCloud);
+  CompactPointCloud compactPointCloud;
+  data.generateCompactPointCloud(compactPointCloud);
+  std::vector<QuantizedPointXYZ32> quantizedPointCloud;
+  data.generateQuantizedPointCloud(quantizedPointCloud, 0.001f);
+  std::vector<PointXYZ> worldPointCloud;
+  data.generateWorldPointCloud(worldPointCloud);
+  EXPECT_EQ(numValid, compactPointCloud.size());
+  for (std::size_t i = 0u; i < pointCloud.size(); ++i)
+  {
+    const bool isValid = !std::isnan(pointCloud[i].z);
+    EXPECT_EQ(isValid, !std::isnan(soaPointCloud.z[i]));
+    EXPECT_EQ(isValid, compactPointCloud.isValid(i));
+    EXPECT_EQ(isValid, quantizedPointCloud[i].isValid());
+    EXPECT_EQ(isValid, !std::isnan(worldPointCloud[i].z));
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, CallerBuffersMatchVectors)
+{
+  visionary_test::MockVisionaryData data(64, 48);
+  ThreadPool                        pool(3u);
+
+  std::vector<PointXYZ> pointCloud;
+  data.generatePointCloud(pointCloud);
+  std::vector<PointXYZ> buffer(pointCloud.size() + 5u);
+  EXPECT_EQ(pointCloud.size(), data.generatePointCloudInto(buffer.data(), buffer.size()));
+  EXPECT_EQ(0, std::memcmp(pointCloud.data(), buffer.data(), pointCloud.size() * sizeof(PointXYZ)));
+  std::fill(buffer.begin(), buffer.end(), PointXYZ{});
+  EXPECT_EQ(pointCloud.size(), data.generatePointCloudInto(buffer.data(), pointCloud.size(), pool));
+  EXPECT_EQ(0, std::memcmp(pointCloud.data(), buffer.data(), pointCloud.size() * sizeof(PointXYZ)));
+
+  data.generateWorldPointCloud(pointCloud);
+  EXPECT_EQ(pointCloud.size(), data.generateWorldPointCloudInto(buffer.data(), buffer.size()));
+  EXPECT_EQ(0, std::memcmp(pointCloud.data(), buffer.data(), pointCloud.size() * sizeof(PointXYZ)));
+  std::fill(buffer.begin(), buffer.end(), PointXYZ{});
+  EXPECT_EQ(pointCloud.size(), data.generateWorldPointCloudInto(buffer.data(), buffer.size(), pool));
+  EXPECT_EQ(0, std::memcmp(pointCloud.data(), buffer.data(), pointCloud.size() * sizeof(PointXYZ)));
+
+  // buffers which are too small are not written
+  EXPECT_EQ(0u, data.generatePointCloudInto(buffer.data(), pointCloud.size() - 1u));
+  EXPECT_EQ(0u, data.generateWorldPointCloudInto(buffer.data(), pointCloud.size() - 1u, pool));
+
+  std::vector<std::uint16_t> mapCopy(data.distanceMap().size());
+  EXPECT_EQ(mapCopy.size(), copyMap(data.distanceMap(), mapCopy.data(), mapCopy.size()));
+  EXPECT_EQ(data.distanceMap(), mapCopy);
+  EXPECT_EQ(0u, copyMap(data.distanceMap(), mapCopy.data(), mapCopy.size() - 1u));
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, LayoutPointCloudMatchesPointCloud)
+{
+  visionary_test::MockVisionaryData data(64, 48);
+  data.confidenceMap().resize(data.distanceMap().size());
+  for (std::size_t i = 0u; i < data.confidenceMap().size(); ++i)
+  {
+    data.confidenceMap()[i] = static_cast<std::uint16_t>(i);
+  }
+
+  // padded 16 byte points: xyz, confidence clamped to uint8, a padding byte and the pixel index as uint16
+  PointLayout layout{{{FIELD_X, FIELD_FLOAT32, 0u},
+                      {FIELD_Y, FIELD_FLOAT32, 4u},
+                      {FIELD_Z, FIELD_FLOAT32, 8u},
+                      {FIELD_CONFIDENCE, FIELD_UINT8, 12u},
+                      {FIELD_PIXEL_INDEX, FIELD_UINT16, 14u}},
+                     16u};
+  ThreadPool pool(3u);
+  for (bool worldCoordinates : {false, true})
+  {
+    std::vector<PointXYZ> pointCloud;
+    if (worldCoordinates)
+    {
+      data.generateWorldPointCloud(pointCloud);
+    }
+    else
+    {
+      data.generatePointCloud(pointCloud);
+    }
+
+    std::vector<std::uint8_t> buffer(pointCloud.size() * 16u, 0xABu);
+    EXPECT_EQ(pointCloud.size(),
+              data.generateLayoutPointCloud(layout, buffer.data(), pointCloud.size(), worldCoordinates));
+    std::vector<std::uint8_t> parallelBuffer(buffer.size(), 0xABu);
+    EXPECT_EQ(pointCloud.size(),
+              data.generateLayoutPointCloud(layout, parallelBuffer.data(), pointCloud.size(), pool, worldCoordinates));
+    EXPECT_EQ(buffer, parallelBuffer);
+
+    for (std::size_t i = 0u; i < pointCloud.size(); ++i)
+    {
+      const std::uint8_t* pPoint = buffer.data() + 16u * i;
+      EXPECT_EQ(0, std::memcmp(&pointCloud[i], pPoint, sizeof(PointXYZ))) << "index " << i;
+      EXPECT_EQ(std::min<std::size_t>(i, 255u), pPoint[12]) << "index " << i;
+      EXPECT_EQ(0xABu, pPoint[13]) << "index " << i; // padding is not written
+      std::uint16_t pixelIndex = 0u;
+      std::memcpy(&pixelIndex, pPoint + 14, sizeof(pixelIndex));
+      EXPECT_EQ(i, pixelIndex);
+    }
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, CustomPointCloudMatchesPointCloud)
+{
+  struct PointXYZI
+  {
+    float         x;
+    float         y;
+    float         z;
+    std::uint32_t index;
+  };
+
+  visionary_test::MockVisionaryData data(64, 48);
+  std::vector<PointXYZ>             pointCloud;
+  data.generateWorldPointCloud(pointCloud);
+
+  const auto setPoint = [](PointXYZI& out, const PointXYZ& point, std::size_t pixelIndex) {
+    out = PointXYZI{point.x, point.y, point.z, static_cast<std::uint32_t>(pixelIndex)};
+  };
+  ThreadPool             pool(3u);
+  std::vector<PointXYZI> customPointCloud(pointCloud.size());
+  EXPECT_EQ(pointCloud.size(),
+            data.generateCustomPointCloud(customPointCloud.data(), customPointCloud.size(), setPoint, pool, true));
+  for (std::size_t i = 0u; i < pointCloud.size(); ++i)
+  {
+    EXPECT_EQ(0, std::memcmp(&pointCloud[i], &customPointCloud[i], sizeof(PointXYZ))) << "index " << i;
+    EXPECT_EQ(i, customPointCloud[i].index);
+  }
+  EXPECT_EQ(0u, data.generateCustomPointCloud(customPointCloud.data(), pointCloud.size() - 1u, setPoint));
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryDataTest, DefaultHooksOfOtherDataHandlers)
+{
+  MinimalVisionaryData data;
+  ThreadPool           pool(3u);
+
+  // the parallel overload falls back to the sequential point cloud of the handler
+  std::vector<PointXYZ> pointCloud;
+  data.generatePointCloud(pointCloud, pool);
+  ASSERT_EQ(3u, pointCloud.size());
+  EXPECT_FLOAT_EQ(3.f, pointCloud[2].z);
+
+  // the generic generators have no map to work on
+  PointXYZ points[4];
+  EXPECT_EQ(0u, data.generatePointCloudInto(points, 4u));
+  PointCloudSoA soaPointCloud;
+  data.generatePointCloudSoA(soaPointCloud, pool);
+  EXPECT_EQ(0u, soaPointCloud.size());
+  EXPECT_TRUE(data.getPointCloudSourceMap().empty());
+}
@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "VisionarySData.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+const int kWidth  = 8;
+const int kHeight = 4;
+
+const std::string kXMLStr =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?><SickRecord><DataSets><DataSetStereo><FormatDescriptionDepthMap>"
+  "<DataStream><Width>8</Width><Height>4</Height><CameraToWorldTransform><value>1</value><value>0</value>"
+  "<value>0</value><value>0</value><value>0</value><value>1</value><value>0</value><value>0</value><value>0</value>"
+  "<value>0</value><value>1</value><value>0</value><value>0</value><value>0</value><value>0</value><value>1</value>"
+  "</CameraToWorldTransform><CameraMatrix><FX>6</FX><FY>6</FY><CX>3.5</CX><CY>1.5</CY></CameraMatrix>"
+  "<CameraDistortionParams><K1>0</K1><K2>0</K2><P1>0</P1><P2>0</P2><K3>0</K3></CameraDistortionParams>"
+  "<FocalToRayCross>0</FocalToRayCross><Z decimalexponent=\"0\">uint16</Z><Intensity>uint32</Intensity>"
+  "<Confidence>uint16</Confidence></DataStream></FormatDescriptionDepthMap></DataSetStereo></DataSets></SickRecord>";
+
+// Visionary-S data handler with access to the parser
+class TestVisionarySData : public VisionarySData
+{
+public:
+  using VisionarySData::parseBinaryData;
+  using VisionarySData::parseXML;
+};
+
+void appendLittleEndian(std::vector<std::uint8_t>& buffer, std::uint64_t value, std::size_t numBytes)
+{
+  for (std::size_t i = 0u; i < numBytes; ++i)
+  {
+    buffer.push_back(static_cast<std::uint8_t>(value >> (8u * i)));
+  }
+}
+
+// binary segment with a z ramp containing invalid pixels and distinct colors
+std::vector<std::uint8_t> createBinaryData()
+{
+  const std::size_t         numPixels = static_cast<std::size_t>(kWidth * kHeight);
+  std::vector<std::uint8_t> buffer;
+  appendLittleEndian(buffer, 0u, 4u); // length, set below
+  appendLittleEndian(buffer, 0u, 8u); // timestamp
+  appendLittleEndian(buffer, 1u, 2u); // version
+  for (std::size_t i = 0u; i < numPixels; ++i)
+  {
+    appendLittleEndian(buffer, (i % 5u == 1u) ? 0u : 500u + 10u * i, 2u);
+  }
+  for (std::size_t i = 0u; i < numPixels; ++i)
+  {
+    const std::uint8_t rgba[4] = {static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(2u * i), 7u, 255u};
+    buffer.insert(buffer.end(), rgba, rgba + 4);
+  }
+  for (std::size_t i = 0u; i < numPixels; ++i)
+  {
+    appendLittleEndian(buffer, 100u, 2u);
+  }
+  appendLittleEndian(buffer, 0u, 4u); // CRC
+  const auto length = static_cast<std::uint32_t>(buffer.size());
+  appendLittleEndian(buffer, length, 4u);
+  std::copy(buffer.end() - 4, buffer.end(), buffer.begin());
+  return buffer;
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(VisionarySDataTest, ColoredPointCloudMatchesPointCloudAndColors)
+{
+  TestVisionarySData data;
+  ASSERT_TRUE(data.parseXML(kXMLStr, 1u));
+  std::vector<std::uint8_t> binaryData = createBinaryData();
+  ASSERT_TRUE(data.parseBinaryData(binaryData.begin(), binaryData.size()));
+
+  std::vector<PointXYZ> pointCloud;
+  data.generatePointCloud(pointCloud);
+  const std::vector<std::uint32_t>& rgbaMap = data.getRGBAMap();
+  ASSERT_EQ(pointCloud.size(), rgbaMap.size());
+
+  AlignedVector<PointXYZRGB> coloredPointCloud;
+  data.generateColoredPointCloud(coloredPointCloud);
+  ASSERT_EQ(pointCloud.size(), coloredPointCloud.size());
+  for (std::size_t i = 0u; i < pointCloud.size(); ++i)
+  {
+    EXPECT_EQ(0, std::memcmp(&pointCloud[i], &coloredPointCloud[i], sizeof(PointXYZ))) << "index " << i;
+    EXPECT_EQ(0, std::memcmp(&rgbaMap[i], &coloredPointCloud[i].r, 4u)) << "index " << i;
+  }
+  EXPECT_EQ(static_cast<std::uint8_t>(3u), coloredPointCloud[3].r);
+  EXPECT_EQ(static_cast<std::uint8_t>(6u), coloredPointCloud[3].g);
+  EXPECT_EQ(static_cast<std::uint8_t>(7u), coloredPointCloud[3].b);
+
+  // compacted: the valid points in image order
+  AlignedVector<PointXYZRGB> compactPointCloud;
+  data.generateColoredPointCloud(compactPointCloud, true);
+  std::size_t numValid = 0u;
+  for (std::size_t i = 0u; i < pointCloud.size(); ++i)
+  {
+    if (!std::isnan(pointCloud[i].z))
+    {
+      ASSERT_LT(numValid, compactPointCloud.size());
+      EXPECT_EQ(0, std::memcmp(&coloredPointCloud[i], &compactPointCloud[numValid], sizeof(PointXYZRGB)));
+      ++numValid;
+    }
+  }
+  EXPECT_EQ(numValid, compactPointCloud.size());
+  EXPECT_LT(numValid, pointCloud.size());
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionarySDataTest, LayoutPointCloudWithColors)
+{
+  TestVisionarySData data;
+  ASSERT_TRUE(data.parseXML(kXMLStr, 1u));
+  std::vector<std::uint8_t> binaryData = createBinaryData();
+  ASSERT_TRUE(data.parseBinaryData(binaryData.begin(), binaryData.size()));
+
+  std::vector<PointXYZ> pointCloud;
+  data.generatePointCloud(pointCloud);
+
+  // z and the color of the RGBA map
+  const PointLayout                 layout{{{FIELD_Z, FIELD_FLOAT32, 0u}, {FIELD_RGBA, FIELD_UINT32, 4u}}, 8u};
+  std::vector<std::uint32_t>        buffer(2u * pointCloud.size());
+  const std::vector<std::uint32_t>& rgbaMap = data.getRGBAMap();
+  ASSERT_EQ(pointCloud.size(), data.generateLayoutPointCloud(layout, buffer.data(), pointCloud.size()));
+  for (std::size_t i = 0u; i < pointCloud.size(); ++i)
+  {
+    EXPECT_EQ(0, std::memcmp(&pointCloud[i].z, &buffer[2u * i], sizeof(float))) << "index " << i;
+    EXPECT_EQ(rgbaMap[i], buffer[2u * i + 1u]) << "index " << i;
+  }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionarySDataTest, RegionOfInterestOfParsedFrame)
+{
+  std::vector<std::uint8_t> binaryData = createBinaryData();
+  TestVisionarySData        fullData;
+  ASSERT_TRUE(fullData.parseXML(kXMLStr, 1u));
+  ASSERT_TRUE(fullData.parseBinaryData(binaryData.begin(), binaryData.size()));
+  std::vector<PointXYZ> fullPointCloud;
+  fullData.generatePointCloud(fullPointCloud);
+
+  // the size of the region is known from the metadata, before the first frame
+  TestVisionarySData data;
+  data.setRegionOfInterest(RegionOfInterest{2, 1, 5, 2});
+  ASSERT_TRUE(data.parseXML(kXMLStr, 1u));
+  EXPECT_EQ(5, data.getWidth());
+  EXPECT_EQ(2, data.getHeight());
+  data.setRegionOfInterest(RegionOfInterest{2, 1, 0, 2});
+  EXPECT_EQ(kWidth - 2, data.getWidth());
+  EXPECT_EQ(2, data.getHeight());
+
+  ASSERT_TRUE(data.parseBinaryData(binaryData.begin(), binaryData.size()));
+  const int width = kWidth - 2;
+  ASSERT_EQ(static_cast<std::size_t>(width * 2), data.getZMap().size());
+  std::vector<PointXYZ> pointCloud;
+  data.generatePointCloud(pointCloud);
+  ASSERT_EQ(data.getZMap().size(), pointCloud.size());
+  for (int row = 0; row < 2; ++row)
+  {
+    for (int col = 0; col < width; ++col)
+    {
+      const auto fullIndex = static_cast<std::size_t>((row + 1) * kWidth + col + 2);
+      const auto index     = static_cast<std::size_t>(row * width + col);
+      EXPECT_EQ(fullData.getZMap()[fullIndex], data.getZMap()[index]) << "index " << index;
+      EXPECT_EQ(0, std::memcmp(&fullPointCloud[fullIndex], &pointCloud[index], sizeof(PointXYZ))) << "index " << index;
+    }
+  }
+
+  // the maps of the received frame keep their region until the next frame
+  data.setRegionOfInterest(RegionOfInterest{0, 0, 0, 0});
+  EXPECT_EQ(width, data.getWidth());
+  ASSERT_TRUE(data.parseBinaryData(binaryData.begin(), binaryData.size()));
+  EXPECT_EQ(kWidth, data.getWidth());
+  EXPECT_EQ(kHeight, data.getHeight());
+  EXPECT_EQ(fullData.getZMap(), data.getZMap());
+}
+
+//---------------------------------------------------------------------------------------
+TEST(VisionarySDataTest, RejectedFrameKeepsMapsAndLookUpTableConsistent)
+{
+  std::vector<std::uint8_t> binaryData = createBinaryData();
+  TestVisionarySData        data;
+  ASSERT_TRUE(data.parseXML(kXMLStr, 1u));
+  ASSERT_TRUE(data.parseBinaryData(binaryData.begin(), binaryData.size()));
+  std::vector<PointXYZ> fullPointCloud;
+  data.generatePointCloud(fullPointCloud);
+
+  // a truncated frame is rejected before the new region of interest is applied
+  data.setRegionOfInterest(RegionOfInterest{2, 1, 4, 2});
+  std::vector<std::uint8_t> truncatedData(binaryData.begin(), binaryData.begin() + 40);
+  EXPECT_FALSE(data.parseBinaryData(truncatedData.begin(), truncatedData.size()));
+  EXPECT_EQ(kWidth, data.getWidth());
+  std::vector<PointXYZ> pointCloud;
+  data.generatePointCloud(pointCloud);
+  ASSERT_EQ(fullPointCloud.size(), pointCloud.size());
+  EXPECT_EQ(0, std::memcmp(fullPointCloud.data(), pointCloud.data(), pointCloud.size() * sizeof(PointXYZ)));
+
+  // metadata of another image size followed by a rejected frame: the maps don't fit the look-up-table anymore, so the
+  // generators give no points instead of reading past its end
+  std::string smallXMLStr = kXMLStr;
+  smallXMLStr.replace(smallXMLStr.find("<Width>8</Width>"), 16u, "<Width>6</Width>");
+  ASSERT_TRUE(data.parseXML(smallXMLStr, 2u));
+  EXPECT_FALSE(data.parseBinaryData(truncatedData.begin(), truncatedData.size()));
+  ASSERT_EQ(static_cast<std::size_t>(kWidth * kHeight), data.getZMap().size());
+
+  data.generatePointCloud(pointCloud);
+  EXPECT_TRUE(pointCloud.empty());
+  data.generateWorldPointCloud(pointCloud);
+  EXPECT_TRUE(pointCloud.empty());
+  std::vector<PointXYZ> buffer(data.getZMap().size());
+  EXPECT_EQ(0u, data.generatePointCloudInto(buffer.data(), buffer.size()));
+  AlignedVector<PointXYZRGB> coloredPointCloud;
+  data.generateColoredPointCloud(coloredPointCloud);
+  EXPECT_TRUE(coloredPointCloud.empty());
+  VisionaryData::PixelValidator validator{};
+  EXPECT_FALSE(data.prepareWorldPoints(validator));
+}
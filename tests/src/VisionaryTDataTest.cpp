@@ -0,0 +1,153 @@
+//
+// Copyright (c) 2023 SICK AG, Waldkirch
+//
+// SPDX-License-Identifier: Unlicense
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "VisionaryTData.h"
+#include "gtest/gtest.h"
+
+using namespace visionary;
+
+namespace {
+const std::size_t kNumPolarValues = 5u;
+
+// rotation by 90 degrees around z and a translation of 1000 mm along x
+const std::string kXMLStr =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?><SickRecord><DataSets><DataSetDepthMap><FormatDescriptionDepthMap>"
+  "<DataStream><Width>2</Width><Height>2</Height><CameraToWorldTransform><value>0</value><value>-1</value>"
+  "<value>0</value><value>1000</value><value>1</value><value>0</value><value>0</value><value>0</value>"
+  "<value>0</value><value>0</value><value>1</value><value>0</value><value>0</value><value>0</value><value>0</value>"
+  "<value>1</value></CameraToWorldTransform><CameraMatrix><FX>2</FX><FY>2</FY><CX>0.5</CX><CY>0.5</CY>"
+  "</CameraMatrix><FocalToRayCross>0</FocalToRayCross><Distance decimalexponent=\"0\">uint16</Distance>"
+  "<Intensity>uint16</Intensity><Confidence>uint16</Confidence></DataStream></FormatDescriptionDepthMap>"
+  "</DataSetDepthMap><DataSetPolar2D><FormatDescription><DataStream datalength=\"5\"/></FormatDescription>"
+  "</DataSetPolar2D></DataSets></SickRecord>";
+
+// Visionary-T data handler with access to the parser
+class TestVisionaryTData : public VisionaryTData
+{
+public:
+  using VisionaryTData::parseBinaryData;
+  using VisionaryTData::parseXML;
+};
+
+void appendLittleEndian(std::vector<std::uint8_t>& buffer, std::uint64_t value, std::size_t numBytes)
+{
+  for (std::size_t i = 0u; i < numBytes; ++i)
+  {
+    buffer.push_back(static_cast<std::uint8_t>(value >> (8u * i)));
+  }
+}
+
+void appendFloat(std::vector<std::uint8_t>& buffer, float value)
+{
+  std::uint32_t bits = 0u;
+  std::memcpy(&bits, &value, sizeof(bits));
+  appendLittleEndian(buffer, bits, 4u);
+}
+
+// Set the length at the start of the data set and append CRC and length copy
+void finishDataSet(std::vector<std::uint8_t>& buffer, std::size_t begin)
+{
+  appendLittleEndian(buffer, 0u, 4u); // CRC
+  const auto length = static_cast<std::uint32_t>(buffer.size() + 4u - begin);
+  appendLittleEndian(buffer, length, 4u);
+  for (std::size_t i = 0u; i < 4u; ++i)
+  {
+    buffer[begin + i] = static_cast<std::uint8_t>(length >> (8u * i));
+  }
+}
+
+// depth map data set followed by a polar scan in steps of 45 degrees
+std::vector<std::uint8_t> createBinaryData(float angleFirstScanPoint, const std::vector<float>& distances)
+{
+  std::vector<std::uint8_t> buffer;
+  appendLittleEndian(buffer, 0u, 4u); // length
+  appendLittleEndian(buffer, 0u, 8u); // timestamp
+  appendLittleEndian(buffer, 1u, 2u); // version
+  for (std::size_t i = 0u; i < 3u * 4u; ++i)
+  {
+    appendLittleEndian(buffer, 1000u, 2u); // distance, intensity and confidence
+  }
+  finishDataSet(buffer, 0u);
+
+  const std::size_t polarBegin = buffer.size();
+  appendLittleEndian(buffer, 0u, 4u);      // length
+  appendLittleEndian(buffer, 0u, 8u);      // timestamp
+  appendLittleEndian(buffer, 0u, 2u);      // device id
+  appendLittleEndian(buffer, 0u, 4u + 4u); // scan counter, system counter
+  appendFloat(buffer, 0.0f);               // scan frequency
+  appendFloat(buffer, 0.0f);               // measurement frequency
+  appendFloat(buffer, angleFirstScanPoint);
+  appendFloat(buffer, 45.0f); // angular resolution
+  appendFloat(buffer, 1.0f);  // scale
+  appendFloat(buffer, 0.0f);  // offset
+  for (float distance : distances)
+  {
+    appendFloat(buffer, distance);
+  }
+  for (std::size_t i = 0u; i < 4u; ++i)
+  {
+    appendFloat(buffer, 0.0f); // rssi angles, scale and offset
+  }
+  const float confidences[kNumPolarValues] = {100.0f, 100.0f, 10.0f, 100.0f, 100.0f};
+  for (float confidence : confidences)
+  {
+    appendFloat(buffer, confidence);
+  }
+  finishDataSet(buffer, polarBegin);
+  return buffer;
+}
+} // namespace
+
+//---------------------------------------------------------------------------------------
+TEST(VisionaryTDataTest, PolarPointCloud)
+{
+  TestVisionaryTData data;
+  ASSERT_TRUE(data.parseXML(kXMLStr, 1u));
+  const std::vector<float>  distances = {1000.0f, 2000.0f, 500.0f, 0.0f, 1500.0f};
+  std::vector<std::uint8_t> binaryData = createBinaryData(-90.0f, distances);
+  ASSERT_TRUE(data.parseBinaryData(binaryData.begin(), binaryData.size()));
+  ASSERT_EQ(kNumPolarValues, data.getPolarSize());
+
+  // angles -90, -45, 0, 45, 90 degrees in the x-z plane
+  std::vector<PointXYZ> pointCloud;
+  data.generatePolarPointCloud(pointCloud);
+  ASSERT_EQ(kNumPolarValues, pointCloud.size());
+  const float kSqrtHalf = std::sqrt(0.5f);
+  EXPECT_NEAR(-1.0f, pointCloud[0].x, 1e-6f);
+  EXPECT_NEAR(0.0f, pointCloud[0].z, 1e-6f);
+  EXPECT_NEAR(-2.0f * kSqrtHalf, pointCloud[1].x, 1e-6f);
+  EXPECT_NEAR(2.0f * kSqrtHalf, pointCloud[1].z, 1e-6f);
+  EXPECT_NEAR(0.0f, pointCloud[2].x, 1e-6f);
+  EXPECT_NEAR(0.5f, pointCloud[2].z, 1e-6f);
+  EXPECT_NEAR(0.0f, pointCloud[2].y, 1e-6f);
+  EXPECT_TRUE(std::isnan(pointCloud[3].x)); // zero distance
+  EXPECT_NEAR(1.5f, pointCloud[4].x, 1e-6f);
+
+  // confidence gating invalidates the point at 0 degrees
+  data.generatePolarPointCloud(pointCloud, 50.0f);
+  EXPECT_TRUE(std::isnan(pointCloud[2].z));
+  EXPECT_FALSE(std::isnan(pointCloud[1].z));
+
+  // world coordinates: (x, y, z) -> (1 - y, x, z)
+  std::vector<PointXYZ> worldPointCloud;
+  data.generateWorldPolarPointCloud(worldPointCloud);
+  ASSERT_EQ(kNumPolarValues, worldPointCloud.size());
+  EXPECT_NEAR(1.0f, worldPointCloud[0].x, 1e-6f);
+  EXPECT_NEAR(-1.0f, worldPointCloud[0].y, 1e-6f);
+  EXPECT_NEAR(2.0f * kSqrtHalf, worldPointCloud[1].z, 1e-6f);
+  EXPECT_TRUE(std::isnan(worldPointCloud[3].y));
+
+  // a changed start angle recalculates the tables
+  binaryData = createBinaryData(0.0f, distances);
+  ASSERT_TRUE(data.parseBinaryData(binaryData.begin(), binaryData.size()));
+  data.generatePolarPointCloud(pointCloud);
+  EXPECT_NEAR(0.0f, pointCloud[0].x, 1e-6f);
+  EXPECT_NEAR(1.0f, pointCloud[0].z, 1e-6f);
+}